@@ -0,0 +1,125 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Returns the resident memory of this process in bytes or 0 if it can't be determined.
+std::size_t resident_memory()
+{
+#ifdef __APPLE__
+    struct task_basic_info t_info;
+    mach_msg_type_number_t t_info_count = TASK_BASIC_INFO_COUNT;
+
+    if (KERN_SUCCESS != task_info(mach_task_self(), TASK_BASIC_INFO, (task_info_t)&t_info, &t_info_count))
+    {
+        return 0;
+    }
+
+    return t_info.resident_size;
+#elif defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    std::size_t total_pages = 0;
+    std::size_t resident_pages = 0;
+    statm >> total_pages >> resident_pages;
+
+    return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+// Fills a worksheet with rows x 20 cells using fill(cell, row, column)
+// and prints the growth of the resident memory divided by the number of cells.
+// The workbook is returned so that its memory isn't reused by the next measurement.
+template <typename Fill>
+xlnt::workbook measure_bytes_per_cell(const std::string &label, xlnt::row_t rows, Fill fill)
+{
+    const xlnt::column_t::index_t columns = 20;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    auto before = resident_memory();
+
+    for (xlnt::row_t row = 1; row <= rows; ++row)
+    {
+        for (xlnt::column_t::index_t column = 1; column <= columns; ++column)
+        {
+            auto cell = ws.cell(column, row);
+            fill(cell, row, column);
+        }
+    }
+
+    auto after = resident_memory();
+    auto cells = static_cast<double>(rows) * columns;
+
+    std::cout << label << ": " << static_cast<double>(after - before) / cells << " bytes per cell" << std::endl;
+
+    return wb;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    xlnt::row_t rows = 100000;
+
+    if (argc > 1)
+    {
+        rows = static_cast<xlnt::row_t>(std::stoul(argv[1]));
+    }
+
+    std::vector<xlnt::workbook> workbooks;
+
+    workbooks.push_back(measure_bytes_per_cell("empty", rows, [](xlnt::cell, xlnt::row_t, xlnt::column_t::index_t) {}));
+
+    workbooks.push_back(measure_bytes_per_cell("numeric", rows, [](xlnt::cell cell, xlnt::row_t row, xlnt::column_t::index_t column) {
+        cell.value(row * 1.5 + column);
+    }));
+
+    workbooks.push_back(measure_bytes_per_cell("shared string (20 distinct)", rows, [](xlnt::cell cell, xlnt::row_t, xlnt::column_t::index_t column) {
+        cell.value("text " + std::to_string(column));
+    }));
+
+    workbooks.push_back(measure_bytes_per_cell("formula", rows, [](xlnt::cell cell, xlnt::row_t row, xlnt::column_t::index_t) {
+        cell.formula("=A" + std::to_string(row) + "*2");
+    }));
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Writing a numeric cell of a worksheet formats its reference and its value, like <c r="B12"><v>1234.56</v></c>.
+// This compares formatting both into new strings, as cell_reference::to_string() and serialise(double) do,
+// with formatting them into one reused buffer, as xlsx_producer does.
+
+#include "benchmark/benchmark.h"
+#include <random>
+#include <string>
+#include <vector>
+#include <detail/serialization/serialisation_helpers.hpp>
+#include <xlnt/cell/cell_reference.hpp>
+
+namespace {
+
+class RandomCells : public benchmark::Fixture
+{
+    static constexpr size_t Number_of_Elements = 1 << 20;
+
+    std::vector<double> values;
+    std::vector<xlnt::cell_reference> references;
+
+    size_t index = 0;
+
+public:
+    void SetUp(::benchmark::State &state)
+    {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_real_distribution<double> value_dis(-1'000, 1'000);
+        std::uniform_int_distribution<xlnt::row_t> row_dis(1, 1'048'576);
+        std::uniform_int_distribution<xlnt::column_t::index_t> column_dis(1, 16'384);
+
+        values.reserve(Number_of_Elements);
+        references.reserve(Number_of_Elements);
+
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            values.push_back(value_dis(gen));
+            references.emplace_back(column_dis(gen), row_dis(gen));
+        }
+    }
+
+    void TearDown(const ::benchmark::State &state)
+    {
+        values = std::vector<double>{};
+        references = std::vector<xlnt::cell_reference>{};
+    }
+
+    size_t next()
+    {
+        return ++index & (Number_of_Elements - 1);
+    }
+
+    double value(size_t i) const
+    {
+        return values[i];
+    }
+
+    const xlnt::cell_reference &reference(size_t i) const
+    {
+        return references[i];
+    }
+};
+
+void append_cell(std::string &output, const std::string &reference, const std::string &value)
+{
+    output.append("<c r=\"");
+    output.append(reference);
+    output.append("\"><v>");
+    output.append(value);
+    output.append("</v></c>");
+}
+
+} // namespace
+
+BENCHMARK_F(RandomCells, cell_new_strings)
+(benchmark::State &state)
+{
+    std::string output;
+
+    while (state.KeepRunning())
+    {
+        output.clear();
+        const auto i = next();
+        append_cell(output, reference(i).to_string(), xlnt::detail::serialise(value(i)));
+        benchmark::DoNotOptimize(output);
+    }
+}
+
+BENCHMARK_F(RandomCells, cell_reused_buffer)
+(benchmark::State &state)
+{
+    std::string output;
+    std::string reference_buffer;
+    std::string value_buffer;
+
+    while (state.KeepRunning())
+    {
+        output.clear();
+        const auto i = next();
+        const auto &ref = reference(i);
+        xlnt::detail::serialise(xlnt::detail::Cell_Reference(ref.row(), ref.column_index()), reference_buffer);
+        xlnt::detail::serialise(value(i), value_buffer);
+        append_cell(output, reference_buffer, value_buffer);
+        benchmark::DoNotOptimize(output);
+    }
+}
+
+BENCHMARK_F(RandomCells, row_number_to_string)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(std::to_string(reference(next()).row()));
+    }
+}
+
+BENCHMARK_F(RandomCells, row_number_reused_buffer)
+(benchmark::State &state)
+{
+    std::string buffer;
+
+    while (state.KeepRunning())
+    {
+        xlnt::detail::serialise_integer(static_cast<unsigned long long>(reference(next()).row()), buffer);
+        benchmark::DoNotOptimize(buffer);
+    }
+}
@@ -0,0 +1,94 @@
+// Formats numbers with each of the builtin number formats, like cell::to_string() does.
+// This compares returning a new string for each number with formatting into one reused buffer.
+
+#include "benchmark/benchmark.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <detail/number_format/number_formatter.hpp>
+#include <xlnt/styles/number_format.hpp>
+
+namespace {
+
+class BuiltinFormats : public benchmark::Fixture
+{
+    static constexpr size_t Number_of_Elements = 1 << 16;
+
+    std::vector<double> values;
+    std::vector<std::unique_ptr<xlnt::detail::number_formatter>> formatters;
+
+    size_t index = 0;
+
+public:
+    void SetUp(::benchmark::State &state)
+    {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        // spans negative numbers, fractions and dates up to the year 2173
+        std::uniform_real_distribution<double> value_dis(-1'000, 100'000);
+
+        values.reserve(Number_of_Elements);
+
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            values.push_back(value_dis(gen));
+        }
+
+        // the builtin formats have ids up to 163, custom formats start at 164
+        for (std::size_t id = 0; id < 164; ++id)
+        {
+            if (xlnt::number_format::is_builtin_format(id))
+            {
+                formatters.emplace_back(new xlnt::detail::number_formatter(
+                    xlnt::number_format::from_builtin_id(id).format_string(), xlnt::calendar::windows_1900));
+            }
+        }
+    }
+
+    void TearDown(const ::benchmark::State &state)
+    {
+        values = std::vector<double>{};
+        formatters.clear();
+    }
+
+    size_t next()
+    {
+        return ++index & (Number_of_Elements - 1);
+    }
+
+    double value(size_t i) const
+    {
+        return values[i];
+    }
+
+    const xlnt::detail::number_formatter &formatter(size_t i) const
+    {
+        return *formatters[i % formatters.size()];
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(BuiltinFormats, format_number_new_string)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        const auto i = next();
+        benchmark::DoNotOptimize(formatter(i).format_number(value(i)));
+    }
+}
+
+BENCHMARK_F(BuiltinFormats, format_number_reused_buffer)
+(benchmark::State &state)
+{
+    std::string buffer;
+
+    while (state.KeepRunning())
+    {
+        const auto i = next();
+        formatter(i).format_number(value(i), buffer);
+        benchmark::DoNotOptimize(buffer);
+    }
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Returns the largest amount of memory the process has used so far in kilobytes.
+std::size_t peak_memory_kb()
+{
+#ifdef _MSC_VER
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<std::size_t>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss / 1024);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Streams a worksheet with a number, a string and a styled cell in every row.
+// The peak memory of the process must not grow with the number of rows,
+// so it stays flat while the row count doubles.
+void stream_rows(xlnt::row_t rows)
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    const auto start = clock::now();
+
+    xlnt::streaming_workbook_writer writer;
+    writer.open(std::string("benchmark-streaming.xlsx"));
+    writer.add_worksheet("data");
+
+    for (xlnt::row_t row = 1; row <= rows; ++row)
+    {
+        writer.add_cell(xlnt::cell_reference(1, row)).value(static_cast<double>(row) / 7);
+        writer.add_cell(xlnt::cell_reference(2, row)).value("row " + std::to_string(row));
+        writer.add_cell(xlnt::cell_reference(3, row)).number_format(xlnt::number_format::percentage());
+    }
+
+    writer.close();
+
+    std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+
+    std::cout << rows << " rows: " << elapsed.count() << " ms, peak memory "
+              << peak_memory_kb() << " kB" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    xlnt::row_t max_rows = 1000000;
+
+    if (argc > 1)
+    {
+        max_rows = static_cast<xlnt::row_t>(std::stoul(argv[1]));
+    }
+
+    for (xlnt::row_t rows = 62500; rows <= max_rows; rows *= 2)
+    {
+        stream_rows(rows);
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Styles every cell of a single column with its own font, fill and border,
+// so that each call creates a new format and new components.
+// Styling all cells a second time only finds existing formats.
+// If deduplication is O(1), the time per cell stays flat as the count doubles.
+void style_distinct_cells(int count)
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    auto style_all = [&ws, count]() {
+        for (int i = 1; i <= count; ++i)
+        {
+            auto cell = ws.cell(xlnt::cell_reference(1, static_cast<xlnt::row_t>(i)));
+            cell.font(xlnt::font().size(8. + i / 100.));
+            cell.fill(xlnt::fill::solid(xlnt::rgb_color(static_cast<std::uint8_t>(i % 256),
+                static_cast<std::uint8_t>((i / 256) % 256), 0)));
+            cell.border(xlnt::border().side(xlnt::border_side::bottom,
+                xlnt::border::border_property().style(xlnt::border_style::thin)));
+        }
+    };
+
+    auto start = clock::now();
+    style_all();
+    std::chrono::duration<double, std::micro> created = clock::now() - start;
+
+    start = clock::now();
+    style_all();
+    std::chrono::duration<double, std::micro> found = clock::now() - start;
+
+    std::cout << count << " distinct formats (" << wb.format_count() << " in workbook): "
+              << created.count() / count << " us per new format, "
+              << found.count() / count << " us per existing format" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int max_count = 64000;
+
+    if (argc > 1)
+    {
+        max_count = std::stoi(argv[1]);
+    }
+
+    for (int count = 1000; count <= max_count; count *= 2)
+    {
+        style_distinct_cells(count);
+    }
+
+    return 0;
+}
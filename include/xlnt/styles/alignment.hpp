@@ -27,6 +27,7 @@
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/utils/hash_combine.hpp>
 
 namespace xlnt {
 
@@ -167,3 +168,41 @@ private:
 };
 
 } // namespace xlnt
+
+namespace std {
+
+template<>
+struct hash<xlnt::alignment>
+{
+    size_t operator()(const xlnt::alignment& a) const
+    {
+        size_t seed = 0;
+
+        if (a.horizontal().is_set())
+        {
+            xlnt::detail::hash_combine(seed, static_cast<int>(a.horizontal().get()));
+        }
+
+        if (a.vertical().is_set())
+        {
+            xlnt::detail::hash_combine(seed, static_cast<int>(a.vertical().get()));
+        }
+
+        if (a.indent().is_set())
+        {
+            xlnt::detail::hash_combine(seed, a.indent().get());
+        }
+
+        if (a.rotation().is_set())
+        {
+            xlnt::detail::hash_combine(seed, a.rotation().get());
+        }
+
+        xlnt::detail::hash_combine(seed, a.shrink());
+        xlnt::detail::hash_combine(seed, a.wrap());
+
+        return seed;
+    }
+};
+
+} // namespace std
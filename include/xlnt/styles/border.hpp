@@ -30,6 +30,7 @@
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/styles/color.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/utils/hash_combine.hpp>
 
 namespace xlnt {
 
@@ -223,3 +224,41 @@ private:
 };
 
 } // namespace xlnt
+
+namespace std {
+
+template<>
+struct hash<xlnt::border>
+{
+    size_t operator()(const xlnt::border& b) const
+    {
+        size_t seed = 0;
+
+        // Only the sides take part in border equality, so only they are hashed
+        for (auto side : xlnt::border::all_sides())
+        {
+            const auto prop = b.side(side);
+
+            if (!prop.is_set())
+            {
+                continue;
+            }
+
+            xlnt::detail::hash_combine(seed, static_cast<int>(side));
+
+            if (prop.get().style().is_set())
+            {
+                xlnt::detail::hash_combine(seed, static_cast<int>(prop.get().style().get()));
+            }
+
+            if (prop.get().color().is_set())
+            {
+                xlnt::detail::hash_combine(seed, prop.get().color().get());
+            }
+        }
+
+        return seed;
+    }
+};
+
+} // namespace std
@@ -30,6 +30,7 @@
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/styles/color.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/utils/hash_combine.hpp>
 
 namespace xlnt {
 
@@ -370,3 +371,42 @@ private:
 };
 
 } // namespace xlnt
+
+namespace std {
+
+template<>
+struct hash<xlnt::fill>
+{
+    size_t operator()(const xlnt::fill& f) const
+    {
+        size_t seed = 0;
+        xlnt::detail::hash_combine(seed, static_cast<int>(f.type()));
+
+        if (f.type() == xlnt::fill_type::gradient)
+        {
+            // Gradient stops are unordered, so they are left to operator==
+            const auto gradient = f.gradient_fill();
+            xlnt::detail::hash_combine(seed, static_cast<int>(gradient.type()));
+            xlnt::detail::hash_combine(seed, gradient.degree());
+
+            return seed;
+        }
+
+        const auto pattern = f.pattern_fill();
+        xlnt::detail::hash_combine(seed, static_cast<int>(pattern.type()));
+
+        if (pattern.foreground().is_set())
+        {
+            xlnt::detail::hash_combine(seed, pattern.foreground().get());
+        }
+
+        if (pattern.background().is_set())
+        {
+            xlnt::detail::hash_combine(seed, pattern.background().get());
+        }
+
+        return seed;
+    }
+};
+
+} // namespace std
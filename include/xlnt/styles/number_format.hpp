@@ -29,6 +29,7 @@
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/utils/hash_combine.hpp>
 
 namespace xlnt {
 
@@ -290,3 +291,17 @@ private:
 };
 
 } // namespace xlnt
+
+namespace std {
+
+template<>
+struct hash<xlnt::number_format>
+{
+    size_t operator()(const xlnt::number_format& nf) const
+    {
+        // Number formats compare equal by their format string alone
+        return hash<std::string>()(nf.format_string());
+    }
+};
+
+} // namespace std
@@ -27,6 +27,7 @@
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/utils/hash_combine.hpp>
 
 namespace xlnt {
 
@@ -104,3 +105,20 @@ private:
 };
 
 } // namespace xlnt
+
+namespace std {
+
+template<>
+struct hash<xlnt::protection>
+{
+    size_t operator()(const xlnt::protection& p) const
+    {
+        size_t seed = 0;
+        xlnt::detail::hash_combine(seed, p.locked());
+        xlnt::detail::hash_combine(seed, p.hidden());
+
+        return seed;
+    }
+};
+
+} // namespace std
@@ -0,0 +1,90 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Receives the rows and cells of a worksheet as they are parsed by
+/// streaming_workbook_reader::read_cells(), without any cell objects being built.
+/// Every callback does nothing by default, so only the ones needed have to be overridden.
+/// Strings passed to the callbacks are only valid during the call.
+/// </summary>
+class XLNT_API sheet_visitor
+{
+public:
+    virtual ~sheet_visitor();
+
+    /// <summary>
+    /// Called at the start of each row which is stored in the worksheet, before its cells.
+    /// Rows without any cells are reported too.
+    /// </summary>
+    virtual void on_row_begin(row_t row);
+
+    /// <summary>
+    /// Called for a cell with a numeric value. Dates are stored as numbers, so they are
+    /// reported here as well, see number_format::is_date_format().
+    /// </summary>
+    virtual void on_number(row_t row, column_t::index_t column, double value);
+
+    /// <summary>
+    /// Called for a cell which refers to the shared string at the given index,
+    /// see workbook::shared_strings().
+    /// </summary>
+    virtual void on_shared_string(row_t row, column_t::index_t column, std::size_t index);
+
+    /// <summary>
+    /// Called for a cell with an inline string or with the string result of a formula.
+    /// </summary>
+    virtual void on_inline_string(row_t row, column_t::index_t column, const std::string &value);
+
+    /// <summary>
+    /// Called for a cell with a boolean value.
+    /// </summary>
+    virtual void on_boolean(row_t row, column_t::index_t column, bool value);
+
+    /// <summary>
+    /// Called for a cell with an error value like "#DIV/0!".
+    /// </summary>
+    virtual void on_error(row_t row, column_t::index_t column, const std::string &value);
+
+    /// <summary>
+    /// Called for a cell with a formula, before the cached result of the formula is
+    /// reported through one of the callbacks above. The formula has no leading '='.
+    /// </summary>
+    virtual void on_formula(row_t row, column_t::index_t column, const std::string &formula);
+
+    /// <summary>
+    /// Called at the end of each row, after all of its cells.
+    /// </summary>
+    virtual void on_row_end(row_t row);
+};
+
+} // namespace xlnt
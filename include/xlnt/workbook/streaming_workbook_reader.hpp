@@ -26,11 +26,14 @@
 
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/worksheet/delimited_text_options.hpp>
 
 namespace xml {
 class parser;
@@ -42,6 +45,7 @@ class cell;
 template <typename T>
 class optional;
 class path;
+class sheet_visitor;
 class workbook;
 class worksheet;
 
@@ -72,6 +76,26 @@ public:
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Returns the value of the cell last returned by read_cell() as it is written in the file,
+    /// e.g. a number before it's parsed or the index of a shared string. This avoids converting
+    /// values which aren't needed. The returned reference is only valid until the next call to has_cell().
+    /// </summary>
+    const std::string &read_cell_raw_value() const;
+
+    /// <summary>
+    /// Reads the remaining rows and cells of the current worksheet and passes them to the
+    /// callbacks of visitor, without creating a cell for each of them. This is the fastest
+    /// way to copy the values of a worksheet into other data structures.
+    /// </summary>
+    void read_cells(sheet_visitor &visitor);
+
+    /// <summary>
+    /// Writes the values of the remaining rows and cells of the current worksheet to stream
+    /// as delimited text like CSV, in the same way as worksheet::write_delimited().
+    /// </summary>
+    void write_delimited(std::ostream &stream, const delimited_text_options &options = delimited_text_options());
+
     bool has_worksheet(const std::string &name);
 
     /// <summary>
@@ -90,6 +114,60 @@ public:
     /// </summary>
     worksheet end_worksheet();
 
+    /// <summary>
+    /// If enabled, files opened by path are mapped into memory instead of being read
+    /// through a file stream. Their parts are then decompressed straight from the mapping.
+    /// Disabled by default.
+    /// </summary>
+    void memory_mapped_loading(bool enabled);
+
+    /// <summary>
+    /// Returns true if files opened by path are mapped into memory.
+    /// </summary>
+    bool memory_mapped_loading() const;
+
+    /// <summary>
+    /// If enabled, files opened after this call only find the entries of their shared
+    /// string table, which are decoded when the value of a cell refers to them.
+    /// See workbook::lazy_shared_strings(). Disabled by default.
+    /// </summary>
+    void lazy_shared_strings(bool enabled);
+
+    /// <summary>
+    /// Returns true if shared strings are decoded on first access.
+    /// </summary>
+    bool lazy_shared_strings() const;
+
+    /// <summary>
+    /// Restricts the cells of worksheets begun after this call to the given columns.
+    /// The other cells are skipped without their values being decoded.
+    /// An empty vector, the default, reads all columns.
+    /// </summary>
+    void load_columns(const std::vector<column_t> &columns);
+
+    /// <summary>
+    /// Returns the columns which are read, or an empty vector if all columns are read.
+    /// </summary>
+    const std::vector<column_t> &load_columns() const;
+
+    /// <summary>
+    /// Restricts the rows of worksheets begun after this call to the rows from first to last
+    /// inclusive. has_cell() returns false once a worksheet reaches a row after last, and the
+    /// rest of the worksheet isn't decompressed at all.
+    /// Throws invalid_parameter if first is 0 or greater than last.
+    /// </summary>
+    void load_rows(row_t first, row_t last);
+
+    /// <summary>
+    /// Returns the first row which is read. The default is 1.
+    /// </summary>
+    row_t load_first_row() const;
+
+    /// <summary>
+    /// Returns the last row which is read. The default is the greatest possible row.
+    /// </summary>
+    row_t load_last_row() const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -142,6 +220,11 @@ private:
     std::unique_ptr<std::istream> part_stream_;
     std::unique_ptr<std::streambuf> part_stream_buffer_;
     std::unique_ptr<xml::parser> parser_;
+    bool memory_mapped_loading_ = false;
+    bool lazy_shared_strings_ = false;
+    std::vector<column_t> load_columns_;
+    row_t load_first_row_ = 1;
+    row_t load_last_row_ = std::numeric_limits<row_t>::max();
 };
 
 } // namespace xlnt
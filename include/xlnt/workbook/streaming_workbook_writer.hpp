@@ -65,14 +65,18 @@ public:
 
     /// <summary>
     /// Writes a cell to the currently active worksheet at the position given by
-    /// ref and with the given value. ref should be to the right of or below
+    /// ref and with the given value. ref should be in the same row as or below
     /// the previously written cell. Returns a wrapper pointing to the cell.
+    /// Only the cells of the current row are kept in memory. Once a cell in a later
+    /// row is added, the current row is written and wrappers of its cells become invalid.
+    /// Throws invalid_parameter if ref is above a row which was already added.
     /// </summary>
     cell add_cell(const cell_reference &ref);
 
     /// <summary>
     /// Ends writing of data to the current sheet and begins writing a new sheet
     /// with the given title. Returns a wrapper pointing to this new sheet.
+    /// Properties of the sheet and its columns have to be set before its first row is written.
     /// </summary>
     worksheet add_worksheet(const std::string &title);
 
@@ -34,6 +34,7 @@
 #include <vector>
 
 #include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
 #include <xlnt/internal/features.hpp>
 
 #if XLNT_HAS_INCLUDE(<string_view>) && XLNT_HAS_FEATURE(U8_STRING_VIEW)
@@ -82,6 +83,8 @@ struct datetime;
 
 namespace detail {
 
+class calculation_engine;
+class delimited_text_writer;
 struct stylesheet;
 struct workbook_impl;
 struct worksheet_impl;
@@ -545,6 +548,105 @@ public:
 
     // Serialization/Deserialization
 
+    /// <summary>
+    /// Sets the size in bytes of the buffers used to compress and decompress the
+    /// parts of the ZIP archive when this workbook is saved or loaded.
+    /// Parts which are not larger than this are decompressed in one go.
+    /// Values below 512 are rounded up to 512. The default is 64 KiB.
+    /// </summary>
+    void zip_buffer_size(std::size_t size);
+
+    /// <summary>
+    /// Returns the size in bytes of the buffers used to compress and decompress
+    /// the parts of the ZIP archive.
+    /// </summary>
+    std::size_t zip_buffer_size() const;
+
+    /// <summary>
+    /// If enabled, load() maps files which are given by path into memory instead of
+    /// reading them through a file stream. The ZIP directory and the parts are then read
+    /// straight from the mapping, and parts which are stored uncompressed aren't copied.
+    /// The mapping is released when load() returns. Disabled by default.
+    /// </summary>
+    void memory_mapped_loading(bool enabled);
+
+    /// <summary>
+    /// Returns true if load() maps files which are given by path into memory.
+    /// </summary>
+    bool memory_mapped_loading() const;
+
+    /// <summary>
+    /// Sets the number of threads load() uses to decompress and parse worksheets.
+    /// With 1, the default, everything is read on the calling thread. With 0,
+    /// one thread per processor core is used. The rest of the package, like the
+    /// shared strings and the styles, is always read on the calling thread.
+    /// </summary>
+    void load_thread_count(std::size_t count);
+
+    /// <summary>
+    /// Returns the number of threads load() uses to read worksheets.
+    /// </summary>
+    std::size_t load_thread_count() const;
+
+    /// <summary>
+    /// If enabled, load() only reads the workbook itself, its styles, shared strings and
+    /// relationships. The part of each worksheet is read the first time the worksheet is
+    /// accessed, e.g. by sheet_by_title() or sheet_by_index(). Until then, the compressed
+    /// file is kept in memory. Changing the list of worksheets, saving, copying or comparing
+    /// the workbook reads all remaining worksheets. Disabled by default.
+    /// </summary>
+    void lazy_loading(bool enabled);
+
+    /// <summary>
+    /// Returns true if load() reads worksheets on first access.
+    /// </summary>
+    bool lazy_loading() const;
+
+    /// <summary>
+    /// If enabled, load() only finds the entries of the shared string table. Each entry
+    /// is decoded the first time it is requested by shared_strings(index) or the value of
+    /// a cell, entries which only hold plain text without an XML parser. Until then, the
+    /// inflated table is kept in memory. Accessing all shared strings, adding a string
+    /// without duplicates or comparing the workbook decodes all remaining entries.
+    /// Disabled by default.
+    /// </summary>
+    void lazy_shared_strings(bool enabled);
+
+    /// <summary>
+    /// Returns true if load() decodes shared strings on first access.
+    /// </summary>
+    bool lazy_shared_strings() const;
+
+    /// <summary>
+    /// Restricts the cells read by load() to the given columns. The other cells of
+    /// each row are skipped without their values being decoded. An empty vector,
+    /// the default, reads all columns.
+    /// </summary>
+    void load_columns(const std::vector<column_t> &columns);
+
+    /// <summary>
+    /// Returns the columns read by load(), or an empty vector if all columns are read.
+    /// </summary>
+    const std::vector<column_t> &load_columns() const;
+
+    /// <summary>
+    /// Restricts the rows read by load() to the rows from first to last inclusive.
+    /// Once a worksheet reaches a row after last, the rest of its part isn't read at all,
+    /// which means that its merged cells, hyperlinks and the like are lost.
+    /// Throws invalid_parameter if first is 0 or greater than last.
+    /// </summary>
+    void load_rows(row_t first, row_t last);
+
+    /// <summary>
+    /// Returns the first row read by load(). The default is 1.
+    /// </summary>
+    row_t load_first_row() const;
+
+    /// <summary>
+    /// Returns the last row read by load(). The default is the greatest possible row.
+    /// </summary>
+    row_t load_last_row() const;
+
     /// <summary>
     /// Serializes the workbook into an XLSX file and saves the bytes into
     /// byte vector data.
@@ -1154,6 +1256,29 @@ public:
     /// </summary>
     void calculation_properties(const class calculation_properties &props);
 
+    /// <summary>
+    /// Evaluates the formulas of this workbook and stores their results as the values of their cells.
+    /// Common arithmetic, comparison, text, logical, lookup and aggregate functions are supported.
+    /// Formulas which can't be evaluated, e.g. because they use an unsupported function or a defined
+    /// name, keep their values. Once this has been called, formulas reading cells whose values change
+    /// are calculated again on the next call and before the workbook is saved, while the others keep
+    /// their results.
+    /// </summary>
+    void calculate();
+
+    /// <summary>
+    /// Sets the number of threads calculate() uses to evaluate formulas which don't depend on
+    /// each other. With 1, the default, everything is calculated on the calling thread. With 0,
+    /// one thread per processor core is used. Formulas are only calculated on one thread if the
+    /// calculation properties of this workbook disable concurrent calculation.
+    /// </summary>
+    void calculation_thread_count(std::size_t count);
+
+    /// <summary>
+    /// Returns the number of threads calculate() uses to evaluate formulas.
+    /// </summary>
+    std::size_t calculation_thread_count() const;
+
     /// <summary>
     /// Returns true if this workbook is equal to other. If compare_by_reference is true, the comparison
     /// will only check that both workbook instances point to the same internal workbook. Otherwise,
@@ -1205,6 +1330,8 @@ private:
     friend class cell;
     friend class streaming_workbook_reader;
     friend class worksheet;
+    friend class detail::calculation_engine;
+    friend class detail::delimited_text_writer;
     friend class detail::xlsx_consumer;
     friend class detail::xlsx_producer;
     friend struct detail::worksheet_impl;
@@ -1403,6 +1530,29 @@ private:
     /// </summary>
     void default_format(const xlnt::format& format);
 
+    /// <summary>
+    /// Reads the parts of the worksheets which were skipped by lazy_loading(),
+    /// or only the one of worksheet if it isn't null.
+    /// </summary>
+    void load_pending_worksheets(detail::worksheet_impl *worksheet = nullptr) const;
+
+    /// <summary>
+    /// Decodes the shared strings from first to last exclusive which were skipped by
+    /// lazy_shared_strings().
+    /// </summary>
+    void load_pending_shared_strings(std::size_t first, std::size_t last) const;
+
+    /// <summary>
+    /// Returns a copy of the shared string at index, unlike shared_strings(index)
+    /// without the workbook keeping a rich_text for plain text.
+    /// </summary>
+    rich_text shared_string_value(std::size_t index) const;
+
+    /// <summary>
+    /// Returns the text of the shared string at index without creating a rich_text.
+    /// </summary>
+    std::string shared_string_text(std::size_t index) const;
+
     /// <summary>
     /// An opaque pointer to a structure that holds all of the data relating to this workbook.
     /// </summary>
@@ -0,0 +1,70 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Controls how the cells of a worksheet are written as delimited text like CSV or TSV,
+/// see worksheet::write_delimited() and streaming_workbook_reader::write_delimited().
+/// The defaults produce CSV as described by RFC 4180.
+/// </summary>
+class XLNT_API delimited_text_options
+{
+public:
+    /// <summary>
+    /// The character between the fields of a line, e.g. '\t' for TSV.
+    /// </summary>
+    char delimiter = ',';
+
+    /// <summary>
+    /// The character around fields which contain the delimiter, a line break or this character,
+    /// which is doubled inside a field.
+    /// </summary>
+    char quote = '"';
+
+    /// <summary>
+    /// Whether every field is quoted, not only those which need it.
+    /// </summary>
+    bool quote_all = false;
+
+    /// <summary>
+    /// Written after each row.
+    /// </summary>
+    std::string line_ending = "\r\n";
+
+    /// <summary>
+    /// Whether numbers and dates are formatted with the number format of their cell, like
+    /// they are shown by a spreadsheet application. Otherwise they are written as plain
+    /// numbers, with dates as their serial number.
+    /// </summary>
+    bool apply_number_formats = true;
+};
+
+} // namespace xlnt
@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -32,6 +35,8 @@
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/cell/index_types.hpp>
 #include <xlnt/packaging/relationship.hpp>
+#include <xlnt/worksheet/delimited_text_options.hpp>
+#include <xlnt/worksheet/major_order.hpp>
 #include <xlnt/worksheet/page_margins.hpp>
 #include <xlnt/worksheet/page_setup.hpp>
 #include <xlnt/worksheet/sheet_view.hpp>
@@ -268,6 +273,36 @@ public:
     /// </summary>
     const class range columns(bool skip_null = true) const;
 
+    /// <summary>
+    /// Calls f for each cell which exists in this sheet in the given order without visiting
+    /// the empty positions between them, so this takes time proportional to the number of cells.
+    /// If set, line_start and line_end are called with the index of each row (or column in
+    /// column-major order) before its first and after its last cell. Empty lines are skipped.
+    /// Cells must not be created or cleared by the callbacks.
+    /// </summary>
+    void for_each_cell(major_order order, std::function<void(class cell)> f,
+        std::function<void(std::uint32_t)> line_start = nullptr,
+        std::function<void(std::uint32_t)> line_end = nullptr);
+
+    /// <summary>
+    /// Calls f for each cell which exists in this sheet in the given order without visiting
+    /// the empty positions between them, so this takes time proportional to the number of cells.
+    /// If set, line_start and line_end are called with the index of each row (or column in
+    /// column-major order) before its first and after its last cell. Empty lines are skipped.
+    /// </summary>
+    void for_each_cell(major_order order, std::function<void(const class cell &)> f,
+        std::function<void(std::uint32_t)> line_start = nullptr,
+        std::function<void(std::uint32_t)> line_end = nullptr) const;
+
+    /// <summary>
+    /// Writes the values of the cells of this sheet to stream as delimited text like CSV,
+    /// one line per row starting at row 1 and one field per column starting at column A.
+    /// Values are formatted with the number format of their cell. Shared strings and
+    /// formats are looked up once each, so this is much faster than calling
+    /// cell::to_string() for each cell.
+    /// </summary>
+    void write_delimited(std::ostream &stream, const delimited_text_options &options = delimited_text_options()) const;
+
     //TODO: finish implementing cell_iterator wrapping before uncommenting
     //class cell_vector cells(bool skip_null = true);
 
@@ -925,6 +960,8 @@ public:
 
 private:
     friend class cell;
+    friend class cell_iterator;
+    friend class const_cell_iterator;
     friend class const_range_iterator;
     friend class range_iterator;
     friend class workbook;
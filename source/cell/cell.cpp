@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <utility>
 
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/cell/cell_reference.hpp>
@@ -148,6 +149,101 @@ std::pair<bool, xlnt::time> cast_time(const std::string &s)
     return {true, result};
 }
 
+const xlnt::detail::cell_extension *find_extension(const xlnt::detail::cell_impl *d)
+{
+    return d->parent_->cell_map_.find_extension(*d);
+}
+
+xlnt::detail::cell_extension &get_extension(xlnt::detail::cell_impl *d)
+{
+    return d->parent_->cell_map_.extension(*d);
+}
+
+xlnt::detail::cell_store &cell_map(xlnt::detail::cell_impl *d)
+{
+    return d->parent_->cell_map_;
+}
+
+// Gives target the text and formula of source, which may belong to another worksheet
+void copy_text_and_formula(const xlnt::detail::cell_impl *source, xlnt::detail::cell_impl *target)
+{
+    const auto &from = source->parent_->cell_map_;
+    auto &to = target->parent_->cell_map_;
+
+    auto text = from.find_text(*source);
+    if (text != nullptr)
+    {
+        to.text(*target) = *text;
+    }
+    else
+    {
+        to.clear_text(*target);
+    }
+
+    auto formula = from.find_formula(*source);
+    if (formula != nullptr)
+    {
+        to.formula(*target) = *formula;
+    }
+    else
+    {
+        to.clear_formula(*target);
+    }
+}
+
+// must be called before the type or value of a cell changes so that the
+// shared string reference counts of its worksheet stay correct
+void release_shared_string(xlnt::detail::cell_impl *d)
+{
+    d->parent_->cell_map_.release_shared_string(*d);
+}
+
+// must be called when the type or value of a cell changes so that the
+// formulas reading the cell are calculated again
+void value_changed(xlnt::detail::cell_impl *d)
+{
+    if (d->parent_->calculation_engine_ != nullptr)
+    {
+        d->parent_->calculation_engine_->value_changed(*d->parent_, d->column_.index, d->row_);
+    }
+}
+
+// must be called after the formula of a cell was set or cleared
+void formula_changed(xlnt::detail::cell_impl *d)
+{
+    if (d->parent_->calculation_engine_ != nullptr)
+    {
+        d->parent_->calculation_engine_->formula_changed(*d->parent_, d->column_.index, d->row_);
+    }
+}
+
+void reference_shared_string(xlnt::detail::cell_impl *d)
+{
+    d->parent_->cell_map_.reference_shared_string(*d);
+}
+
+/// Changes format with edit and assigns it to cell. If the cell handed its format over
+/// to be edited, it gets it back when edit throws.
+template <typename Edit>
+void edit_format(xlnt::cell &cell, xlnt::format &format, bool handed_over, Edit edit)
+{
+    try
+    {
+        edit(format);
+    }
+    catch (...)
+    {
+        if (handed_over)
+        {
+            cell.format(format);
+        }
+
+        throw;
+    }
+
+    cell.format(format);
+}
+
 } // namespace
 
 namespace xlnt {
@@ -198,7 +294,7 @@ cell::cell(detail::cell_impl *d)
 
 bool cell::garbage_collectible() const
 {
-    return d_->is_garbage_collectible();
+    return d_->parent_->cell_map_.is_garbage_collectible(*d_);
 }
 
 void cell::value(std::nullptr_t)
@@ -208,42 +304,56 @@ void cell::value(std::nullptr_t)
 
 void cell::value(bool boolean_value)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = type::boolean;
     d_->value_numeric_ = boolean_value ? 1.0 : 0.0;
 }
 
 void cell::value(int int_value)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(unsigned int int_value)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(long long int int_value)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(unsigned long long int int_value)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(float float_value)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
 }
 
 void cell::value(double float_value)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
 }
@@ -274,24 +384,39 @@ void cell::value(const cell c)
     }
 
     // Same workbook: shallow copy (existing behavior)
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = c.d_->type_;
     d_->value_numeric_ = c.d_->value_numeric_;
-    d_->value_text_ = c.d_->value_text_;
-    d_->hyperlink_ = c.d_->hyperlink_;
-    d_->formula_ = c.d_->formula_;
     d_->format_ = c.d_->format_;
+    reference_shared_string(d_);
+
+    copy_text_and_formula(c.d_, d_);
+
+    auto link = cell_map(c.d_).find_hyperlink(*c.d_);
+    if (link != nullptr)
+    {
+        cell_map(d_).hyperlink(*d_) = *link;
+    }
+    else
+    {
+        cell_map(d_).clear_hyperlink(*d_);
+    }
+
+    formula_changed(d_);
 }
 
 void cell::value_no_check(const rich_text &text)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = type::shared_string;
     d_->value_numeric_ = static_cast<double>(workbook().add_shared_string(text));
+    reference_shared_string(d_);
 }
 
 void cell::copy_from_other_workbook(const cell &source)
 {
-    d_->type_ = source.d_->type_;
-
     // Handle shared_string: remap to destination workbook
     if (source.data_type() == type::shared_string)
     {
@@ -299,11 +424,15 @@ void cell::copy_from_other_workbook(const cell &source)
     }
     else
     {
+        release_shared_string(d_);
+        value_changed(d_);
+        d_->type_ = source.d_->type_;
         d_->value_numeric_ = source.d_->value_numeric_;
     }
 
-    d_->value_text_ = source.d_->value_text_;
-    d_->formula_ = source.d_->formula_;
+    copy_text_and_formula(source.d_, d_);
+
+    formula_changed(d_);
 
     // Copy external hyperlinks; internal hyperlinks (cell/range references)
     // are not yet implemented as they would need worksheet title remapping.
@@ -330,6 +459,8 @@ void cell::copy_from_other_workbook(const cell &source)
 
 void cell::value(const date &d)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = type::number;
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_yyyymmdd2());
@@ -337,6 +468,8 @@ void cell::value(const date &d)
 
 void cell::value(const datetime &d)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = type::number;
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_datetime());
@@ -344,6 +477,8 @@ void cell::value(const datetime &d)
 
 void cell::value(const time &t)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = type::number;
     d_->value_numeric_ = t.to_number();
     number_format(number_format::date_time6());
@@ -351,6 +486,8 @@ void cell::value(const time &t)
 
 void cell::value(const timedelta &t)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = type::number;
     d_->value_numeric_ = t.to_number();
     number_format(xlnt::number_format("[hh]:mm:ss"));
@@ -373,22 +510,32 @@ column_t::index_t cell::column_index() const
 
 void cell::merged(bool merged)
 {
-    d_->is_merged_ = merged;
+    if (merged || find_extension(d_) != nullptr)
+    {
+        get_extension(d_).is_merged_ = merged;
+        d_->parent_->cell_map_.compact_extension(*d_);
+    }
 }
 
 bool cell::is_merged() const
 {
-    return d_->is_merged_;
+    auto extension = find_extension(d_);
+    return extension != nullptr && extension->is_merged_;
 }
 
 bool cell::phonetics_visible() const
 {
-    return d_->phonetics_visible_;
+    auto extension = find_extension(d_);
+    return extension != nullptr && extension->phonetics_visible_;
 }
 
 void cell::show_phonetics(bool phonetics)
 {
-    d_->phonetics_visible_ = phonetics;
+    if (phonetics || find_extension(d_) != nullptr)
+    {
+        get_extension(d_).phonetics_visible_ = phonetics;
+        d_->parent_->cell_map_.compact_extension(*d_);
+    }
 }
 
 bool cell::is_date() const
@@ -411,7 +558,7 @@ bool cell::compare(const cell &other, bool compare_by_reference) const
     }
     else
     {
-        return *d_ == *other.d_;
+        return *d_ == *other.d_ && cell_map(d_).attributes_equal(*d_, cell_map(other.d_), *other.d_);
     }
 }
 
@@ -429,11 +576,11 @@ cell &cell::operator=(const cell &rhs) = default;
 
 hyperlink cell::hyperlink() const
 {
-    if (!d_->hyperlink_.is_set())
+    if (!has_hyperlink())
     {
         throw invalid_attribute("cell \"" + reference().to_string() + "\" has no hyperlink");
     }
-    return xlnt::hyperlink(&d_->hyperlink_.get());
+    return xlnt::hyperlink(&cell_map(d_).hyperlink(*d_));
 }
 
 void cell::hyperlink(const std::string &url, const std::string &display)
@@ -446,7 +593,8 @@ void cell::hyperlink(const std::string &url, const std::string &display)
     auto ws = worksheet();
     auto &manifest = ws.workbook().manifest();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
+    auto &link = cell_map(d_).hyperlink(*d_);
+    link = detail::hyperlink_impl();
 
     // check for existing relationships
     auto relationships = manifest.relationships(ws.path(), relationship_type::hyperlink);
@@ -454,7 +602,7 @@ void cell::hyperlink(const std::string &url, const std::string &display)
     [&url](const xlnt::relationship &rel) { return rel.target().to_string() == url; });
     if (relation != relationships.end())
     {
-        d_->hyperlink_.get().relationship = *relation;
+        link.relationship = *relation;
     }
     else
     { // register a new relationship
@@ -464,16 +612,16 @@ void cell::hyperlink(const std::string &url, const std::string &display)
             uri(url),
             target_mode::external);
         // TODO: make manifest::register_relationship return the created relationship instead of rel id
-        d_->hyperlink_.get().relationship = manifest.relationship(ws.path(), rel_id);
+        link.relationship = manifest.relationship(ws.path(), rel_id);
     }
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        link.display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? url : display);
+        link.display.set(display.empty() ? url : display);
         value(hyperlink().display());
     }
 }
@@ -483,17 +631,18 @@ void cell::hyperlink(xlnt::cell target, const std::string &display)
     // TODO: should this computed value be a method on a cell?
     const auto cell_address = target.worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
-    d_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
+    auto &link = cell_map(d_).hyperlink(*d_);
+    link = detail::hyperlink_impl();
+    link.relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(cell_address), target_mode::internal);
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        link.display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? cell_address : display);
+        link.display.set(display.empty() ? cell_address : display);
         value(hyperlink().display());
     }
 }
@@ -503,18 +652,19 @@ void cell::hyperlink(xlnt::range target, const std::string &display)
     // TODO: should this computed value be a method on a cell?
     const auto range_address = target.target_worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
-    d_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
+    auto &link = cell_map(d_).hyperlink(*d_);
+    link = detail::hyperlink_impl();
+    link.relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(range_address), target_mode::internal);
 
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        link.display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? range_address : display);
+        link.display.set(display.empty() ? range_address : display);
         value(hyperlink().display());
     }
 }
@@ -528,35 +678,37 @@ void cell::formula(const std::string &formula)
 
     if (formula[0] == '=')
     {
-        d_->formula_ = formula.substr(1);
+        cell_map(d_).formula(*d_) = formula.substr(1);
     }
     else
     {
-        d_->formula_ = formula;
+        cell_map(d_).formula(*d_) = formula;
     }
 
+    formula_changed(d_);
     worksheet().register_calc_chain_in_manifest();
 }
 
 bool cell::has_formula() const
 {
-    return d_->formula_.is_set();
+    return cell_map(d_).find_formula(*d_) != nullptr;
 }
 
 std::string cell::formula() const
 {
-    if (!d_->formula_.is_set())
+    if (!has_formula())
     {
         throw invalid_attribute("cell \"" + reference().to_string() + "\" has no formula");
     }
-    return d_->formula_.get();
+    return *cell_map(d_).find_formula(*d_);
 }
 
 void cell::clear_formula()
 {
     if (has_formula())
     {
-        d_->formula_.clear();
+        cell_map(d_).clear_formula(*d_);
+        formula_changed(d_);
         worksheet().garbage_collect_formulae();
     }
 }
@@ -577,7 +729,9 @@ void cell::error(const std::string &error)
         throw invalid_data_type(error);
     }
 
-    d_->value_text_.plain_text(error, false);
+    release_shared_string(d_);
+    value_changed(d_);
+    cell_map(d_).text(*d_).plain_text(error, false);
     d_->type_ = type::error;
 }
 
@@ -632,7 +786,10 @@ cell::type cell::data_type() const
 
 void cell::data_type(type t)
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->type_ = t;
+    reference_shared_string(d_);
 }
 
 number_format cell::computed_number_format() const
@@ -667,8 +824,10 @@ protection cell::computed_protection() const
 
 void cell::clear_value()
 {
+    release_shared_string(d_);
+    value_changed(d_);
     d_->value_numeric_ = 0;
-    d_->value_text_.clear();
+    cell_map(d_).clear_text(*d_);
     d_->type_ = cell::type::empty;
     clear_formula();
 }
@@ -741,43 +900,56 @@ timedelta cell::value() const
 
 void cell::alignment(const class alignment &alignment_)
 {
-    auto new_format = has_format() ? modifiable_format() : workbook().create_format();
-    format(new_format.alignment(alignment_, optional<bool>(true)));
+    // Taking over the cell's reference lets a format used by this cell only be edited
+    // in place, rather than copied and garbage collected on every change.
+    const auto handed_over = has_format();
+    auto new_format = handed_over ? xlnt::format(std::move(d_->format_)) : workbook().create_format();
+    edit_format(*this, new_format, handed_over, [&alignment_](xlnt::format &f) { f.alignment(alignment_, optional<bool>(true)); });
 }
 
 void cell::border(const class border &border_)
 {
-    auto new_format = has_format() ? modifiable_format() : workbook().create_format();
-    format(new_format.border(border_, optional<bool>(true)));
+    const auto handed_over = has_format();
+    auto new_format = handed_over ? xlnt::format(std::move(d_->format_)) : workbook().create_format();
+    edit_format(*this, new_format, handed_over, [&border_](xlnt::format &f) { f.border(border_, optional<bool>(true)); });
 }
 
 void cell::fill(const class fill &fill_)
 {
-    auto new_format = has_format() ? modifiable_format() : workbook().create_format();
-    format(new_format.fill(fill_, optional<bool>(true)));
+    const auto handed_over = has_format();
+    auto new_format = handed_over ? xlnt::format(std::move(d_->format_)) : workbook().create_format();
+    edit_format(*this, new_format, handed_over, [&fill_](xlnt::format &f) { f.fill(fill_, optional<bool>(true)); });
 }
 
 void cell::font(const class font &font_)
 {
-    auto new_format = has_format() ? modifiable_format() : workbook().create_format();
-    format(new_format.font(font_, optional<bool>(true)));
+    const auto handed_over = has_format();
+    auto new_format = handed_over ? xlnt::format(std::move(d_->format_)) : workbook().create_format();
+    edit_format(*this, new_format, handed_over, [&font_](xlnt::format &f) { f.font(font_, optional<bool>(true)); });
 }
 
 void cell::number_format(const class number_format &number_format_)
 {
-    auto new_format = has_format() ? modifiable_format() : workbook().create_format();
-    format(new_format.number_format(number_format_, optional<bool>(true)));
+    const auto handed_over = has_format();
+    auto new_format = handed_over ? xlnt::format(std::move(d_->format_)) : workbook().create_format();
+    edit_format(*this, new_format, handed_over, [&number_format_](xlnt::format &f) { f.number_format(number_format_, optional<bool>(true)); });
 }
 
 void cell::protection(const class protection &protection_)
 {
-    auto new_format = has_format() ? modifiable_format() : workbook().create_format();
-    format(new_format.protection(protection_, optional<bool>(true)));
+    const auto handed_over = has_format();
+    auto new_format = handed_over ? xlnt::format(std::move(d_->format_)) : workbook().create_format();
+    edit_format(*this, new_format, handed_over, [&protection_](xlnt::format &f) { f.protection(protection_, optional<bool>(true)); });
 }
 
 template <>
 std::string cell::value() const
 {
+    if (data_type() == cell::type::shared_string)
+    {
+        return workbook().shared_string_text(static_cast<std::size_t>(d_->value_numeric_));
+    }
+
     return value<rich_text>().plain_text();
 }
 
@@ -786,10 +958,11 @@ rich_text cell::value() const
 {
     if (data_type() == cell::type::shared_string)
     {
-        return workbook().shared_strings(static_cast<std::size_t>(d_->value_numeric_));
+        return workbook().shared_string_value(static_cast<std::size_t>(d_->value_numeric_));
     }
 
-    return d_->value_text_;
+    auto text = cell_map(d_).find_text(*d_);
+    return text == nullptr ? rich_text() : *text;
 }
 
 bool cell::has_value() const
@@ -800,6 +973,14 @@ bool cell::has_value() const
 std::string cell::to_string() const
 {
     auto nf = computed_number_format();
+    auto wb = workbook();
+
+    // the format is compiled once per workbook instead of once per cell
+    auto formatter = [&nf, &wb](calendar base_date) {
+        return wb.d_->stylesheet_.is_set()
+            ? wb.d_->stylesheet_.get().compiled_number_formats.formatter(nf.format_string(), base_date)
+            : std::make_shared<const detail::number_formatter>(nf.format_string(), base_date);
+    };
 
     switch (data_type())
     {
@@ -807,12 +988,12 @@ std::string cell::to_string() const
         return "";
     case cell::type::date:
     case cell::type::number:
-        return nf.format(value<double>(), base_date());
+        return formatter(base_date())->format_number(value<double>());
     case cell::type::inline_string:
     case cell::type::shared_string:
     case cell::type::formula_string:
     case cell::type::error:
-        return nf.format(value<std::string>());
+        return formatter(calendar::windows_1900)->format_text(value<std::string>());
     case cell::type::boolean:
         return value<double>() == 0.0 ? "FALSE" : "TRUE";
     }
@@ -901,6 +1082,8 @@ void cell::value(const std::string &value_string, bool infer_type)
 
     if (percentage.first)
     {
+        release_shared_string(d_);
+        value_changed(d_);
         d_->value_numeric_ = percentage.second;
         d_->type_ = cell::type::number;
         number_format(xlnt::number_format::percentage());
@@ -911,6 +1094,8 @@ void cell::value(const std::string &value_string, bool infer_type)
 
         if (time.first)
         {
+            release_shared_string(d_);
+            value_changed(d_);
             d_->type_ = cell::type::number;
             number_format(number_format::date_time6());
             d_->value_numeric_ = time.second.to_number();
@@ -921,6 +1106,8 @@ void cell::value(const std::string &value_string, bool infer_type)
 
             if (numeric.first)
             {
+                release_shared_string(d_);
+                value_changed(d_);
                 d_->value_numeric_ = numeric.second;
                 d_->type_ = cell::type::number;
             }
@@ -1070,14 +1257,15 @@ protection cell::protection() const
 
 bool cell::has_hyperlink() const
 {
-    return d_->hyperlink_.is_set();
+    return cell_map(d_).find_hyperlink(*d_) != nullptr;
 }
 
 // comment
 
 bool cell::has_comment() const
 {
-    return d_->comment_.is_set();
+    auto extension = find_extension(d_);
+    return extension != nullptr && extension->comment_ != nullptr;
 }
 
 void cell::clear_comment()
@@ -1085,7 +1273,8 @@ void cell::clear_comment()
     if (has_comment())
     {
         d_->parent_->comments_.erase(reference().to_string());
-        d_->comment_.clear();
+        get_extension(d_).comment_ = nullptr;
+        d_->parent_->cell_map_.compact_extension(*d_);
     }
 }
 
@@ -1096,7 +1285,7 @@ class comment cell::comment() const
         throw xlnt::invalid_attribute("cell " + reference().to_string() + " has no comment");
     }
 
-    return *d_->comment_.get();
+    return *find_extension(d_)->comment_;
 }
 
 void cell::comment(const std::string &text, const std::string &author)
@@ -1113,12 +1302,12 @@ void cell::comment(const class comment &new_comment)
 {
     if (has_comment())
     {
-        *d_->comment_.get() = new_comment;
+        *get_extension(d_).comment_ = new_comment;
     }
     else
     {
         d_->parent_->comments_[reference().to_string()] = new_comment;
-        d_->comment_.set(&d_->parent_->comments_[reference().to_string()]);
+        get_extension(d_).comment_ = &d_->parent_->comments_[reference().to_string()];
     }
 
     // offset comment 5 pixels down and 5 pixels right of the top right corner of the cell
@@ -1126,7 +1315,7 @@ void cell::comment(const class comment &new_comment)
     cell_position.first += static_cast<int>(width()) + 5;
     cell_position.second += 5;
 
-    d_->comment_.get()->position(cell_position.first, cell_position.second);
+    get_extension(d_).comment_->position(cell_position.first, cell_position.second);
 
     worksheet().register_comments_in_manifest();
 }
@@ -749,10 +749,7 @@ template <typename T>
 void xlsx_consumer::read_internal(std::istream &source, const T &password)
 {
     std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(source)), (std::istreambuf_iterator<char>()));
-    const auto decrypted = decrypt_xlsx(data, password);
-    vector_istreambuf decrypted_buffer(decrypted);
-    std::istream decrypted_stream(&decrypted_buffer);
-    read(decrypted_stream);
+    read(decrypt_xlsx(data, password));
 }
 
 void xlsx_consumer::read(std::istream &source, const std::string &password)
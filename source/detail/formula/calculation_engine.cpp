@@ -0,0 +1,1158 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <xlnt/cell/cell_type.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <detail/formula/calculation_engine.hpp>
+#include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/workbook_impl.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+
+namespace {
+
+using xlnt::detail::formula_error;
+using xlnt::detail::formula_instruction;
+using xlnt::detail::formula_value;
+
+bool equal_ignoring_case(const std::string &lhs, const std::string &rhs)
+{
+    return lhs.size() == rhs.size()
+        && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+               return std::toupper(static_cast<unsigned char>(a)) == std::toupper(static_cast<unsigned char>(b));
+           });
+}
+
+formula_value arithmetic(formula_instruction::opcode op, const formula_value &lhs, const formula_value &rhs)
+{
+    using opcode = formula_instruction::opcode;
+
+    double left = 0;
+    double right = 0;
+    formula_error error;
+
+    if (!xlnt::detail::to_number(lhs, left, error) || !xlnt::detail::to_number(rhs, right, error))
+    {
+        return formula_value::from_error(error);
+    }
+
+    double result = 0;
+
+    switch (op)
+    {
+    case opcode::add:
+        result = left + right;
+        break;
+    case opcode::subtract:
+        result = left - right;
+        break;
+    case opcode::multiply:
+        result = left * right;
+        break;
+    case opcode::divide:
+        if (right == 0)
+        {
+            return formula_value::from_error(formula_error::div0);
+        }
+
+        result = left / right;
+        break;
+    default:
+        if (left == 0 && right < 0)
+        {
+            return formula_value::from_error(formula_error::div0);
+        }
+
+        result = std::pow(left, right);
+        break;
+    }
+
+    return std::isfinite(result) ? formula_value::from_number(result) : formula_value::from_error(formula_error::num);
+}
+
+formula_value binary_operation(formula_instruction::opcode op, const formula_value &lhs, const formula_value &rhs)
+{
+    using opcode = formula_instruction::opcode;
+
+    if (lhs.is_error())
+    {
+        return lhs;
+    }
+
+    if (rhs.is_error())
+    {
+        return rhs;
+    }
+
+    switch (op)
+    {
+    case opcode::concatenate:
+        return formula_value::from_string(xlnt::detail::to_text(lhs) + xlnt::detail::to_text(rhs));
+    case opcode::equal:
+        return formula_value::from_boolean(xlnt::detail::compare_values(lhs, rhs) == 0);
+    case opcode::not_equal:
+        return formula_value::from_boolean(xlnt::detail::compare_values(lhs, rhs) != 0);
+    case opcode::less:
+        return formula_value::from_boolean(xlnt::detail::compare_values(lhs, rhs) < 0);
+    case opcode::less_equal:
+        return formula_value::from_boolean(xlnt::detail::compare_values(lhs, rhs) <= 0);
+    case opcode::greater:
+        return formula_value::from_boolean(xlnt::detail::compare_values(lhs, rhs) > 0);
+    case opcode::greater_equal:
+        return formula_value::from_boolean(xlnt::detail::compare_values(lhs, rhs) >= 0);
+    default:
+        return arithmetic(op, lhs, rhs);
+    }
+}
+
+// levels whose formulas read fewer cells than this are evaluated on the calling thread,
+// since waking the workers would take longer than evaluating them
+const std::size_t minimum_concurrent_cost = 16384;
+
+std::size_t calculation_thread_count(const xlnt::detail::workbook_impl &workbook)
+{
+    if (workbook.calculation_properties_.is_set() && !workbook.calculation_properties_.get().concurrent_calc)
+    {
+        return 1;
+    }
+
+    auto count = workbook.calculation_thread_count_;
+
+    if (count == 0)
+    {
+        count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    return count;
+}
+
+/// <summary>
+/// Threads which run a task for each index of a range together with the calling thread.
+/// Each thread takes the next few indices until none are left, so that threads which
+/// get cheap tasks take more of them.
+/// </summary>
+class worker_pool
+{
+public:
+    using task = std::function<void(std::size_t index, std::size_t thread)>;
+
+    explicit worker_pool(std::size_t worker_count)
+    {
+        for (std::size_t i = 0; i < worker_count; ++i)
+        {
+            workers_.emplace_back([this, i]() { work(i + 1); });
+        }
+    }
+
+    ~worker_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+
+        started_.notify_all();
+
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    /// <summary>
+    /// Calls run_task(index, thread) for each index in [0, count), where thread is 0 on the calling
+    /// thread and 1 to the number of workers on the workers. Rethrows the first exception of a task.
+    /// </summary>
+    void run(std::size_t count, const task &run_task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &run_task;
+            count_ = count;
+            next_ = 0;
+            busy_ = workers_.size();
+            ++generation_;
+        }
+
+        started_.notify_all();
+        take_tasks(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [this]() { return busy_ == 0; });
+
+        if (error_)
+        {
+            auto error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void work(std::size_t thread)
+    {
+        std::size_t generation = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                started_.wait(lock, [this, generation]() { return stopping_ || generation_ != generation; });
+
+                if (stopping_)
+                {
+                    return;
+                }
+
+                generation = generation_;
+            }
+
+            take_tasks(thread);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (--busy_ == 0)
+            {
+                finished_.notify_one();
+            }
+        }
+    }
+
+    void take_tasks(std::size_t thread)
+    {
+        const std::size_t batch = 4;
+
+        for (auto first = next_.fetch_add(batch); first < count_; first = next_.fetch_add(batch))
+        {
+            const auto last = std::min(first + batch, count_);
+
+            try
+            {
+                for (auto index = first; index < last; ++index)
+                {
+                    (*task_)(index, thread);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (!error_)
+                {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable started_;
+    std::condition_variable finished_;
+
+    const task *task_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_ {0};
+    std::size_t busy_ = 0;
+    std::size_t generation_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+calculation_engine::cell_key calculation_engine::key(std::size_t sheet, column_t::index_t column, row_t row)
+{
+    // columns beyond the 2^20 Excel doesn't reach would share keys, which only costs extra evaluations
+    return (static_cast<cell_key>(sheet) << 52) | (static_cast<cell_key>(column & 0xFFFFF) << 32) | row;
+}
+
+calculation_engine::cell_key calculation_engine::block_key(std::size_t sheet, column_t::index_t block)
+{
+    return (static_cast<cell_key>(sheet) << 32) | block;
+}
+
+void calculation_engine::value_changed(const worksheet_impl &sheet, column_t::index_t column, row_t row)
+{
+    if (calculate_all_)
+    {
+        return;
+    }
+
+    const auto index = sheet_index(sheet);
+
+    if (index == formula_range::invalid_sheet)
+    {
+        invalidate();
+        return;
+    }
+
+    mark_readers(index, column, row);
+}
+
+void calculation_engine::formula_changed(const worksheet_impl &sheet, column_t::index_t column, row_t row)
+{
+    rebuild_ = true;
+
+    if (calculate_all_)
+    {
+        return;
+    }
+
+    const auto index = sheet_index(sheet);
+
+    if (index == formula_range::invalid_sheet)
+    {
+        invalidate();
+        return;
+    }
+
+    // the cell itself must be evaluated if it has a new formula, and its readers in any case
+    changed_formulas_.push_back(key(index, column, row));
+    mark_readers(index, column, row);
+}
+
+void calculation_engine::invalidate()
+{
+    rebuild_ = true;
+    calculate_all_ = true;
+}
+
+void calculation_engine::calculate(const workbook &wb)
+{
+    workbook_ = &wb;
+
+    if (sheets_changed(*wb.d_))
+    {
+        invalidate();
+    }
+
+    if (rebuild_)
+    {
+        build(*wb.d_);
+    }
+
+    // formulas reading a dirty formula are dirty as well
+    std::vector<std::size_t> pending;
+
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+        if (dirty_[i])
+        {
+            pending.push_back(i);
+        }
+    }
+
+    for (std::size_t i = 0; i < pending.size(); ++i)
+    {
+        const auto &node = nodes_[pending[i]];
+
+        for_each_reader(node.sheet, node.column, node.row, [this, &pending](std::size_t reader) {
+            if (!dirty_[reader])
+            {
+                dirty_[reader] = true;
+                pending.push_back(reader);
+            }
+        });
+    }
+
+    std::vector<std::size_t> unresolved(nodes_.size(), 0);
+
+    for (auto index : pending)
+    {
+        const auto &node = nodes_[index];
+
+        for_each_reader(node.sheet, node.column, node.row, [&unresolved](std::size_t reader) {
+            ++unresolved[reader];
+        });
+    }
+
+    // evaluate level by level, each formula after the dirty formulas it reads (Kahn's algorithm).
+    // The formulas of a level don't read each other, so they can be evaluated concurrently. Their
+    // results are stored after the whole level has been evaluated, on this thread only.
+    std::vector<std::size_t> level;
+
+    for (auto index : pending)
+    {
+        if (unresolved[index] == 0)
+        {
+            level.push_back(index);
+        }
+    }
+
+    const auto thread_count = calculation_thread_count(*wb.d_);
+    std::unique_ptr<worker_pool> workers;
+    std::vector<std::vector<formula_value>> stacks(thread_count);
+    std::vector<formula_value> results;
+    std::vector<std::size_t> next_level;
+
+    const worker_pool::task evaluate_level = [this, &level, &results, &stacks](std::size_t index, std::size_t thread) {
+        const auto &node = nodes_[level[index]];
+
+        if (node.compiled)
+        {
+            results[index] = evaluate(node, stacks[thread]);
+        }
+    };
+
+    while (!level.empty())
+    {
+        results.assign(level.size(), formula_value());
+
+        std::size_t cost = 0;
+
+        for (auto index : level)
+        {
+            cost += nodes_[index].cost;
+        }
+
+        if (thread_count > 1 && level.size() > 1 && cost >= minimum_concurrent_cost)
+        {
+            if (workers == nullptr)
+            {
+                prepare_concurrent_reads(wb);
+                workers.reset(new worker_pool(thread_count - 1));
+            }
+
+            workers->run(level.size(), evaluate_level);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < level.size(); ++i)
+            {
+                evaluate_level(i, 0);
+            }
+        }
+
+        next_level.clear();
+
+        for (std::size_t i = 0; i < level.size(); ++i)
+        {
+            const auto &node = nodes_[level[i]];
+            dirty_[level[i]] = false;
+
+            if (node.compiled)
+            {
+                store(node, results[i]);
+            }
+
+            for_each_reader(node.sheet, node.column, node.row, [&unresolved, &next_level](std::size_t reader) {
+                if (--unresolved[reader] == 0)
+                {
+                    next_level.push_back(reader);
+                }
+            });
+        }
+
+        level.swap(next_level);
+
+        if (level.empty())
+        {
+            // the formulas left are part of circular references or read one
+            level = resolve_circular(pending, unresolved);
+        }
+    }
+
+    calculate_all_ = false;
+}
+
+std::vector<std::size_t> calculation_engine::resolve_circular(const std::vector<std::size_t> &pending,
+    std::vector<std::size_t> &unresolved)
+{
+    // the dirty formulas left and, for each of them, the dirty formulas reading it
+    std::vector<std::size_t> left;
+    std::unordered_map<std::size_t, std::size_t> position;
+
+    for (auto index : pending)
+    {
+        if (dirty_[index])
+        {
+            position[index] = left.size();
+            left.push_back(index);
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> readers(left.size());
+    std::vector<bool> reads_itself(left.size(), false);
+
+    for (std::size_t i = 0; i < left.size(); ++i)
+    {
+        const auto &node = nodes_[left[i]];
+
+        for_each_reader(node.sheet, node.column, node.row, [&](std::size_t reader) {
+            auto match = position.find(reader);
+
+            if (match != position.end())
+            {
+                readers[i].push_back(match->second);
+                reads_itself[i] = reads_itself[i] || match->second == i;
+            }
+        });
+    }
+
+    // Tarjan's algorithm, without recursion as the chains of formulas can be long. The formulas of a
+    // strongly connected component with more than one formula, or which reads itself, are circular.
+    const auto unvisited = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> order(left.size(), unvisited);
+    std::vector<std::size_t> lowest(left.size(), 0);
+    std::vector<bool> on_stack(left.size(), false);
+    std::vector<bool> circular(left.size(), false);
+    std::vector<std::size_t> stack;
+    std::vector<std::pair<std::size_t, std::size_t>> calls; // a formula and the next of its readers to visit
+    std::size_t visited = 0;
+
+    auto visit = [&](std::size_t i) {
+        order[i] = lowest[i] = visited++;
+        stack.push_back(i);
+        on_stack[i] = true;
+        calls.emplace_back(i, 0);
+    };
+
+    for (std::size_t root = 0; root < left.size(); ++root)
+    {
+        if (order[root] != unvisited)
+        {
+            continue;
+        }
+
+        visit(root);
+
+        while (!calls.empty())
+        {
+            const auto i = calls.back().first;
+
+            if (calls.back().second < readers[i].size())
+            {
+                const auto reader = readers[i][calls.back().second++];
+
+                if (order[reader] == unvisited)
+                {
+                    visit(reader);
+                }
+                else if (on_stack[reader])
+                {
+                    lowest[i] = std::min(lowest[i], order[reader]);
+                }
+
+                continue;
+            }
+
+            calls.pop_back();
+
+            if (!calls.empty())
+            {
+                const auto caller = calls.back().first;
+                lowest[caller] = std::min(lowest[caller], lowest[i]);
+            }
+
+            if (lowest[i] != order[i])
+            {
+                continue;
+            }
+
+            const auto is_circular = stack.back() != i || reads_itself[i];
+            std::size_t member = 0;
+
+            do
+            {
+                member = stack.back();
+                stack.pop_back();
+                on_stack[member] = false;
+                circular[member] = is_circular;
+            } while (member != i);
+        }
+    }
+
+    // Excel evaluates circular references to 0 unless iterative calculation is enabled. The formulas
+    // reading them are evaluated afterwards, with that value.
+    std::vector<std::size_t> ready;
+
+    for (std::size_t i = 0; i < left.size(); ++i)
+    {
+        if (!circular[i])
+        {
+            continue;
+        }
+
+        const auto &node = nodes_[left[i]];
+        dirty_[left[i]] = false;
+
+        if (node.compiled)
+        {
+            store(node, formula_value::from_number(0));
+        }
+
+        for (auto reader : readers[i])
+        {
+            if (!circular[reader] && --unresolved[left[reader]] == 0)
+            {
+                ready.push_back(left[reader]);
+            }
+        }
+    }
+
+    return ready;
+}
+
+bool calculation_engine::sheets_changed(workbook_impl &workbook) const
+{
+    if (workbook.worksheets_.size() != sheets_.size())
+    {
+        return true;
+    }
+
+    auto entry = sheets_.begin();
+
+    for (auto &sheet : workbook.worksheets_)
+    {
+        if (entry->sheet != &sheet || entry->id != sheet.id_ || entry->title != sheet.title_)
+        {
+            return true;
+        }
+
+        ++entry;
+    }
+
+    return false;
+}
+
+std::size_t calculation_engine::sheet_index(const worksheet_impl &sheet) const
+{
+    for (std::size_t i = 0; i < sheets_.size(); ++i)
+    {
+        if (sheets_[i].sheet == &sheet)
+        {
+            return i;
+        }
+    }
+
+    return formula_range::invalid_sheet;
+}
+
+void calculation_engine::build(workbook_impl &workbook)
+{
+    // formulas which didn't change keep their compiled code and whether they are dirty
+    std::vector<cell_key> dirty_keys;
+    std::unordered_map<cell_key, formula_node> previous;
+
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+        const auto node_key = key(nodes_[i].sheet, nodes_[i].column, nodes_[i].row);
+
+        if (dirty_[i])
+        {
+            dirty_keys.push_back(node_key);
+        }
+
+        previous.emplace(node_key, std::move(nodes_[i]));
+    }
+
+    dirty_keys.insert(dirty_keys.end(), changed_formulas_.begin(), changed_formulas_.end());
+
+    sheets_.clear();
+    nodes_.clear();
+    node_at_.clear();
+    cell_readers_.clear();
+    range_readers_.clear();
+
+    for (auto &sheet : workbook.worksheets_)
+    {
+        sheets_.push_back({&sheet, sheet.id_, sheet.title_});
+        sheet.calculation_engine_ = this;
+    }
+
+    for (std::size_t sheet = 0; sheet < sheets_.size(); ++sheet)
+    {
+        const auto &cells = sheets_[sheet].sheet->cell_map_;
+
+        for (const auto &cell : cells)
+        {
+            const auto formula = cells.find_formula(cell);
+
+            if (formula == nullptr)
+            {
+                continue;
+            }
+
+            formula_node node;
+            node.sheet = sheet;
+            node.column = cell.column_.index;
+            node.row = cell.row_;
+            node.text = *formula;
+
+            const auto node_key = key(sheet, node.column, node.row);
+            auto match = previous.find(node_key);
+
+            if (match != previous.end() && match->second.text == node.text)
+            {
+                node.formula = std::move(match->second.formula);
+                node.compiled = match->second.compiled;
+            }
+            else
+            {
+                try
+                {
+                    node.formula = compile_formula(node.text);
+                    node.compiled = true;
+                }
+                catch (const xlnt::exception &)
+                {
+                    node.compiled = false;
+                }
+            }
+
+            for (const auto &reference : node.formula.references)
+            {
+                auto range = reference.range;
+                range.sheet = sheet;
+
+                if (!reference.sheet.empty())
+                {
+                    auto named = std::find_if(sheets_.begin(), sheets_.end(), [&reference](const sheet_entry &entry) {
+                        return equal_ignoring_case(entry.title, reference.sheet);
+                    });
+
+                    range.sheet = named == sheets_.end() ? formula_range::invalid_sheet
+                                                         : static_cast<std::size_t>(named - sheets_.begin());
+                }
+
+                node.ranges.push_back(range);
+            }
+
+            node.cost = node.formula.code.size();
+
+            for (const auto &range : node.ranges)
+            {
+                node.cost += cells_in(range);
+            }
+
+            node_at_[node_key] = nodes_.size();
+            nodes_.push_back(std::move(node));
+        }
+    }
+
+    for (std::size_t index = 0; index < nodes_.size(); ++index)
+    {
+        const auto &node = nodes_[index];
+
+        for (std::size_t i = 0; i < node.ranges.size(); ++i)
+        {
+            add_reader(node.ranges[i], node.formula.references[i].is_range, index);
+        }
+    }
+
+    dirty_.assign(nodes_.size(), calculate_all_);
+
+    for (auto dirty_key : dirty_keys)
+    {
+        auto match = node_at_.find(dirty_key);
+
+        if (match != node_at_.end())
+        {
+            dirty_[match->second] = true;
+        }
+    }
+
+    changed_formulas_.clear();
+    rebuild_ = false;
+}
+
+void calculation_engine::add_reader(const formula_range &range, bool is_range, std::size_t node)
+{
+    if (range.sheet == formula_range::invalid_sheet)
+    {
+        return;
+    }
+
+    if (!is_range)
+    {
+        auto &readers = cell_readers_[key(range.sheet, range.first_column, range.first_row)];
+
+        if (readers.empty() || readers.back() != node)
+        {
+            readers.push_back(node);
+        }
+
+        return;
+    }
+
+    for (auto block = range.first_column >> 6; block <= range.last_column >> 6; ++block)
+    {
+        range_readers_[block_key(range.sheet, block)].emplace_back(range, node);
+    }
+}
+
+template <typename F>
+void calculation_engine::for_each_reader(std::size_t sheet, column_t::index_t column, row_t row, F f) const
+{
+    auto cell_match = cell_readers_.find(key(sheet, column, row));
+
+    if (cell_match != cell_readers_.end())
+    {
+        for (auto reader : cell_match->second)
+        {
+            f(reader);
+        }
+    }
+
+    auto range_match = range_readers_.find(block_key(sheet, column >> 6));
+
+    if (range_match != range_readers_.end())
+    {
+        for (const auto &reader : range_match->second)
+        {
+            if (reader.first.contains(sheet, column, row))
+            {
+                f(reader.second);
+            }
+        }
+    }
+}
+
+void calculation_engine::mark_readers(std::size_t sheet, column_t::index_t column, row_t row)
+{
+    for_each_reader(sheet, column, row, [this](std::size_t reader) {
+        dirty_[reader] = true;
+    });
+}
+
+std::size_t calculation_engine::cells_in(const formula_range &range) const
+{
+    if (range.sheet >= sheets_.size() || sheets_[range.sheet].sheet->cell_map_.empty())
+    {
+        return 0;
+    }
+
+    // whole columns and rows only cost as much as the part of the worksheet which has cells
+    const auto &bounds = sheets_[range.sheet].sheet->cell_map_.bounds();
+    const auto first_column = std::max(range.first_column, bounds.first_column);
+    const auto last_column = std::min(range.last_column, bounds.last_column);
+    const auto first_row = std::max(range.first_row, bounds.first_row);
+    const auto last_row = std::min(range.last_row, bounds.last_row);
+
+    if (first_column > last_column || first_row > last_row)
+    {
+        return 0;
+    }
+
+    return static_cast<std::size_t>(last_column - first_column + 1) * static_cast<std::size_t>(last_row - first_row + 1);
+}
+
+void calculation_engine::prepare_concurrent_reads(const workbook &wb) const
+{
+    // reading cells must not modify anything shared once several threads read them,
+    // so lazily decoded shared strings and cached bounds are loaded beforehand
+    wb.load_pending_shared_strings(0, wb.d_->shared_strings_.size());
+
+    for (const auto &entry : sheets_)
+    {
+        if (!entry.sheet->cell_map_.empty())
+        {
+            entry.sheet->cell_map_.bounds();
+        }
+    }
+}
+
+formula_value calculation_engine::evaluate(const formula_node &node, std::vector<formula_value> &stack) const
+{
+    using opcode = formula_instruction::opcode;
+
+    stack.clear();
+
+    for (const auto &instruction : node.formula.code)
+    {
+        switch (instruction.op)
+        {
+        case opcode::push_constant:
+            stack.push_back(node.formula.constants[instruction.operand]);
+            break;
+
+        case opcode::load_cell:
+        case opcode::load_range:
+            // cells are loaded as ranges of one cell, so that functions can tell references from values
+            stack.push_back(formula_value::from_range(node.ranges[instruction.operand]));
+            break;
+
+        case opcode::negate:
+        case opcode::percent: {
+            const auto operand = scalar(stack.back());
+            double number = 0;
+            formula_error error;
+
+            if (!to_number(operand, number, error))
+            {
+                stack.back() = formula_value::from_error(error);
+            }
+            else
+            {
+                stack.back() = formula_value::from_number(instruction.op == opcode::negate ? -number : number / 100);
+            }
+
+            break;
+        }
+
+        case opcode::call: {
+            const auto count = static_cast<std::size_t>(instruction.operand >> 16);
+            const auto function = static_cast<formula_function>(instruction.operand & 0xFFFF);
+            const auto arguments = stack.data() + (stack.size() - count);
+
+            const auto unknown_sheet = std::any_of(arguments, arguments + count, [](const formula_value &argument) {
+                return argument.type == formula_value::value_type::range && argument.range.sheet == formula_range::invalid_sheet;
+            });
+
+            auto result = unknown_sheet ? formula_value::from_error(formula_error::ref)
+                                        : call_function(function, arguments, count, *this);
+
+            stack.resize(stack.size() - count);
+            stack.push_back(std::move(result));
+            break;
+        }
+
+        default: {
+            const auto rhs = scalar(stack.back());
+            stack.pop_back();
+            stack.back() = binary_operation(instruction.op, scalar(stack.back()), rhs);
+            break;
+        }
+        }
+    }
+
+    return stack.empty() ? formula_value() : scalar(stack.back());
+}
+
+formula_value calculation_engine::value_at(const formula_range &range, std::size_t row_offset, std::size_t column_offset) const
+{
+    if (range.sheet >= sheets_.size())
+    {
+        return formula_value::from_error(formula_error::ref);
+    }
+
+    const auto &sheet = *sheets_[range.sheet].sheet;
+    const auto cell = sheet.cell_map_.find(static_cast<column_t::index_t>(range.first_column + column_offset),
+        static_cast<row_t>(range.first_row + row_offset));
+
+    return cell == nullptr ? formula_value() : cell_value(sheet, *cell);
+}
+
+void calculation_engine::for_each_value(const formula_range &range, const visitor &visit) const
+{
+    if (range.sheet >= sheets_.size())
+    {
+        return;
+    }
+
+    const auto &sheet = *sheets_[range.sheet].sheet;
+    const auto &cells = sheet.cell_map_;
+
+    if (cells.empty())
+    {
+        return;
+    }
+
+    // whole columns and rows are only visited where the worksheet has cells
+    const auto &bounds = cells.bounds();
+    const auto first_row = std::max(range.first_row, bounds.first_row);
+    const auto last_row = std::min(range.last_row, bounds.last_row);
+
+    for (auto row = first_row; row >= first_row && row <= last_row; ++row)
+    {
+        const auto entries = cells.row(row);
+
+        if (entries == nullptr)
+        {
+            continue;
+        }
+
+        auto entry = std::lower_bound(entries->begin(), entries->end(), range.first_column,
+            [](const cell_store::entry &current, column_t::index_t column) { return current.first < column; });
+
+        for (; entry != entries->end() && entry->first <= range.last_column; ++entry)
+        {
+            if (entry->second->type_ == cell_type::empty)
+            {
+                continue;
+            }
+
+            if (!visit(row - range.first_row, entry->first - range.first_column, cell_value(sheet, *entry->second)))
+            {
+                return;
+            }
+        }
+    }
+}
+
+bool calculation_engine::aggregate_numbers(const formula_range &range, number_aggregate &result, formula_error &error) const
+{
+    if (range.sheet >= sheets_.size())
+    {
+        return true;
+    }
+
+    const auto &sheet = *sheets_[range.sheet].sheet;
+    const auto &cells = sheet.cell_map_;
+
+    if (cells.empty())
+    {
+        return true;
+    }
+
+    // reads the numbers straight from the rows of the cell store, without
+    // converting each cell to a formula_value and calling a visitor for it
+    const auto &bounds = cells.bounds();
+    const auto first_row = std::max(range.first_row, bounds.first_row);
+    const auto last_row = std::min(range.last_row, bounds.last_row);
+    const auto whole_rows = range.first_column <= bounds.first_column && range.last_column >= bounds.last_column;
+
+    for (auto row = first_row; row >= first_row && row <= last_row; ++row)
+    {
+        const auto entries = cells.row(row);
+
+        if (entries == nullptr)
+        {
+            continue;
+        }
+
+        auto entry = entries->begin();
+        auto end = entries->end();
+
+        if (!whole_rows)
+        {
+            const auto before = [](const cell_store::entry &current, column_t::index_t column) { return current.first < column; };
+            entry = std::lower_bound(entry, end, range.first_column, before);
+            end = std::lower_bound(entry, end, range.last_column + 1, before);
+        }
+
+        for (; entry != end; ++entry)
+        {
+            const auto &cell = *entry->second;
+
+            if (cell.type_ == cell_type::number || cell.type_ == cell_type::date)
+            {
+                result.add(cell.value_numeric_);
+            }
+            else if (cell.type_ == cell_type::error)
+            {
+                error = cell_value(sheet, cell).error;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+formula_value calculation_engine::cell_value(const worksheet_impl &sheet, const cell_impl &cell) const
+{
+    switch (cell.type_)
+    {
+    case cell_type::empty:
+        return formula_value();
+    case cell_type::boolean:
+        return formula_value::from_boolean(cell.value_numeric_ != 0.0);
+    case cell_type::date:
+    case cell_type::number:
+        return formula_value::from_number(cell.value_numeric_);
+    case cell_type::shared_string:
+        return formula_value::from_string(workbook_->shared_string_text(static_cast<std::size_t>(cell.value_numeric_)));
+    case cell_type::error: {
+        const auto text = sheet.cell_map_.find_text(cell);
+        auto error = formula_error::value;
+
+        if (text != nullptr)
+        {
+            parse_error(text->plain_text(), error);
+        }
+
+        return formula_value::from_error(error);
+    }
+    case cell_type::inline_string:
+    case cell_type::formula_string: {
+        const auto text = sheet.cell_map_.find_text(cell);
+        return formula_value::from_string(text == nullptr ? std::string() : text->plain_text());
+    }
+    }
+
+    return formula_value();
+}
+
+void calculation_engine::store(const formula_node &node, const formula_value &value)
+{
+    auto &cells = sheets_[node.sheet].sheet->cell_map_;
+    auto cell = cells.find(node.column, node.row);
+
+    if (cell == nullptr)
+    {
+        return;
+    }
+
+    cells.release_shared_string(*cell);
+
+    switch (value.type)
+    {
+    case formula_value::value_type::string:
+        cell->type_ = cell_type::formula_string;
+        cells.text(*cell).plain_text(value.string, false);
+        return;
+    case formula_value::value_type::error:
+        cell->type_ = cell_type::error;
+        cells.text(*cell).plain_text(error_text(value.error), false);
+        return;
+    case formula_value::value_type::boolean:
+        cell->type_ = cell_type::boolean;
+        cell->value_numeric_ = value.number;
+        break;
+    case formula_value::value_type::number:
+        // keeps showing dates, e.g. of =A1+1 where A1 is a date
+        cell->type_ = cell->type_ == cell_type::date ? cell_type::date : cell_type::number;
+        cell->value_numeric_ = value.number;
+        break;
+    case formula_value::value_type::blank:
+    case formula_value::value_type::range:
+        // a reference to an empty cell evaluates to 0
+        cell->type_ = cell_type::number;
+        cell->value_numeric_ = 0;
+        break;
+    }
+
+    cells.clear_text(*cell);
+}
+
+} // namespace detail
+} // namespace xlnt
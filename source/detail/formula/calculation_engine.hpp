@@ -0,0 +1,172 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <xlnt/cell/index_types.hpp>
+#include <detail/formula/formula_functions.hpp>
+#include <detail/formula/formula_parser.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+
+class workbook;
+
+namespace detail {
+
+struct cell_impl;
+struct workbook_impl;
+struct worksheet_impl;
+
+/// <summary>
+/// Evaluates the formulas of a workbook and stores their results as the cached values of their cells,
+/// which are written by xlsx_producer. The formulas are compiled once into a dependency graph of the
+/// cells and ranges they read. After the first calculation, only the formulas which read a changed
+/// cell, directly or through other formulas, are evaluated again. The formulas are evaluated level by
+/// level, each after the formulas it reads, and the formulas of a large level on several threads.
+/// Created by workbook::calculate() and owned by the workbook_impl.
+/// </summary>
+class XLNT_API_INTERNAL calculation_engine : public formula_context
+{
+public:
+    /// <summary>
+    /// Evaluates all formulas of wb whose result may have changed since the last calculation.
+    /// </summary>
+    void calculate(const workbook &wb);
+
+    /// <summary>
+    /// Called before the value of the cell at column and row of sheet changes.
+    /// </summary>
+    void value_changed(const worksheet_impl &sheet, column_t::index_t column, row_t row);
+
+    /// <summary>
+    /// Called when the formula of the cell at column and row of sheet is set or cleared.
+    /// </summary>
+    void formula_changed(const worksheet_impl &sheet, column_t::index_t column, row_t row);
+
+    /// <summary>
+    /// Called when cells were moved or removed, so that the whole workbook is calculated again.
+    /// </summary>
+    void invalidate();
+
+    formula_value value_at(const formula_range &range, std::size_t row_offset, std::size_t column_offset) const override;
+
+    void for_each_value(const formula_range &range, const visitor &visit) const override;
+
+    bool aggregate_numbers(const formula_range &range, number_aggregate &result, formula_error &error) const override;
+
+private:
+    using cell_key = std::uint64_t;
+
+    /// <summary>
+    /// A cell with a formula.
+    /// </summary>
+    struct formula_node
+    {
+        std::size_t sheet = 0;
+        column_t::index_t column = 1;
+        row_t row = 1;
+
+        std::string text;
+        compiled_formula formula;
+
+        // false if the formula can't be evaluated, its cached value is kept
+        bool compiled = false;
+
+        // the areas of formula.references on the worksheets of this workbook
+        std::vector<formula_range> ranges;
+
+        // roughly the work of evaluating the formula, the instructions and the cells it reads
+        std::size_t cost = 0;
+    };
+
+    /// <summary>
+    /// A worksheet as it was when the graph was built, to notice added, removed and renamed worksheets.
+    /// </summary>
+    struct sheet_entry
+    {
+        worksheet_impl *sheet = nullptr;
+        std::size_t id = 0;
+        std::string title;
+    };
+
+    static cell_key key(std::size_t sheet, column_t::index_t column, row_t row);
+    static cell_key block_key(std::size_t sheet, column_t::index_t column);
+
+    bool sheets_changed(workbook_impl &workbook) const;
+    std::size_t sheet_index(const worksheet_impl &sheet) const;
+
+    void build(workbook_impl &workbook);
+    void add_reader(const formula_range &range, bool is_range, std::size_t node);
+
+    /// <summary>
+    /// Calls f with the index of each formula node which reads the cell at column and row of sheet.
+    /// </summary>
+    template <typename F>
+    void for_each_reader(std::size_t sheet, column_t::index_t column, row_t row, F f) const;
+
+    void mark_readers(std::size_t sheet, column_t::index_t column, row_t row);
+
+    /// <summary>
+    /// Sets the formulas of circular references among the dirty nodes in pending to 0 and returns
+    /// the nodes reading them which can now be evaluated, as counted by unresolved.
+    /// </summary>
+    std::vector<std::size_t> resolve_circular(const std::vector<std::size_t> &pending, std::vector<std::size_t> &unresolved);
+
+    std::size_t cells_in(const formula_range &range) const;
+    void prepare_concurrent_reads(const workbook &wb) const;
+
+    formula_value evaluate(const formula_node &node, std::vector<formula_value> &stack) const;
+    formula_value cell_value(const worksheet_impl &sheet, const cell_impl &cell) const;
+    void store(const formula_node &node, const formula_value &value);
+
+    const workbook *workbook_ = nullptr;
+
+    std::vector<sheet_entry> sheets_;
+    std::vector<formula_node> nodes_;
+    std::unordered_map<cell_key, std::size_t> node_at_;
+
+    // the nodes reading a single cell, by the key of the cell
+    std::unordered_map<cell_key, std::vector<std::size_t>> cell_readers_;
+
+    // the nodes reading a range, by the keys of the blocks of 64 columns the range overlaps
+    std::unordered_map<cell_key, std::vector<std::pair<formula_range, std::size_t>>> range_readers_;
+
+    std::vector<bool> dirty_;
+
+    // the cells whose formulas changed since the graph was built
+    std::vector<cell_key> changed_formulas_;
+    bool rebuild_ = true;
+    bool calculate_all_ = true;
+};
+
+} // namespace detail
+} // namespace xlnt
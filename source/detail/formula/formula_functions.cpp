@@ -0,0 +1,1515 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
+
+#include <detail/formula/formula_functions.hpp>
+#include <detail/serialization/parsers.hpp>
+
+#define FMT_HEADER_ONLY
+#include <fmt/format.h>
+
+namespace {
+
+using xlnt::detail::formula_context;
+using xlnt::detail::formula_error;
+using xlnt::detail::formula_function;
+using xlnt::detail::formula_range;
+using xlnt::detail::formula_value;
+
+using value_type = formula_value::value_type;
+
+char to_upper(char c)
+{
+    return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+}
+
+std::string to_upper(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](char c) { return to_upper(c); });
+    return text;
+}
+
+std::string to_lower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return text;
+}
+
+// matches text against pattern case-insensitively, where * matches any characters,
+// ? matches one character and ~ escapes the next character of pattern
+bool wildcard_match(const std::string &pattern, std::size_t p, const std::string &text, std::size_t t)
+{
+    while (p < pattern.size())
+    {
+        if (pattern[p] == '*')
+        {
+            for (auto next = t; next <= text.size(); ++next)
+            {
+                if (wildcard_match(pattern, p + 1, text, next))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        if (t >= text.size())
+        {
+            return false;
+        }
+
+        if (pattern[p] == '~' && p + 1 < pattern.size())
+        {
+            ++p;
+        }
+        else if (pattern[p] == '?')
+        {
+            ++p;
+            ++t;
+            continue;
+        }
+
+        if (to_upper(pattern[p]) != to_upper(text[t]))
+        {
+            return false;
+        }
+
+        ++p;
+        ++t;
+    }
+
+    return t == text.size();
+}
+
+bool wildcard_match(const std::string &pattern, const std::string &text)
+{
+    return wildcard_match(pattern, 0, text, 0);
+}
+
+// the number of code points of UTF-8 text
+std::size_t text_length(const std::string &text)
+{
+    return static_cast<std::size_t>(std::count_if(text.begin(), text.end(),
+        [](char c) { return (static_cast<unsigned char>(c) & 0xC0) != 0x80; }));
+}
+
+// the byte offset of the code point at index of UTF-8 text, or its size if it is shorter
+std::size_t text_offset(const std::string &text, std::size_t index)
+{
+    std::size_t offset = 0;
+
+    while (offset < text.size())
+    {
+        if ((static_cast<unsigned char>(text[offset]) & 0xC0) != 0x80)
+        {
+            if (index == 0)
+            {
+                return offset;
+            }
+
+            --index;
+        }
+
+        ++offset;
+    }
+
+    return offset;
+}
+
+// rounds away the binary representation error of number, which Excel shows with 15 significant digits
+double significant_digits(double number)
+{
+    if (number == 0.0 || !std::isfinite(number))
+    {
+        return number;
+    }
+
+    const auto exponent = static_cast<int>(std::floor(std::log10(std::fabs(number))));
+    const auto scale = std::pow(10.0, 14 - exponent);
+    const auto scaled = std::round(number * scale);
+
+    return std::isfinite(scaled) ? scaled / scale : number;
+}
+
+formula_value number_result(double number)
+{
+    return std::isfinite(number) ? formula_value::from_number(number) : formula_value::from_error(formula_error::num);
+}
+
+bool to_boolean(const formula_value &value, bool &result, formula_error &error)
+{
+    switch (value.type)
+    {
+    case value_type::blank:
+        result = false;
+        return true;
+    case value_type::number:
+    case value_type::boolean:
+        result = value.number != 0.0;
+        return true;
+    case value_type::string: {
+        const auto upper = to_upper(value.string);
+
+        if (upper == "TRUE" || upper == "FALSE")
+        {
+            result = upper == "TRUE";
+            return true;
+        }
+
+        error = formula_error::value;
+        return false;
+    }
+    case value_type::error:
+        error = value.error;
+        return false;
+    case value_type::range:
+        error = formula_error::value;
+        return false;
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Converts arguments to scalar numbers, text and booleans and reports the first error.
+/// </summary>
+class arguments
+{
+public:
+    arguments(formula_value *values, std::size_t count, const formula_context &context)
+        : values_(values), count_(count), context_(context)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return count_;
+    }
+
+    formula_value &operator[](std::size_t index)
+    {
+        return values_[index];
+    }
+
+    formula_value scalar(std::size_t index) const
+    {
+        return context_.scalar(values_[index]);
+    }
+
+    bool number(std::size_t index, double &result)
+    {
+        return xlnt::detail::to_number(scalar(index), result, error);
+    }
+
+    // the number at index or fallback if the argument is missing or blank
+    bool number(std::size_t index, double fallback, double &result)
+    {
+        if (index >= count_ || values_[index].type == value_type::blank)
+        {
+            result = fallback;
+            return true;
+        }
+
+        return number(index, result);
+    }
+
+    bool boolean(std::size_t index, bool &result)
+    {
+        return to_boolean(scalar(index), result, error);
+    }
+
+    bool text(std::size_t index, std::string &result)
+    {
+        auto value = scalar(index);
+
+        if (value.is_error())
+        {
+            error = value.error;
+            return false;
+        }
+
+        result = xlnt::detail::to_text(value);
+        return true;
+    }
+
+    // the argument as a range, where a scalar is treated like a range of one cell
+    bool is_range(std::size_t index) const
+    {
+        return values_[index].type == value_type::range;
+    }
+
+    formula_value failure() const
+    {
+        return formula_value::from_error(error);
+    }
+
+    /// <summary>
+    /// Adds the numbers of the arguments to result like SUM: numbers in ranges and all direct
+    /// arguments which can be converted to numbers, except blanks. Stops at the first error.
+    /// </summary>
+    bool aggregate_numbers(xlnt::detail::number_aggregate &result)
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            const auto &argument = values_[i];
+
+            if (argument.type == value_type::range)
+            {
+                if (!context_.aggregate_numbers(argument.range, result, error))
+                {
+                    return false;
+                }
+            }
+            else if (argument.type != value_type::blank)
+            {
+                double number = 0;
+
+                if (!xlnt::detail::to_number(argument, number, error))
+                {
+                    return false;
+                }
+
+                result.add(number);
+            }
+        }
+
+        return true;
+    }
+
+    formula_error error = formula_error::value;
+
+private:
+    formula_value *values_;
+    std::size_t count_;
+    const formula_context &context_;
+};
+
+/// <summary>
+/// A condition of SUMIF, COUNTIF and AVERAGEIF like ">5", "<>a" or "b*".
+/// </summary>
+class criterion
+{
+public:
+    explicit criterion(const formula_value &value)
+    {
+        if (value.type != value_type::string)
+        {
+            operand_ = value.type == value_type::blank ? formula_value::from_string(std::string()) : value;
+            return;
+        }
+
+        auto text = value.string;
+        static const std::pair<const char *, comparison> prefixes[] = {{"<=", comparison::less_equal},
+            {">=", comparison::greater_equal}, {"<>", comparison::not_equal}, {"<", comparison::less},
+            {">", comparison::greater}, {"=", comparison::equal}};
+
+        for (const auto &prefix : prefixes)
+        {
+            const auto length = std::char_traits<char>::length(prefix.first);
+
+            if (text.compare(0, length, prefix.first) == 0)
+            {
+                comparison_ = prefix.second;
+                text.erase(0, length);
+                break;
+            }
+        }
+
+        double number = 0;
+        formula_error error;
+        const auto upper = to_upper(text);
+
+        if (!text.empty() && xlnt::detail::to_number(formula_value::from_string(text), number, error))
+        {
+            operand_ = formula_value::from_number(number);
+        }
+        else if (upper == "TRUE" || upper == "FALSE")
+        {
+            operand_ = formula_value::from_boolean(upper == "TRUE");
+        }
+        else
+        {
+            operand_ = formula_value::from_string(text);
+        }
+    }
+
+    bool matches(const formula_value &value) const
+    {
+        if (value.is_error() || value.type == value_type::range)
+        {
+            return false;
+        }
+
+        // an empty operand matches blank cells, "<>" matches all others
+        if (operand_.type == value_type::string && operand_.string.empty())
+        {
+            const auto is_blank = value.type == value_type::blank
+                || (value.type == value_type::string && value.string.empty());
+
+            return comparison_ == comparison::not_equal ? !is_blank
+                : comparison_ == comparison::equal ? is_blank : false;
+        }
+
+        if (value.type != operand_.type)
+        {
+            return comparison_ == comparison::not_equal;
+        }
+
+        if (operand_.type == value_type::string && (comparison_ == comparison::equal || comparison_ == comparison::not_equal))
+        {
+            return wildcard_match(operand_.string, value.string) == (comparison_ == comparison::equal);
+        }
+
+        const auto order = xlnt::detail::compare_values(value, operand_);
+
+        switch (comparison_)
+        {
+        case comparison::equal:
+            return order == 0;
+        case comparison::not_equal:
+            return order != 0;
+        case comparison::less:
+            return order < 0;
+        case comparison::less_equal:
+            return order <= 0;
+        case comparison::greater:
+            return order > 0;
+        case comparison::greater_equal:
+            return order >= 0;
+        }
+
+        return false;
+    }
+
+private:
+    enum class comparison
+    {
+        equal,
+        not_equal,
+        less,
+        less_equal,
+        greater,
+        greater_equal
+    };
+
+    comparison comparison_ = comparison::equal;
+    formula_value operand_;
+};
+
+/// <summary>
+/// Implements SUMIF, COUNTIF and AVERAGEIF: calls f with the value of each cell of target whose
+/// cell at the same offset in range matches test. Returns the number of matches.
+/// </summary>
+template <typename F>
+std::size_t for_each_match(const formula_context &context, const formula_range &range, const criterion &test,
+    const formula_range &target, bool same_range, F f)
+{
+    std::size_t matches = 0;
+    std::size_t non_blank = 0;
+
+    context.for_each_value(range, [&](std::size_t row, std::size_t column, const formula_value &value) {
+        ++non_blank;
+
+        if (test.matches(value))
+        {
+            ++matches;
+
+            f(same_range ? value : context.value_at(target, row, column));
+        }
+
+        return true;
+    });
+
+    if (test.matches(formula_value()))
+    {
+        // blank cells aren't visited, so count them separately and find the matching cells
+        // of the target which aren't blank
+        matches += range.width() * range.height() - non_blank;
+
+        if (!same_range)
+        {
+            auto shifted = target;
+            shifted.last_row = static_cast<xlnt::row_t>(shifted.first_row + range.height() - 1);
+            shifted.last_column = static_cast<xlnt::column_t::index_t>(shifted.first_column + range.width() - 1);
+
+            context.for_each_value(shifted, [&](std::size_t row, std::size_t column, const formula_value &value) {
+                if (context.value_at(range, row, column).type == value_type::blank)
+                {
+                    f(value);
+                }
+
+                return true;
+            });
+        }
+    }
+
+    return matches;
+}
+
+// whether lookup and value are equal for an exact match of VLOOKUP, HLOOKUP and MATCH
+bool lookup_equal(const formula_value &lookup, const formula_value &value)
+{
+    if (lookup.type != value.type)
+    {
+        return false;
+    }
+
+    if (lookup.type == value_type::string)
+    {
+        return wildcard_match(lookup.string, value.string);
+    }
+
+    return lookup.number == value.number;
+}
+
+/// <summary>
+/// Finds lookup in the cells of vector, a single row or column, and returns the offset of
+/// the matching cell or -1. match_type is 0 for an exact match, 1 for the largest value less
+/// than or equal to lookup in ascending values and -1 for the smallest value greater than or
+/// equal to lookup in descending values.
+/// </summary>
+long long find_in_vector(const formula_context &context, const formula_range &vector, const formula_value &lookup, int match_type)
+{
+    long long found = -1;
+    const auto by_row = vector.first_column == vector.last_column;
+
+    context.for_each_value(vector, [&](std::size_t row, std::size_t column, const formula_value &value) {
+        const auto offset = static_cast<long long>(by_row ? row : column);
+
+        if (match_type == 0)
+        {
+            if (lookup_equal(lookup, value))
+            {
+                found = offset;
+                return false;
+            }
+
+            return true;
+        }
+
+        // approximate matches only consider values of the same type and assume they are sorted
+        if (value.type != lookup.type)
+        {
+            return true;
+        }
+
+        const auto order = xlnt::detail::compare_values(value, lookup);
+
+        if ((match_type > 0 && order > 0) || (match_type < 0 && order < 0))
+        {
+            return false;
+        }
+
+        found = offset;
+        return order != 0;
+    });
+
+    return found;
+}
+
+formula_value lookup(arguments &args, const formula_context &context, bool vertical)
+{
+    auto lookup_value = args.scalar(0);
+
+    if (lookup_value.is_error())
+    {
+        return lookup_value;
+    }
+
+    if (!args.is_range(1))
+    {
+        return formula_value::from_error(formula_error::na);
+    }
+
+    double index = 0;
+    bool approximate = true;
+
+    if (!args.number(2, index) || (args.size() > 3 && args[3].type != value_type::blank && !args.boolean(3, approximate)))
+    {
+        return args.failure();
+    }
+
+    const auto table = args[1].range;
+    const auto offset = static_cast<std::size_t>(index) - 1;
+
+    if (index < 1)
+    {
+        return formula_value::from_error(formula_error::value);
+    }
+
+    if (offset >= (vertical ? table.width() : table.height()))
+    {
+        return formula_value::from_error(formula_error::ref);
+    }
+
+    auto vector = table;
+
+    if (vertical)
+    {
+        vector.last_column = vector.first_column;
+    }
+    else
+    {
+        vector.last_row = vector.first_row;
+    }
+
+    const auto found = find_in_vector(context, vector, lookup_value, approximate ? 1 : 0);
+
+    if (found < 0)
+    {
+        return formula_value::from_error(formula_error::na);
+    }
+
+    return vertical ? context.value_at(table, static_cast<std::size_t>(found), offset)
+                    : context.value_at(table, offset, static_cast<std::size_t>(found));
+}
+
+formula_value unary_math(arguments &args, double (*f)(double))
+{
+    double number = 0;
+
+    if (!args.number(0, number))
+    {
+        return args.failure();
+    }
+
+    return number_result(f(number));
+}
+
+enum class rounding
+{
+    nearest,
+    up,
+    down
+};
+
+formula_value round(arguments &args, rounding mode, double default_digits)
+{
+    double number = 0;
+    double digits = 0;
+
+    if (!args.number(0, number) || !args.number(1, default_digits, digits))
+    {
+        return args.failure();
+    }
+
+    const auto scale = std::pow(10.0, std::trunc(digits));
+    const auto scaled = significant_digits(number * scale);
+    const auto magnitude = mode == rounding::nearest ? std::round(std::fabs(scaled))
+        : mode == rounding::up ? std::ceil(std::fabs(scaled)) : std::floor(std::fabs(scaled));
+
+    return number_result(std::copysign(magnitude, number) / scale);
+}
+
+formula_value logical(arguments &args, const formula_context &context, bool is_and)
+{
+    auto result = is_and;
+    auto any = false;
+
+    const auto combine = [&](bool value) {
+        result = is_and ? (result && value) : (result || value);
+        any = true;
+    };
+
+    for (std::size_t i = 0; i < args.size(); ++i)
+    {
+        if (args.is_range(i))
+        {
+            auto failed = false;
+
+            context.for_each_value(args[i].range, [&](std::size_t, std::size_t, const formula_value &value) {
+                if (value.is_error())
+                {
+                    args.error = value.error;
+                    failed = true;
+                    return false;
+                }
+
+                // text in ranges is ignored
+                if (value.type == value_type::number || value.type == value_type::boolean)
+                {
+                    combine(value.number != 0.0);
+                }
+
+                return true;
+            });
+
+            if (failed)
+            {
+                return args.failure();
+            }
+        }
+        else if (args[i].type != value_type::blank)
+        {
+            bool value = false;
+
+            if (!args.boolean(i, value))
+            {
+                return args.failure();
+            }
+
+            combine(value);
+        }
+    }
+
+    return any ? formula_value::from_boolean(result) : formula_value::from_error(formula_error::value);
+}
+
+formula_value aggregate(arguments &args, formula_function function)
+{
+    xlnt::detail::number_aggregate numbers;
+
+    if (!args.aggregate_numbers(numbers))
+    {
+        return args.failure();
+    }
+
+    switch (function)
+    {
+    case formula_function::sum:
+        return number_result(numbers.sum);
+    case formula_function::product:
+        return number_result(numbers.count == 0 ? 0.0 : numbers.product);
+    case formula_function::min:
+        return number_result(numbers.count == 0 ? 0.0 : numbers.minimum);
+    case formula_function::max:
+        return number_result(numbers.count == 0 ? 0.0 : numbers.maximum);
+    default:
+        return numbers.count == 0 ? formula_value::from_error(formula_error::div0)
+                                  : number_result(numbers.sum / static_cast<double>(numbers.count));
+    }
+}
+
+formula_value count_values(arguments &args, const formula_context &context, formula_function function)
+{
+    double result = 0;
+
+    for (std::size_t i = 0; i < args.size(); ++i)
+    {
+        const auto &argument = args[i];
+
+        if (argument.type == value_type::range)
+        {
+            std::size_t non_blank = 0;
+
+            context.for_each_value(argument.range, [&](std::size_t, std::size_t, const formula_value &value) {
+                if (function == formula_function::count ? value.type == value_type::number
+                        : function == formula_function::counta ? true
+                        : !(value.type == value_type::string && value.string.empty()))
+                {
+                    ++non_blank;
+                }
+
+                return true;
+            });
+
+            result += static_cast<double>(function == formula_function::countblank
+                    ? argument.range.width() * argument.range.height() - non_blank
+                    : non_blank);
+        }
+        else if (function == formula_function::count)
+        {
+            double number = 0;
+            formula_error error;
+
+            if (argument.type != value_type::blank && xlnt::detail::to_number(argument, number, error))
+            {
+                result += 1;
+            }
+        }
+        else if (function == formula_function::counta)
+        {
+            result += argument.type == value_type::blank ? 0 : 1;
+        }
+        else
+        {
+            result += argument.type == value_type::blank || (argument.type == value_type::string && argument.string.empty()) ? 1 : 0;
+        }
+    }
+
+    return formula_value::from_number(result);
+}
+
+formula_value conditional_aggregate(arguments &args, const formula_context &context, formula_function function)
+{
+    if (!args.is_range(0))
+    {
+        return formula_value::from_error(formula_error::value);
+    }
+
+    const auto criteria = args.scalar(1);
+
+    if (criteria.is_error())
+    {
+        return criteria;
+    }
+
+    const auto range = args[0].range;
+    const auto has_target = args.size() > 2 && args[2].type != value_type::blank;
+
+    if (has_target && !args.is_range(2))
+    {
+        return formula_value::from_error(formula_error::value);
+    }
+
+    const auto target = has_target ? args[2].range : range;
+    double sum = 0;
+    std::size_t numbers = 0;
+    auto failed = false;
+
+    const auto matches = for_each_match(context, range, criterion(criteria), target, !has_target, [&](const formula_value &value) {
+        if (value.type == value_type::number)
+        {
+            sum += value.number;
+            ++numbers;
+        }
+        else if (value.is_error() && !failed)
+        {
+            args.error = value.error;
+            failed = true;
+        }
+    });
+
+    if (function == formula_function::countif)
+    {
+        return formula_value::from_number(static_cast<double>(matches));
+    }
+
+    if (failed)
+    {
+        return args.failure();
+    }
+
+    if (function == formula_function::sumif)
+    {
+        return number_result(sum);
+    }
+
+    return numbers == 0 ? formula_value::from_error(formula_error::div0) : number_result(sum / static_cast<double>(numbers));
+}
+
+formula_value sumproduct(arguments &args, const formula_context &context)
+{
+    std::vector<formula_range> ranges;
+
+    for (std::size_t i = 0; i < args.size(); ++i)
+    {
+        if (!args.is_range(i))
+        {
+            auto value = args.scalar(i);
+
+            if (value.is_error())
+            {
+                return value;
+            }
+
+            return formula_value::from_error(formula_error::value);
+        }
+
+        ranges.push_back(args[i].range);
+
+        if (ranges.back().width() != ranges.front().width() || ranges.back().height() != ranges.front().height())
+        {
+            return formula_value::from_error(formula_error::value);
+        }
+    }
+
+    // only cells where the first range has a number can contribute
+    double sum = 0;
+    auto failed = false;
+
+    context.for_each_value(ranges.front(), [&](std::size_t row, std::size_t column, const formula_value &first) {
+        if (first.is_error())
+        {
+            args.error = first.error;
+            failed = true;
+            return false;
+        }
+
+        auto product = first.type == value_type::number ? first.number : 0.0;
+
+        for (std::size_t i = 1; i < ranges.size() && product != 0.0; ++i)
+        {
+            const auto value = context.value_at(ranges[i], row, column);
+
+            if (value.is_error())
+            {
+                args.error = value.error;
+                failed = true;
+                return false;
+            }
+
+            product *= value.type == value_type::number ? value.number : 0.0;
+        }
+
+        sum += product;
+        return true;
+    });
+
+    return failed ? args.failure() : number_result(sum);
+}
+
+formula_value match(arguments &args, const formula_context &context)
+{
+    auto lookup_value = args.scalar(0);
+    double match_type = 1;
+
+    if (lookup_value.is_error())
+    {
+        return lookup_value;
+    }
+
+    if (!args.is_range(1) || !args.number(2, 1, match_type))
+    {
+        return args.is_range(1) ? args.failure() : formula_value::from_error(formula_error::na);
+    }
+
+    const auto vector = args[1].range;
+
+    if (vector.width() != 1 && vector.height() != 1)
+    {
+        return formula_value::from_error(formula_error::na);
+    }
+
+    const auto found = find_in_vector(context, vector, lookup_value, match_type > 0 ? 1 : match_type < 0 ? -1 : 0);
+
+    return found < 0 ? formula_value::from_error(formula_error::na) : formula_value::from_number(static_cast<double>(found + 1));
+}
+
+formula_value index(arguments &args, const formula_context &context)
+{
+    double row = 0;
+    double column = 0;
+
+    if (!args.number(1, row) || !args.number(2, 0, column))
+    {
+        return args.failure();
+    }
+
+    if (!args.is_range(0))
+    {
+        return row <= 1 && column <= 1 ? args.scalar(0) : formula_value::from_error(formula_error::ref);
+    }
+
+    const auto range = args[0].range;
+
+    // a single row or column can be indexed by one number
+    if (args.size() < 3 || args[2].type == value_type::blank)
+    {
+        if (range.height() == 1)
+        {
+            column = row;
+            row = 1;
+        }
+        else
+        {
+            column = 1;
+        }
+    }
+
+    if (row < 1 || column < 1)
+    {
+        // whole rows or columns aren't supported
+        return formula_value::from_error(formula_error::value);
+    }
+
+    if (static_cast<std::size_t>(row) > range.height() || static_cast<std::size_t>(column) > range.width())
+    {
+        return formula_value::from_error(formula_error::ref);
+    }
+
+    return context.value_at(range, static_cast<std::size_t>(row) - 1, static_cast<std::size_t>(column) - 1);
+}
+
+formula_value text_part(arguments &args, formula_function function)
+{
+    std::string text;
+    double start = 1;
+    double length = 1;
+
+    if (!args.text(0, text))
+    {
+        return args.failure();
+    }
+
+    if (function == formula_function::mid)
+    {
+        if (!args.number(1, start) || !args.number(2, length))
+        {
+            return args.failure();
+        }
+    }
+    else if (!args.number(1, 1, length))
+    {
+        return args.failure();
+    }
+
+    if (start < 1 || length < 0)
+    {
+        return formula_value::from_error(formula_error::value);
+    }
+
+    const auto characters = text_length(text);
+    auto first = static_cast<std::size_t>(start) - 1;
+    auto count = static_cast<std::size_t>(std::min(length, static_cast<double>(characters)));
+
+    if (function == formula_function::right)
+    {
+        first = characters - count;
+    }
+
+    const auto begin = text_offset(text, first);
+    const auto end = text_offset(text, first + count);
+
+    return formula_value::from_string(text.substr(begin, end - begin));
+}
+
+formula_value trim(arguments &args)
+{
+    std::string text;
+
+    if (!args.text(0, text))
+    {
+        return args.failure();
+    }
+
+    std::string result;
+
+    for (auto c : text)
+    {
+        if (c != ' ' || (!result.empty() && result.back() != ' '))
+        {
+            result.push_back(c);
+        }
+    }
+
+    if (!result.empty() && result.back() == ' ')
+    {
+        result.pop_back();
+    }
+
+    return formula_value::from_string(result);
+}
+
+formula_value concatenate(arguments &args, const formula_context &context, bool ranges)
+{
+    std::string result;
+
+    for (std::size_t i = 0; i < args.size(); ++i)
+    {
+        if (ranges && args.is_range(i))
+        {
+            auto failed = false;
+
+            context.for_each_value(args[i].range, [&](std::size_t, std::size_t, const formula_value &value) {
+                if (value.is_error())
+                {
+                    args.error = value.error;
+                    failed = true;
+                    return false;
+                }
+
+                result.append(xlnt::detail::to_text(value));
+                return true;
+            });
+
+            if (failed)
+            {
+                return args.failure();
+            }
+        }
+        else
+        {
+            std::string text;
+
+            if (!args.text(i, text))
+            {
+                return args.failure();
+            }
+
+            result.append(text);
+        }
+    }
+
+    return formula_value::from_string(result);
+}
+
+formula_value is_type(arguments &args, formula_function function)
+{
+    const auto value = args.scalar(0);
+
+    switch (function)
+    {
+    case formula_function::isblank:
+        return formula_value::from_boolean(value.type == value_type::blank);
+    case formula_function::iserror:
+        return formula_value::from_boolean(value.is_error());
+    case formula_function::isna:
+        return formula_value::from_boolean(value.is_error() && value.error == formula_error::na);
+    case formula_function::islogical:
+        return formula_value::from_boolean(value.type == value_type::boolean);
+    case formula_function::isnumber:
+        return formula_value::from_boolean(value.type == value_type::number);
+    default:
+        return formula_value::from_boolean(value.type == value_type::string);
+    }
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+bool find_function(const std::string &upper_case_name, formula_function_info &info)
+{
+    static const auto unlimited = static_cast<std::size_t>(255);
+    static const std::unordered_map<std::string, formula_function_info> functions = {
+        {"ABS", {formula_function::abs, 1, 1}},
+        {"AND", {formula_function::and_, 1, unlimited}},
+        {"AVERAGE", {formula_function::average, 1, unlimited}},
+        {"AVERAGEIF", {formula_function::averageif, 2, 3}},
+        {"CHOOSE", {formula_function::choose, 2, unlimited}},
+        {"COLUMNS", {formula_function::columns, 1, 1}},
+        {"CONCAT", {formula_function::concat, 1, unlimited}},
+        {"CONCATENATE", {formula_function::concatenate, 1, unlimited}},
+        {"COUNT", {formula_function::count, 1, unlimited}},
+        {"COUNTA", {formula_function::counta, 1, unlimited}},
+        {"COUNTBLANK", {formula_function::countblank, 1, 1}},
+        {"COUNTIF", {formula_function::countif, 2, 2}},
+        {"EXP", {formula_function::exp, 1, 1}},
+        {"FALSE", {formula_function::false_, 0, 0}},
+        {"HLOOKUP", {formula_function::hlookup, 3, 4}},
+        {"IF", {formula_function::if_, 2, 3}},
+        {"IFERROR", {formula_function::iferror, 2, 2}},
+        {"IFNA", {formula_function::ifna, 2, 2}},
+        {"INDEX", {formula_function::index, 2, 3}},
+        {"INT", {formula_function::int_, 1, 1}},
+        {"ISBLANK", {formula_function::isblank, 1, 1}},
+        {"ISERROR", {formula_function::iserror, 1, 1}},
+        {"ISLOGICAL", {formula_function::islogical, 1, 1}},
+        {"ISNA", {formula_function::isna, 1, 1}},
+        {"ISNUMBER", {formula_function::isnumber, 1, 1}},
+        {"ISTEXT", {formula_function::istext, 1, 1}},
+        {"LEFT", {formula_function::left, 1, 2}},
+        {"LEN", {formula_function::len, 1, 1}},
+        {"LN", {formula_function::ln, 1, 1}},
+        {"LOG", {formula_function::log, 1, 2}},
+        {"LOG10", {formula_function::log10, 1, 1}},
+        {"LOWER", {formula_function::lower, 1, 1}},
+        {"MATCH", {formula_function::match, 2, 3}},
+        {"MAX", {formula_function::max, 1, unlimited}},
+        {"MID", {formula_function::mid, 3, 3}},
+        {"MIN", {formula_function::min, 1, unlimited}},
+        {"MOD", {formula_function::mod, 2, 2}},
+        {"NA", {formula_function::na, 0, 0}},
+        {"NOT", {formula_function::not_, 1, 1}},
+        {"OR", {formula_function::or_, 1, unlimited}},
+        {"PI", {formula_function::pi, 0, 0}},
+        {"POWER", {formula_function::power, 2, 2}},
+        {"PRODUCT", {formula_function::product, 1, unlimited}},
+        {"RIGHT", {formula_function::right, 1, 2}},
+        {"ROUND", {formula_function::round, 2, 2}},
+        {"ROUNDDOWN", {formula_function::rounddown, 2, 2}},
+        {"ROUNDUP", {formula_function::roundup, 2, 2}},
+        {"ROWS", {formula_function::rows, 1, 1}},
+        {"SIGN", {formula_function::sign, 1, 1}},
+        {"SQRT", {formula_function::sqrt, 1, 1}},
+        {"SUM", {formula_function::sum, 1, unlimited}},
+        {"SUMIF", {formula_function::sumif, 2, 3}},
+        {"SUMPRODUCT", {formula_function::sumproduct, 1, unlimited}},
+        {"TRIM", {formula_function::trim, 1, 1}},
+        {"TRUE", {formula_function::true_, 0, 0}},
+        {"TRUNC", {formula_function::trunc, 1, 2}},
+        {"UPPER", {formula_function::upper, 1, 1}},
+        {"VALUE", {formula_function::value, 1, 1}},
+        {"VLOOKUP", {formula_function::vlookup, 3, 4}}};
+
+    auto match = functions.find(upper_case_name);
+
+    if (match == functions.end())
+    {
+        return false;
+    }
+
+    info = match->second;
+    return true;
+}
+
+formula_value formula_context::scalar(const formula_value &value) const
+{
+    if (value.type != formula_value::value_type::range)
+    {
+        return value;
+    }
+
+    if (value.range.sheet == formula_range::invalid_sheet)
+    {
+        return formula_value::from_error(formula_error::ref);
+    }
+
+    if (value.range.width() != 1 || value.range.height() != 1)
+    {
+        return formula_value::from_error(formula_error::value);
+    }
+
+    return value_at(value.range, 0, 0);
+}
+
+bool formula_context::aggregate_numbers(const formula_range &range, number_aggregate &result, formula_error &error) const
+{
+    auto succeeded = true;
+
+    for_each_value(range, [&](std::size_t, std::size_t, const formula_value &value) {
+        if (value.type == formula_value::value_type::number)
+        {
+            result.add(value.number);
+        }
+        else if (value.is_error())
+        {
+            error = value.error;
+            succeeded = false;
+        }
+
+        return succeeded;
+    });
+
+    return succeeded;
+}
+
+bool to_number(const formula_value &value, double &number, formula_error &error)
+{
+    switch (value.type)
+    {
+    case value_type::blank:
+        number = 0;
+        return true;
+    case value_type::number:
+    case value_type::boolean:
+        number = value.number;
+        return true;
+    case value_type::string: {
+        auto text = value.string;
+        text.erase(0, text.find_first_not_of(' '));
+        text.erase(text.find_last_not_of(' ') + 1);
+
+        const auto percent = !text.empty() && text.back() == '%';
+
+        if (percent)
+        {
+            text.pop_back();
+        }
+
+        std::size_t length = 0;
+
+        if (!text.empty() && parse(text, number, &length) == std::errc() && length == text.size() && std::isfinite(number))
+        {
+            if (percent)
+            {
+                number /= 100;
+            }
+
+            return true;
+        }
+
+        error = formula_error::value;
+        return false;
+    }
+    case value_type::error:
+        error = value.error;
+        return false;
+    case value_type::range:
+        error = formula_error::value;
+        return false;
+    }
+
+    return false;
+}
+
+std::string to_text(const formula_value &value)
+{
+    switch (value.type)
+    {
+    case value_type::number:
+        return fmt::format("{:.15G}", value.number);
+    case value_type::boolean:
+        return value.number != 0.0 ? "TRUE" : "FALSE";
+    case value_type::string:
+        return value.string;
+    case value_type::error:
+        return error_text(value.error);
+    case value_type::blank:
+    case value_type::range:
+        break;
+    }
+
+    return std::string();
+}
+
+int compare_values(const formula_value &lhs, const formula_value &rhs)
+{
+    // a blank is compared as the empty value of the type of the other side
+    const auto rank = [](const formula_value &value, const formula_value &other) {
+        const auto type = value.type == value_type::blank ? other.type : value.type;
+        return type == value_type::string ? 1 : type == value_type::boolean ? 2 : 0;
+    };
+
+    const auto lhs_rank = rank(lhs, rhs);
+    const auto rhs_rank = rank(rhs, lhs);
+
+    if (lhs_rank != rhs_rank)
+    {
+        return lhs_rank < rhs_rank ? -1 : 1;
+    }
+
+    if (lhs_rank == 1)
+    {
+        const auto lhs_text = to_upper(lhs.string);
+        const auto rhs_text = to_upper(rhs.string);
+
+        return lhs_text < rhs_text ? -1 : lhs_text == rhs_text ? 0 : 1;
+    }
+
+    return lhs.number < rhs.number ? -1 : lhs.number == rhs.number ? 0 : 1;
+}
+
+formula_value call_function(formula_function function, formula_value *values, std::size_t count, const formula_context &context)
+{
+    arguments args(values, count, context);
+    double number = 0;
+    double other = 0;
+
+    switch (function)
+    {
+    case formula_function::sum:
+    case formula_function::product:
+    case formula_function::min:
+    case formula_function::max:
+    case formula_function::average:
+        return aggregate(args, function);
+
+    case formula_function::count:
+    case formula_function::counta:
+    case formula_function::countblank:
+        return count_values(args, context, function);
+
+    case formula_function::sumif:
+    case formula_function::countif:
+    case formula_function::averageif:
+        return conditional_aggregate(args, context, function);
+
+    case formula_function::sumproduct:
+        return sumproduct(args, context);
+
+    case formula_function::abs:
+        return unary_math(args, [](double x) { return std::fabs(x); });
+    case formula_function::int_:
+        return unary_math(args, [](double x) { return std::floor(x); });
+    case formula_function::sign:
+        return unary_math(args, [](double x) { return x > 0 ? 1.0 : x < 0 ? -1.0 : 0.0; });
+    case formula_function::exp:
+        return unary_math(args, [](double x) { return std::exp(x); });
+    case formula_function::sqrt:
+        return unary_math(args, [](double x) { return x < 0 ? NAN : std::sqrt(x); });
+    case formula_function::ln:
+        return unary_math(args, [](double x) { return x <= 0 ? NAN : std::log(x); });
+    case formula_function::log10:
+        return unary_math(args, [](double x) { return x <= 0 ? NAN : std::log10(x); });
+
+    case formula_function::log:
+        if (!args.number(0, number) || !args.number(1, 10, other))
+        {
+            return args.failure();
+        }
+
+        if (other == 1)
+        {
+            return formula_value::from_error(formula_error::div0);
+        }
+
+        return number_result(number <= 0 || other <= 0 ? NAN : std::log(number) / std::log(other));
+
+    case formula_function::mod:
+        if (!args.number(0, number) || !args.number(1, other))
+        {
+            return args.failure();
+        }
+
+        if (other == 0)
+        {
+            return formula_value::from_error(formula_error::div0);
+        }
+
+        return number_result(number - other * std::floor(number / other));
+
+    case formula_function::power:
+        if (!args.number(0, number) || !args.number(1, other))
+        {
+            return args.failure();
+        }
+
+        if (number == 0 && other < 0)
+        {
+            return formula_value::from_error(formula_error::div0);
+        }
+
+        return number_result(std::pow(number, other));
+
+    case formula_function::pi:
+        return formula_value::from_number(3.14159265358979323846);
+
+    case formula_function::na:
+        return formula_value::from_error(formula_error::na);
+
+    case formula_function::round:
+        return round(args, rounding::nearest, 0);
+    case formula_function::roundup:
+        return round(args, rounding::up, 0);
+    case formula_function::rounddown:
+    case formula_function::trunc:
+        return round(args, rounding::down, 0);
+
+    case formula_function::true_:
+        return formula_value::from_boolean(true);
+    case formula_function::false_:
+        return formula_value::from_boolean(false);
+
+    case formula_function::and_:
+        return logical(args, context, true);
+    case formula_function::or_:
+        return logical(args, context, false);
+
+    case formula_function::not_: {
+        bool value = false;
+        return args.boolean(0, value) ? formula_value::from_boolean(!value) : args.failure();
+    }
+
+    case formula_function::if_: {
+        bool condition = false;
+
+        if (!args.boolean(0, condition))
+        {
+            return args.failure();
+        }
+
+        if (condition)
+        {
+            return args[1];
+        }
+
+        return count > 2 ? args[2] : formula_value::from_boolean(false);
+    }
+
+    case formula_function::iferror:
+    case formula_function::ifna: {
+        auto value = args.scalar(0);
+        const auto caught = value.is_error() && (function == formula_function::iferror || value.error == formula_error::na);
+
+        return caught ? args[1] : value;
+    }
+
+    case formula_function::isblank:
+    case formula_function::iserror:
+    case formula_function::islogical:
+    case formula_function::isna:
+    case formula_function::isnumber:
+    case formula_function::istext:
+        return is_type(args, function);
+
+    case formula_function::vlookup:
+        return lookup(args, context, true);
+    case formula_function::hlookup:
+        return lookup(args, context, false);
+    case formula_function::match:
+        return match(args, context);
+    case formula_function::index:
+        return index(args, context);
+
+    case formula_function::choose:
+        if (!args.number(0, number))
+        {
+            return args.failure();
+        }
+
+        if (number < 1 || number >= static_cast<double>(count))
+        {
+            return formula_value::from_error(formula_error::value);
+        }
+
+        return args[static_cast<std::size_t>(number)];
+
+    case formula_function::rows:
+    case formula_function::columns:
+        if (!args.is_range(0))
+        {
+            return formula_value::from_number(1);
+        }
+
+        return formula_value::from_number(static_cast<double>(
+            function == formula_function::rows ? args[0].range.height() : args[0].range.width()));
+
+    case formula_function::concatenate:
+        return concatenate(args, context, false);
+    case formula_function::concat:
+        return concatenate(args, context, true);
+
+    case formula_function::len: {
+        std::string text;
+        return args.text(0, text) ? formula_value::from_number(static_cast<double>(text_length(text))) : args.failure();
+    }
+
+    case formula_function::left:
+    case formula_function::right:
+    case formula_function::mid:
+        return text_part(args, function);
+
+    case formula_function::upper:
+    case formula_function::lower: {
+        std::string text;
+
+        if (!args.text(0, text))
+        {
+            return args.failure();
+        }
+
+        return formula_value::from_string(function == formula_function::upper ? to_upper(text) : to_lower(text));
+    }
+
+    case formula_function::trim:
+        return trim(args);
+
+    case formula_function::value:
+        return args.number(0, number) ? formula_value::from_number(number) : args.failure();
+    }
+
+    return formula_value::from_error(formula_error::name);
+}
+
+} // namespace detail
+} // namespace xlnt
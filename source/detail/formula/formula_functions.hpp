@@ -0,0 +1,200 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+
+#include <detail/formula/formula_value.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The worksheet functions which can be evaluated.
+/// </summary>
+enum class formula_function : std::uint16_t
+{
+    abs,
+    and_,
+    average,
+    averageif,
+    choose,
+    columns,
+    concat,
+    concatenate,
+    count,
+    counta,
+    countblank,
+    countif,
+    exp,
+    false_,
+    hlookup,
+    if_,
+    iferror,
+    ifna,
+    index,
+    int_,
+    isblank,
+    iserror,
+    islogical,
+    isna,
+    isnumber,
+    istext,
+    left,
+    len,
+    ln,
+    log,
+    log10,
+    lower,
+    match,
+    max,
+    mid,
+    min,
+    mod,
+    na,
+    not_,
+    or_,
+    pi,
+    power,
+    product,
+    right,
+    round,
+    rounddown,
+    roundup,
+    rows,
+    sign,
+    sqrt,
+    sum,
+    sumif,
+    sumproduct,
+    trim,
+    true_,
+    trunc,
+    upper,
+    value,
+    vlookup
+};
+
+struct formula_function_info
+{
+    formula_function function = formula_function::sum;
+    std::size_t min_arguments = 0;
+    std::size_t max_arguments = 0;
+};
+
+/// <summary>
+/// Sets info to the function called upper_case_name and returns true, or returns false if it isn't supported.
+/// </summary>
+XLNT_API_INTERNAL bool find_function(const std::string &upper_case_name, formula_function_info &info);
+
+/// <summary>
+/// The numbers of the arguments of SUM, PRODUCT, MIN, MAX and AVERAGE.
+/// </summary>
+struct number_aggregate
+{
+    double sum = 0.0;
+    double product = 1.0;
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -std::numeric_limits<double>::infinity();
+    std::size_t count = 0;
+
+    void add(double number)
+    {
+        sum += number;
+        product *= number;
+        minimum = number < minimum ? number : minimum;
+        maximum = number > maximum ? number : maximum;
+        ++count;
+    }
+};
+
+/// <summary>
+/// Gives functions access to the cells of the ranges passed to them.
+/// </summary>
+class XLNT_API_INTERNAL formula_context
+{
+public:
+    /// <summary>
+    /// Called with the offsets of a cell from the top left corner of a range and its value.
+    /// Returns false to stop visiting further cells.
+    /// </summary>
+    using visitor = std::function<bool(std::size_t row_offset, std::size_t column_offset, const formula_value &value)>;
+
+    virtual ~formula_context() = default;
+
+    /// <summary>
+    /// Returns the value of the cell at the given offsets from the top left corner of range.
+    /// </summary>
+    virtual formula_value value_at(const formula_range &range, std::size_t row_offset, std::size_t column_offset) const = 0;
+
+    /// <summary>
+    /// Calls visit for each cell of range which isn't empty, row by row.
+    /// </summary>
+    virtual void for_each_value(const formula_range &range, const visitor &visit) const = 0;
+
+    /// <summary>
+    /// Adds the numbers in the cells of range to result like SUM, which ignores text and booleans in ranges.
+    /// Returns false and sets error at the first error value. Uses for_each_value unless it's overridden
+    /// to read the cells more directly, since this is where large ranges are usually read.
+    /// </summary>
+    virtual bool aggregate_numbers(const formula_range &range, number_aggregate &result, formula_error &error) const;
+
+    /// <summary>
+    /// Returns value, or the value of the cell if it's a range of a single cell.
+    /// Larger ranges can't be used as a single value and result in #VALUE!.
+    /// </summary>
+    formula_value scalar(const formula_value &value) const;
+};
+
+/// <summary>
+/// Converts value to a number like Excel does for arithmetic. Returns false and sets error if it can't be converted.
+/// </summary>
+XLNT_API_INTERNAL bool to_number(const formula_value &value, double &number, formula_error &error);
+
+/// <summary>
+/// Converts value, which mustn't be an error or range, to text like Excel does for concatenation.
+/// </summary>
+XLNT_API_INTERNAL std::string to_text(const formula_value &value);
+
+/// <summary>
+/// Compares two values which aren't errors or ranges like Excel's comparison operators.
+/// Numbers are less than text, which is less than booleans, and text is compared case-insensitively.
+/// Returns a negative number, zero or a positive number.
+/// </summary>
+XLNT_API_INTERNAL int compare_values(const formula_value &lhs, const formula_value &rhs);
+
+/// <summary>
+/// Calls function with the count values starting at arguments, which may be modified.
+/// </summary>
+XLNT_API_INTERNAL formula_value call_function(formula_function function, formula_value *arguments,
+    std::size_t count, const formula_context &context);
+
+} // namespace detail
+} // namespace xlnt
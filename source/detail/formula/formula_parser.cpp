@@ -0,0 +1,628 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <cctype>
+
+#include <xlnt/utils/exceptions.hpp>
+#include <detail/formula/formula_functions.hpp>
+#include <detail/formula/formula_parser.hpp>
+#include <detail/serialization/parsers.hpp>
+
+namespace {
+
+using xlnt::detail::compiled_formula;
+using xlnt::detail::formula_instruction;
+using xlnt::detail::formula_reference;
+using xlnt::detail::formula_value;
+
+using opcode = formula_instruction::opcode;
+
+constexpr xlnt::column_t::index_t max_column = 16384;
+constexpr xlnt::row_t max_row = 1048576;
+
+bool is_word_character(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '$' || c == '\\';
+}
+
+/// <summary>
+/// Compiles a formula by recursive descent, one method per precedence level of Excel's operators.
+/// </summary>
+class formula_compiler
+{
+public:
+    explicit formula_compiler(const std::string &formula)
+        : formula_(formula)
+    {
+    }
+
+    compiled_formula compile()
+    {
+        parse_comparison();
+        skip_spaces();
+
+        if (position_ != formula_.size())
+        {
+            fail("unexpected character");
+        }
+
+        return std::move(result_);
+    }
+
+private:
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw xlnt::exception(message + " at position " + std::to_string(position_) + " of formula \"" + formula_ + "\"");
+    }
+
+    void skip_spaces()
+    {
+        while (position_ < formula_.size() && (formula_[position_] == ' ' || formula_[position_] == '\n' || formula_[position_] == '\r'))
+        {
+            ++position_;
+        }
+    }
+
+    char peek() const
+    {
+        return position_ < formula_.size() ? formula_[position_] : '\0';
+    }
+
+    bool match(char c)
+    {
+        if (peek() != c)
+        {
+            return false;
+        }
+
+        ++position_;
+        return true;
+    }
+
+    bool match(const char *text)
+    {
+        const auto length = std::char_traits<char>::length(text);
+
+        if (formula_.compare(position_, length, text) != 0)
+        {
+            return false;
+        }
+
+        position_ += length;
+        return true;
+    }
+
+    void emit(opcode op, std::uint32_t operand = 0)
+    {
+        formula_instruction instruction;
+        instruction.op = op;
+        instruction.operand = operand;
+        result_.code.push_back(instruction);
+    }
+
+    void emit_constant(formula_value value)
+    {
+        emit(opcode::push_constant, static_cast<std::uint32_t>(result_.constants.size()));
+        result_.constants.push_back(std::move(value));
+    }
+
+    void parse_comparison()
+    {
+        parse_concatenation();
+
+        while (true)
+        {
+            skip_spaces();
+            opcode op;
+
+            if (match("<="))
+                op = opcode::less_equal;
+            else if (match(">="))
+                op = opcode::greater_equal;
+            else if (match("<>"))
+                op = opcode::not_equal;
+            else if (match('<'))
+                op = opcode::less;
+            else if (match('>'))
+                op = opcode::greater;
+            else if (match('='))
+                op = opcode::equal;
+            else
+                return;
+
+            parse_concatenation();
+            emit(op);
+        }
+    }
+
+    void parse_concatenation()
+    {
+        parse_additive();
+
+        while (skip_spaces(), match('&'))
+        {
+            parse_additive();
+            emit(opcode::concatenate);
+        }
+    }
+
+    void parse_additive()
+    {
+        parse_multiplicative();
+
+        while (true)
+        {
+            skip_spaces();
+            const auto op = match('+') ? opcode::add : match('-') ? opcode::subtract : opcode::push_constant;
+
+            if (op == opcode::push_constant)
+            {
+                return;
+            }
+
+            parse_multiplicative();
+            emit(op);
+        }
+    }
+
+    void parse_multiplicative()
+    {
+        parse_power();
+
+        while (true)
+        {
+            skip_spaces();
+            const auto op = match('*') ? opcode::multiply : match('/') ? opcode::divide : opcode::push_constant;
+
+            if (op == opcode::push_constant)
+            {
+                return;
+            }
+
+            parse_power();
+            emit(op);
+        }
+    }
+
+    // unlike in mathematics, ^ is left associative and binds weaker than negation in Excel
+    void parse_power()
+    {
+        parse_unary();
+
+        while (skip_spaces(), match('^'))
+        {
+            parse_unary();
+            emit(opcode::power);
+        }
+    }
+
+    void parse_unary()
+    {
+        skip_spaces();
+
+        if (match('-'))
+        {
+            parse_unary();
+            emit(opcode::negate);
+        }
+        else if (match('+'))
+        {
+            parse_unary();
+        }
+        else
+        {
+            parse_primary();
+
+            while (skip_spaces(), match('%'))
+            {
+                emit(opcode::percent);
+            }
+        }
+    }
+
+    void parse_primary()
+    {
+        skip_spaces();
+        const auto c = peek();
+
+        if (match('('))
+        {
+            parse_comparison();
+            skip_spaces();
+
+            if (!match(')'))
+            {
+                fail("expected )");
+            }
+        }
+        else if (c == '"')
+        {
+            emit_constant(formula_value::from_string(parse_string()));
+        }
+        else if (c == '#')
+        {
+            parse_error_literal();
+        }
+        else if (c == '\'')
+        {
+            auto sheet = parse_quoted_sheet();
+
+            if (!match('!'))
+            {
+                fail("expected ! after sheet name");
+            }
+
+            parse_reference(std::move(sheet), read_word());
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+        {
+            parse_number_or_rows();
+        }
+        else if (is_word_character(c))
+        {
+            parse_word();
+        }
+        else
+        {
+            fail(c == '{' ? "array constants aren't supported" : "expected a value");
+        }
+    }
+
+    std::string parse_string()
+    {
+        std::string text;
+        ++position_;
+
+        while (true)
+        {
+            if (position_ >= formula_.size())
+            {
+                fail("unterminated string");
+            }
+
+            const auto next = formula_[position_++];
+
+            if (next == '"')
+            {
+                if (!match('"'))
+                {
+                    return text;
+                }
+            }
+
+            text.push_back(next);
+        }
+    }
+
+    std::string parse_quoted_sheet()
+    {
+        std::string sheet;
+        ++position_;
+
+        while (true)
+        {
+            if (position_ >= formula_.size())
+            {
+                fail("unterminated sheet name");
+            }
+
+            const auto next = formula_[position_++];
+
+            if (next == '\'')
+            {
+                if (!match('\''))
+                {
+                    return sheet;
+                }
+            }
+
+            sheet.push_back(next);
+        }
+    }
+
+    void parse_error_literal()
+    {
+        for (auto error : {xlnt::detail::formula_error::div0, xlnt::detail::formula_error::na,
+                 xlnt::detail::formula_error::name, xlnt::detail::formula_error::null,
+                 xlnt::detail::formula_error::num, xlnt::detail::formula_error::ref,
+                 xlnt::detail::formula_error::value})
+        {
+            if (match(xlnt::detail::error_text(error).c_str()))
+            {
+                emit_constant(formula_value::from_error(error));
+                return;
+            }
+        }
+
+        fail("unknown error");
+    }
+
+    std::string read_word()
+    {
+        const auto start = position_;
+
+        while (position_ < formula_.size() && is_word_character(formula_[position_]))
+        {
+            ++position_;
+        }
+
+        return formula_.substr(start, position_ - start);
+    }
+
+    void parse_number_or_rows()
+    {
+        // rows like 1:3 are references, everything else starting with a digit is a number
+        const auto start = position_;
+
+        while (std::isdigit(static_cast<unsigned char>(peek())))
+        {
+            ++position_;
+        }
+
+        if (peek() == ':')
+        {
+            position_ = start;
+            parse_reference(std::string(), read_word());
+            return;
+        }
+
+        position_ = start;
+        double number = 0;
+        std::size_t length = 0;
+
+        if (xlnt::detail::parse(formula_.substr(start), number, &length) != std::errc() || length == 0)
+        {
+            fail("invalid number");
+        }
+
+        position_ += length;
+        emit_constant(formula_value::from_number(number));
+    }
+
+    void parse_word()
+    {
+        auto word = read_word();
+
+        if (match('!'))
+        {
+            parse_reference(std::move(word), read_word());
+            return;
+        }
+
+        if (peek() == '(')
+        {
+            parse_call(word);
+            return;
+        }
+
+        auto upper = word;
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+
+        if (upper == "TRUE" || upper == "FALSE")
+        {
+            emit_constant(formula_value::from_boolean(upper == "TRUE"));
+            return;
+        }
+
+        parse_reference(std::string(), std::move(word));
+    }
+
+    void parse_call(const std::string &name)
+    {
+        auto upper = name;
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+
+        // functions added after Excel 2007 are stored with a prefix
+        for (auto prefix : {"_XLFN._XLWS.", "_XLFN.", "_XLWS."})
+        {
+            if (upper.compare(0, std::char_traits<char>::length(prefix), prefix) == 0)
+            {
+                upper.erase(0, std::char_traits<char>::length(prefix));
+                break;
+            }
+        }
+
+        xlnt::detail::formula_function_info function;
+
+        if (!xlnt::detail::find_function(upper, function))
+        {
+            fail("unsupported function " + name);
+        }
+
+        ++position_; // (
+        std::size_t arguments = 0;
+        skip_spaces();
+
+        if (!match(')'))
+        {
+            while (true)
+            {
+                skip_spaces();
+
+                // a missing argument like in IF(A1,,1) is blank
+                if (peek() == ',' || peek() == ')')
+                {
+                    emit_constant(formula_value());
+                }
+                else
+                {
+                    parse_comparison();
+                }
+
+                ++arguments;
+                skip_spaces();
+
+                if (match(')'))
+                {
+                    break;
+                }
+
+                if (!match(','))
+                {
+                    fail("expected , or )");
+                }
+            }
+        }
+
+        if (arguments < function.min_arguments || arguments > function.max_arguments)
+        {
+            fail("wrong number of arguments for " + name);
+        }
+
+        emit(opcode::call, static_cast<std::uint32_t>(function.function) | static_cast<std::uint32_t>(arguments << 16));
+    }
+
+    // parses one side of a reference like $A$1, A or 1 in word
+    void parse_reference_part(const std::string &word, xlnt::column_t::index_t &column, xlnt::row_t &row) const
+    {
+        std::size_t i = 0;
+        column = 0;
+        row = 0;
+
+        if (i < word.size() && word[i] == '$')
+        {
+            ++i;
+        }
+
+        while (i < word.size() && std::isalpha(static_cast<unsigned char>(word[i])))
+        {
+            column = column * 26 + static_cast<xlnt::column_t::index_t>(std::toupper(static_cast<unsigned char>(word[i])) - 'A' + 1);
+            ++i;
+
+            if (column > max_column)
+            {
+                fail("unsupported name " + word);
+            }
+        }
+
+        if (i < word.size() && word[i] == '$')
+        {
+            ++i;
+        }
+
+        while (i < word.size() && std::isdigit(static_cast<unsigned char>(word[i])))
+        {
+            row = row * 10 + static_cast<xlnt::row_t>(word[i] - '0');
+            ++i;
+
+            if (row > max_row)
+            {
+                fail("row out of range in " + word);
+            }
+        }
+
+        if (i != word.size() || (column == 0 && row == 0))
+        {
+            fail("unsupported name " + word);
+        }
+    }
+
+    void parse_reference(std::string sheet, const std::string &first)
+    {
+        formula_reference reference;
+        reference.sheet = std::move(sheet);
+
+        xlnt::column_t::index_t first_column = 0;
+        xlnt::row_t first_row = 0;
+        parse_reference_part(first, first_column, first_row);
+
+        auto last_column = first_column;
+        auto last_row = first_row;
+
+        if (match(':'))
+        {
+            reference.is_range = true;
+            parse_reference_part(read_word(), last_column, last_row);
+
+            // both sides are cells, columns like A:C or rows like 1:3
+            if ((first_column == 0) != (last_column == 0) || (first_row == 0) != (last_row == 0))
+            {
+                fail("invalid range");
+            }
+        }
+        else if (first_column == 0 || first_row == 0)
+        {
+            fail("invalid reference " + first);
+        }
+
+        if (first_column == 0)
+        {
+            first_column = 1;
+            last_column = max_column;
+        }
+
+        if (first_row == 0)
+        {
+            first_row = 1;
+            last_row = max_row;
+        }
+
+        reference.range.first_column = std::min(first_column, last_column);
+        reference.range.last_column = std::max(first_column, last_column);
+        reference.range.first_row = std::min(first_row, last_row);
+        reference.range.last_row = std::max(first_row, last_row);
+
+        emit(reference.is_range ? opcode::load_range : opcode::load_cell, static_cast<std::uint32_t>(result_.references.size()));
+        result_.references.push_back(std::move(reference));
+    }
+
+    const std::string &formula_;
+    std::size_t position_ = 0;
+    compiled_formula result_;
+};
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+const std::string &error_text(formula_error error)
+{
+    static const std::string texts[] = {"#NULL!", "#DIV/0!", "#VALUE!", "#REF!", "#NAME?", "#NUM!", "#N/A"};
+
+    return texts[static_cast<std::size_t>(error)];
+}
+
+bool parse_error(const std::string &text, formula_error &error)
+{
+    for (std::size_t i = 0; i <= static_cast<std::size_t>(formula_error::na); ++i)
+    {
+        if (text == error_text(static_cast<formula_error>(i)))
+        {
+            error = static_cast<formula_error>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+compiled_formula compile_formula(const std::string &formula)
+{
+    return formula_compiler(formula).compile();
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,97 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <detail/formula/formula_value.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// One step of a compiled formula, which is evaluated on a stack of formula_values.
+/// </summary>
+struct formula_instruction
+{
+    enum class opcode : std::uint8_t
+    {
+        push_constant, // pushes constants[operand]
+        load_cell, // pushes the value of the cell references[operand]
+        load_range, // pushes the range references[operand]
+        negate,
+        percent,
+        add,
+        subtract,
+        multiply,
+        divide,
+        power,
+        concatenate,
+        equal,
+        not_equal,
+        less,
+        less_equal,
+        greater,
+        greater_equal,
+        call // calls the function operand & 0xFFFF with the top operand >> 16 values as arguments
+    };
+
+    opcode op = opcode::push_constant;
+    std::uint32_t operand = 0;
+};
+
+/// <summary>
+/// A cell or range referenced by a formula. The worksheet is resolved by the calculation engine.
+/// </summary>
+struct formula_reference
+{
+    // empty for the worksheet of the formula
+    std::string sheet;
+    bool is_range = false;
+    formula_range range;
+};
+
+/// <summary>
+/// A formula compiled to postfix code, which is evaluated without parsing it again.
+/// </summary>
+struct compiled_formula
+{
+    std::vector<formula_instruction> code;
+    std::vector<formula_value> constants;
+    std::vector<formula_reference> references;
+};
+
+/// <summary>
+/// Compiles formula, without the leading '=' as it's stored in a cell. Throws an xlnt::exception
+/// if it isn't valid or uses something which can't be evaluated, such as an unknown function,
+/// a defined name or an array constant.
+/// </summary>
+XLNT_API_INTERNAL compiled_formula compile_formula(const std::string &formula);
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,163 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <xlnt/cell/index_types.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The errors a formula can evaluate to.
+/// </summary>
+enum class formula_error : std::uint8_t
+{
+    null,
+    div0,
+    value,
+    ref,
+    name,
+    num,
+    na
+};
+
+/// <summary>
+/// Returns the text of error as it's shown in a cell, e.g. "#DIV/0!".
+/// </summary>
+XLNT_API_INTERNAL const std::string &error_text(formula_error error);
+
+/// <summary>
+/// Sets error to the error spelled by text and returns true, or returns false if text isn't an error.
+/// </summary>
+XLNT_API_INTERNAL bool parse_error(const std::string &text, formula_error &error);
+
+/// <summary>
+/// A rectangle of cells on one worksheet, identified by its position in the workbook.
+/// </summary>
+struct formula_range
+{
+    static constexpr std::size_t invalid_sheet = std::numeric_limits<std::size_t>::max();
+
+    std::size_t sheet = invalid_sheet;
+    column_t::index_t first_column = 1;
+    column_t::index_t last_column = 1;
+    row_t first_row = 1;
+    row_t last_row = 1;
+
+    bool contains(std::size_t other_sheet, column_t::index_t column, row_t row) const
+    {
+        return sheet == other_sheet
+            && column >= first_column && column <= last_column
+            && row >= first_row && row <= last_row;
+    }
+
+    std::size_t width() const
+    {
+        return static_cast<std::size_t>(last_column - first_column) + 1;
+    }
+
+    std::size_t height() const
+    {
+        return static_cast<std::size_t>(last_row - first_row) + 1;
+    }
+};
+
+/// <summary>
+/// An operand or result while evaluating a formula.
+/// </summary>
+struct formula_value
+{
+    enum class value_type : std::uint8_t
+    {
+        blank,
+        number,
+        string,
+        boolean,
+        error,
+        range
+    };
+
+    static formula_value from_number(double number)
+    {
+        formula_value result;
+        result.type = value_type::number;
+        result.number = number;
+        return result;
+    }
+
+    static formula_value from_string(std::string string)
+    {
+        formula_value result;
+        result.type = value_type::string;
+        result.string = std::move(string);
+        return result;
+    }
+
+    static formula_value from_boolean(bool boolean)
+    {
+        formula_value result;
+        result.type = value_type::boolean;
+        result.number = boolean ? 1.0 : 0.0;
+        return result;
+    }
+
+    static formula_value from_error(formula_error error)
+    {
+        formula_value result;
+        result.type = value_type::error;
+        result.error = error;
+        return result;
+    }
+
+    static formula_value from_range(const formula_range &range)
+    {
+        formula_value result;
+        result.type = value_type::range;
+        result.range = range;
+        return result;
+    }
+
+    bool is_error() const
+    {
+        return type == value_type::error;
+    }
+
+    value_type type = value_type::blank;
+    formula_error error = formula_error::na;
+
+    // the value of numbers and booleans
+    double number = 0.0;
+    std::string string;
+    formula_range range;
+};
+
+} // namespace detail
+} // namespace xlnt
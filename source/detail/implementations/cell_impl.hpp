@@ -23,65 +23,103 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
 #include <xlnt/cell/cell_type.hpp>
 #include <xlnt/cell/comment.hpp>
 #include <xlnt/cell/index_types.hpp>
-#include <xlnt/cell/rich_text.hpp>
-#include <xlnt/packaging/relationship.hpp>
 #include <xlnt/utils/numeric.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <detail/implementations/format_impl.hpp>
-#include <detail/implementations/hyperlink_impl.hpp>
 
 namespace xlnt {
 namespace detail {
 
 struct worksheet_impl;
 
+/// <summary>
+/// The attributes of a cell which most cells don't have. These are kept out of cell_impl
+/// in a side table of the cell_store owning the cell so that plain cells stay small.
+/// Formulas, texts and hyperlinks each have a side table of their own, so that a cell only
+/// pays for the attributes it actually has.
+/// </summary>
+struct cell_extension
+{
+    bool is_merged_ = false;
+    bool phonetics_visible_ = false;
+
+    // one-based indices into the formula, text and hyperlink tables of the owning cell_store, 0 if unset
+    std::uint32_t formula_ = 0;
+    std::uint32_t text_ = 0;
+    std::uint32_t hyperlink_ = 0;
+
+    comment *comment_ = nullptr;
+
+    bool empty() const
+    {
+        return !is_merged_ && !phonetics_visible_ && formula_ == 0 && text_ == 0 && hyperlink_ == 0 && comment_ == nullptr;
+    }
+};
+
 struct cell_impl
 {
-    cell_type type_ = cell_type::empty;
+    cell_impl() = default;
+    cell_impl(const cell_impl &other) = default;
+    cell_impl &operator=(const cell_impl &other) = default;
+
+    // the extension belongs to exactly one cell, so a moved-from cell must not refer to it anymore
+    cell_impl(cell_impl &&other) noexcept
+        : parent_(other.parent_),
+          value_numeric_(other.value_numeric_),
+          format_(std::move(other.format_)),
+          column_(other.column_),
+          row_(other.row_),
+          type_(other.type_),
+          extension_(other.extension_)
+    {
+        other.extension_ = 0;
+    }
+
+    cell_impl &operator=(cell_impl &&other) noexcept
+    {
+        parent_ = other.parent_;
+        value_numeric_ = other.value_numeric_;
+        format_ = std::move(other.format_);
+        column_ = other.column_;
+        row_ = other.row_;
+        type_ = other.type_;
+        extension_ = other.extension_;
+        other.extension_ = 0;
+
+        return *this;
+    }
 
     worksheet_impl *parent_ = nullptr;
 
+    double value_numeric_ = 0.0;
+
+    format_impl_ptr format_;
+
     // According to the OOXML specification:
     // "In SpreadsheetML, cell references range from column A1–A1048576 (column A:A) to column XFD1–XFD1048576 (column XFD:XFD).
     // An implementation can extend this range."
     column_t column_ = 1; // default range: ["A", "XFD"] -> [1, 16384], but XLNT allows [1, 4294967295]
     row_t row_ = 1; // default range: [1, 1048576], but XLNT allows [1, 4294967295]
 
-    bool is_merged_ = false;
-    bool phonetics_visible_ = false;
-
-    rich_text value_text_;
-    double value_numeric_ = 0.0;
-
-    optional<std::string> formula_;
-    optional<hyperlink_impl> hyperlink_;
-    format_impl_ptr format_;
-    optional<comment *> comment_;
+    cell_type type_ = cell_type::empty;
 
-    bool is_garbage_collectible() const
-    {
-        return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || formula_.is_set() || format_.is_set() || hyperlink_.is_set());
-    }
+    // one-based index of the cell_extension in the side table of the owning cell_store, 0 if there is none
+    std::uint32_t extension_ = 0;
 };
 
 inline bool operator==(const cell_impl &lhs, const cell_impl &rhs)
 {
-    // not comparing parent, row, column
+    // not comparing parent, row, column and the extension, which must be compared separately
     return lhs.type_ == rhs.type_
-        && lhs.is_merged_ == rhs.is_merged_
-        && lhs.phonetics_visible_ == rhs.phonetics_visible_
-        && lhs.value_text_ == rhs.value_text_
         && float_equals(lhs.value_numeric_, rhs.value_numeric_)
-        && lhs.formula_ == rhs.formula_
-        && lhs.hyperlink_ == rhs.hyperlink_
-        && (lhs.format_.is_set() == rhs.format_.is_set() && (!lhs.format_.is_set() || *lhs.format_.get() == *rhs.format_.get()))
-        && (lhs.comment_.is_set() == rhs.comment_.is_set() && (!lhs.comment_.is_set() || *lhs.comment_.get() == *rhs.comment_.get()));
+        && (lhs.format_.is_set() == rhs.format_.is_set() && (!lhs.format_.is_set() || *lhs.format_.get() == *rhs.format_.get()));
 }
 
 inline bool operator!=(const cell_impl &lhs, const cell_impl &rhs)
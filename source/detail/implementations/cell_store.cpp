@@ -0,0 +1,903 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <new>
+
+#include <detail/constants.hpp>
+#include <detail/implementations/cell_store.hpp>
+
+namespace {
+
+constexpr std::size_t min_chunk_size = 16;
+constexpr std::size_t max_chunk_size = 4096;
+
+// Compares two possibly missing attributes
+template <typename T>
+bool values_equal(const T *lhs, const T *rhs)
+{
+    return lhs == nullptr ? rhs == nullptr : rhs != nullptr && *lhs == *rhs;
+}
+
+using cell_position = std::pair<xlnt::column_t::index_t, xlnt::row_t>;
+
+// Orders cells by column and then by row, like cell_store::column_order()
+bool precedes(const xlnt::detail::cell_impl *cell, const cell_position &position)
+{
+    return cell->column_.index < position.first
+        || (cell->column_.index == position.first && cell->row_ < position.second);
+}
+
+bool follows(const cell_position &position, const xlnt::detail::cell_impl *cell)
+{
+    return position.first < cell->column_.index
+        || (position.first == cell->column_.index && position.second < cell->row_);
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+constexpr row_t cell_store::rows_per_block;
+
+cell_store::chunk::chunk(std::size_t size)
+    : storage(new typename std::aligned_storage<sizeof(cell_impl), alignof(cell_impl)>::type[size]),
+      capacity(size)
+{
+}
+
+cell_store::cell_store(const cell_store &other)
+{
+    copy_from(other);
+}
+
+cell_store::cell_store(cell_store &&other) noexcept
+    : blocks_(std::move(other.blocks_)),
+      chunks_(std::move(other.chunks_)),
+      free_cells_(std::move(other.free_cells_)),
+      size_(other.size_),
+      bounds_(other.bounds_),
+      bounds_valid_(other.bounds_valid_.load()),
+      column_order_(std::move(other.column_order_)),
+      column_order_valid_(other.column_order_valid_.load()),
+      extensions_(std::move(other.extensions_)),
+      formulas_(std::move(other.formulas_)),
+      texts_(std::move(other.texts_)),
+      hyperlinks_(std::move(other.hyperlinks_)),
+      shared_string_references_(std::move(other.shared_string_references_)),
+      shared_string_count_(other.shared_string_count_)
+{
+    other.blocks_.clear();
+    other.chunks_.clear();
+    other.free_cells_.clear();
+    other.size_ = 0;
+    other.bounds_valid_ = false;
+    other.column_order_.clear();
+    other.column_order_valid_ = false;
+    other.extensions_.clear();
+    other.formulas_.clear();
+    other.texts_.clear();
+    other.hyperlinks_.clear();
+    other.shared_string_references_.clear();
+    other.shared_string_count_ = 0;
+}
+
+cell_store::~cell_store()
+{
+    clear();
+}
+
+cell_store &cell_store::operator=(const cell_store &other)
+{
+    if (this != &other)
+    {
+        clear();
+        copy_from(other);
+    }
+
+    return *this;
+}
+
+cell_store &cell_store::operator=(cell_store &&other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+
+        std::swap(blocks_, other.blocks_);
+        std::swap(chunks_, other.chunks_);
+        std::swap(free_cells_, other.free_cells_);
+        std::swap(size_, other.size_);
+        std::swap(bounds_, other.bounds_);
+        bounds_valid_ = other.bounds_valid_.load();
+        other.bounds_valid_ = false;
+        std::swap(column_order_, other.column_order_);
+        column_order_valid_ = other.column_order_valid_.load();
+        other.column_order_valid_ = false;
+        std::swap(extensions_, other.extensions_);
+        std::swap(formulas_, other.formulas_);
+        std::swap(texts_, other.texts_);
+        std::swap(hyperlinks_, other.hyperlinks_);
+        std::swap(shared_string_references_, other.shared_string_references_);
+        std::swap(shared_string_count_, other.shared_string_count_);
+    }
+
+    return *this;
+}
+
+cell_impl *cell_store::find(column_t::index_t column, row_t row)
+{
+    auto block = find_block(row);
+
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto &entries = block->rows[(row - 1) % rows_per_block];
+    auto match = find_column(entries, column);
+
+    return match != entries.end() && match->first == column ? match->second : nullptr;
+}
+
+const cell_impl *cell_store::find(column_t::index_t column, row_t row) const
+{
+    return const_cast<cell_store *>(this)->find(column, row);
+}
+
+std::pair<cell_impl *, bool> cell_store::emplace(const cell_reference &reference)
+{
+    auto column = reference.column_index();
+    auto row = reference.row();
+    auto &block = find_or_create_block(row);
+    auto &entries = block.rows[(row - 1) % rows_per_block];
+    auto position = find_column(entries, column);
+
+    if (position != entries.end() && position->first == column)
+    {
+        return {position->second, false};
+    }
+
+    cell_impl value;
+    value.column_ = column;
+    value.row_ = row;
+
+    extend_bounds(column, row);
+    auto cell = allocate(std::move(value));
+    add_to_column_order(cell);
+    entries.emplace(position, column, cell);
+    ++block.cell_count;
+    ++size_;
+
+    return {cell, true};
+}
+
+std::pair<cell_impl *, bool> cell_store::emplace(cell_impl &&value)
+{
+    auto column = value.column_.index;
+    auto row = value.row_;
+    auto &block = find_or_create_block(row);
+    auto &entries = block.rows[(row - 1) % rows_per_block];
+    auto position = find_column(entries, column);
+
+    if (position != entries.end() && position->first == column)
+    {
+        return {position->second, false};
+    }
+
+    extend_bounds(column, row);
+    auto cell = allocate(std::move(value));
+    add_to_column_order(cell);
+    reference_shared_string(*cell);
+    entries.emplace(position, column, cell);
+    ++block.cell_count;
+    ++size_;
+
+    return {cell, true};
+}
+
+cell_impl *cell_store::insert_or_assign(cell_impl &&value)
+{
+    auto column = value.column_.index;
+    auto row = value.row_;
+    auto &block = find_or_create_block(row);
+    auto &entries = block.rows[(row - 1) % rows_per_block];
+    auto position = find_column(entries, column);
+
+    if (position != entries.end() && position->first == column)
+    {
+        release_extension(*position->second);
+        release_shared_string(*position->second);
+        *position->second = std::move(value);
+        reference_shared_string(*position->second);
+        return position->second;
+    }
+
+    extend_bounds(column, row);
+    auto cell = allocate(std::move(value));
+    add_to_column_order(cell);
+    reference_shared_string(*cell);
+    entries.emplace(position, column, cell);
+    ++block.cell_count;
+    ++size_;
+
+    return cell;
+}
+
+bool cell_store::erase(const cell_reference &reference)
+{
+    auto block = find_block(reference.row());
+
+    if (block == nullptr)
+    {
+        return false;
+    }
+
+    auto column = reference.column_index();
+    auto &entries = block->rows[(reference.row() - 1) % rows_per_block];
+    auto position = find_column(entries, column);
+
+    if (position == entries.end() || position->first != column)
+    {
+        return false;
+    }
+
+    shrink_bounds(column, reference.row());
+    remove_from_column_order(position->second);
+    release(position->second);
+    entries.erase(position);
+    --size_;
+
+    if (--block->cell_count == 0)
+    {
+        remove_empty_blocks();
+    }
+
+    return true;
+}
+
+std::size_t cell_store::erase_row(row_t row)
+{
+    auto block = find_block(row);
+
+    if (block == nullptr)
+    {
+        return 0;
+    }
+
+    auto &entries = block->rows[(row - 1) % rows_per_block];
+    auto removed = entries.size();
+
+    if (column_order_valid_ && removed > 0)
+    {
+        column_order_.erase(std::remove_if(column_order_.begin(), column_order_.end(),
+            [row](const cell_impl *cell) { return cell->row_ == row; }), column_order_.end());
+    }
+
+    for (auto &current : entries)
+    {
+        shrink_bounds(current.first, row);
+        release(current.second);
+    }
+
+    entries.clear();
+    size_ -= removed;
+    block->cell_count -= removed;
+
+    if (block->cell_count == 0)
+    {
+        remove_empty_blocks();
+    }
+
+    return removed;
+}
+
+void cell_store::clear()
+{
+    for (auto &block : blocks_)
+    {
+        for (auto &entries : block.second->rows)
+        {
+            for (auto &current : entries)
+            {
+                current.second->~cell_impl();
+            }
+        }
+    }
+
+    blocks_.clear();
+    chunks_.clear();
+    free_cells_.clear();
+    size_ = 0;
+    bounds_valid_ = false;
+    column_order_.clear();
+    column_order_valid_ = false;
+    extensions_.clear();
+    formulas_.clear();
+    texts_.clear();
+    hyperlinks_.clear();
+    shared_string_references_.clear();
+    shared_string_count_ = 0;
+}
+
+void cell_store::compact_extension(cell_impl &cell)
+{
+    auto ext = find_extension(cell);
+
+    if (ext != nullptr && ext->empty())
+    {
+        release_extension(cell);
+    }
+}
+
+void cell_store::clear_formula(cell_impl &cell)
+{
+    if (cell.extension_ != 0)
+    {
+        formulas_.release(extension(cell).formula_);
+        compact_extension(cell);
+    }
+}
+
+void cell_store::clear_text(cell_impl &cell)
+{
+    if (cell.extension_ != 0)
+    {
+        texts_.release(extension(cell).text_);
+        compact_extension(cell);
+    }
+}
+
+void cell_store::clear_hyperlink(cell_impl &cell)
+{
+    if (cell.extension_ != 0)
+    {
+        hyperlinks_.release(extension(cell).hyperlink_);
+        compact_extension(cell);
+    }
+}
+
+bool cell_store::attributes_equal(const cell_impl &cell, const cell_store &other_store, const cell_impl &other) const
+{
+    static const cell_extension none;
+
+    const auto lhs = find_extension(cell);
+    const auto rhs = other_store.find_extension(other);
+    const auto &left = lhs == nullptr ? none : *lhs;
+    const auto &right = rhs == nullptr ? none : *rhs;
+
+    const auto left_text = find_text(cell);
+    const auto right_text = other_store.find_text(other);
+
+    return left.is_merged_ == right.is_merged_
+        && left.phonetics_visible_ == right.phonetics_visible_
+        && (left_text == nullptr ? rich_text() : *left_text) == (right_text == nullptr ? rich_text() : *right_text)
+        && values_equal(find_formula(cell), other_store.find_formula(other))
+        && values_equal(find_hyperlink(cell), other_store.find_hyperlink(other))
+        && values_equal(left.comment_, right.comment_);
+}
+
+void cell_store::reference_shared_string(const cell_impl &cell)
+{
+    if (cell.type_ != cell_type::shared_string)
+    {
+        return;
+    }
+
+    auto index = static_cast<std::size_t>(cell.value_numeric_);
+
+    if (index >= shared_string_references_.size())
+    {
+        shared_string_references_.resize(index + 1, 0);
+    }
+
+    ++shared_string_references_[index];
+    ++shared_string_count_;
+}
+
+void cell_store::release_shared_string(const cell_impl &cell)
+{
+    if (cell.type_ != cell_type::shared_string)
+    {
+        return;
+    }
+
+    auto index = static_cast<std::size_t>(cell.value_numeric_);
+
+    if (index < shared_string_references_.size() && shared_string_references_[index] > 0)
+    {
+        --shared_string_references_[index];
+        --shared_string_count_;
+    }
+}
+
+std::size_t cell_store::shared_string_references(std::size_t index) const
+{
+    return index < shared_string_references_.size() ? shared_string_references_[index] : 0;
+}
+
+bool cell_store::is_garbage_collectible(const cell_impl &cell) const
+{
+    if (cell.type_ != cell_type::empty || cell.format_.is_set())
+    {
+        return false;
+    }
+
+    auto ext = find_extension(cell);
+
+    return ext == nullptr
+        || !(ext->is_merged_ || ext->phonetics_visible_ || ext->formula_ != 0 || ext->hyperlink_ != 0);
+}
+
+void cell_store::reserve(std::size_t n)
+{
+    if (n <= size_)
+    {
+        return;
+    }
+
+    auto available = free_cells_.size();
+
+    if (!chunks_.empty())
+    {
+        available += chunks_.back().capacity - chunks_.back().used;
+    }
+
+    auto needed = n - size_;
+
+    if (needed <= available)
+    {
+        return;
+    }
+
+    // hand the tail of the current chunk over to the free list so that it isn't lost
+    if (!chunks_.empty())
+    {
+        auto &last = chunks_.back();
+
+        while (last.used < last.capacity)
+        {
+            free_cells_.push_back(reinterpret_cast<cell_impl *>(&last.storage[last.used++]));
+        }
+    }
+
+    chunks_.emplace_back(needed - available);
+}
+
+const cell_store::cell_bounds &cell_store::bounds() const
+{
+    if (bounds_valid_.load(std::memory_order_acquire) || blocks_.empty())
+    {
+        return bounds_;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
+    // another thread may have recomputed the bounds while this one was waiting
+    if (bounds_valid_.load(std::memory_order_relaxed))
+    {
+        return bounds_;
+    }
+
+    const auto &first_block = *blocks_.front().second;
+    auto first_offset = row_t(0);
+    while (first_block.rows[first_offset].empty()) ++first_offset;
+    bounds_.first_row = static_cast<row_t>(blocks_.front().first * rows_per_block + first_offset + 1);
+
+    const auto &last_block = *blocks_.back().second;
+    auto last_offset = static_cast<row_t>(rows_per_block - 1);
+    while (last_block.rows[last_offset].empty()) --last_offset;
+    bounds_.last_row = static_cast<row_t>(blocks_.back().first * rows_per_block + last_offset + 1);
+
+    bounds_.first_column = constants::max_column().index;
+    bounds_.last_column = constants::min_column().index;
+
+    // the columns of each row are sorted, so only the first and last entries matter
+    for_each_row([this](row_t, const row_entries &entries) {
+        bounds_.first_column = std::min(bounds_.first_column, entries.front().first);
+        bounds_.last_column = std::max(bounds_.last_column, entries.back().first);
+    });
+
+    bounds_valid_.store(true, std::memory_order_release);
+
+    return bounds_;
+}
+
+const cell_store::row_entries *cell_store::row(row_t row) const
+{
+    auto block = find_block(row);
+
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    const auto &entries = block->rows[(row - 1) % rows_per_block];
+
+    return entries.empty() ? nullptr : &entries;
+}
+
+const cell_impl *cell_store::first_in_row(row_t row, column_t::index_t first_column, column_t::index_t last_column) const
+{
+    auto entries = this->row(row);
+
+    if (entries == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto match = find_column(*entries, first_column);
+
+    return match != entries->end() && match->first <= last_column ? match->second : nullptr;
+}
+
+const cell_impl *cell_store::last_in_row(row_t row, column_t::index_t first_column, column_t::index_t last_column) const
+{
+    auto entries = this->row(row);
+
+    if (entries == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto match = std::upper_bound(entries->begin(), entries->end(), last_column,
+        [](column_t::index_t column, const std::pair<column_t::index_t, cell_impl *> &entry) {
+            return column < entry.first;
+        });
+
+    if (match == entries->begin() || (--match)->first < first_column)
+    {
+        return nullptr;
+    }
+
+    return match->second;
+}
+
+const cell_impl *cell_store::first_in_column(column_t::index_t column, row_t first_row, row_t last_row) const
+{
+    const auto &cells = column_order();
+    auto match = std::lower_bound(cells.begin(), cells.end(), cell_position(column, first_row), precedes);
+
+    if (match == cells.end() || (*match)->column_.index != column || (*match)->row_ > last_row)
+    {
+        return nullptr;
+    }
+
+    return *match;
+}
+
+const cell_impl *cell_store::last_in_column(column_t::index_t column, row_t first_row, row_t last_row) const
+{
+    const auto &cells = column_order();
+    auto match = std::upper_bound(cells.begin(), cells.end(), cell_position(column, last_row), follows);
+
+    if (match == cells.begin() || (*--match)->column_.index != column || (*match)->row_ < first_row)
+    {
+        return nullptr;
+    }
+
+    return *match;
+}
+
+const std::vector<cell_impl *> &cell_store::column_order() const
+{
+    if (column_order_valid_.load(std::memory_order_acquire))
+    {
+        return column_order_;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
+    if (column_order_valid_.load(std::memory_order_relaxed))
+    {
+        return column_order_;
+    }
+
+    // the rows are visited in ascending order, so a stable sort by column yields column-major order
+    column_order_.clear();
+    column_order_.reserve(size_);
+
+    for_each_row([this](row_t, const row_entries &entries) {
+        for (const auto &entry : entries)
+        {
+            column_order_.push_back(entry.second);
+        }
+    });
+
+    std::stable_sort(column_order_.begin(), column_order_.end(), [](const cell_impl *a, const cell_impl *b) {
+        return a->column_.index < b->column_.index;
+    });
+
+    column_order_valid_.store(true, std::memory_order_release);
+
+    return column_order_;
+}
+
+bool cell_store::operator==(const cell_store &other) const
+{
+    if (size_ != other.size_ || blocks_.size() != other.blocks_.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < blocks_.size(); ++i)
+    {
+        if (blocks_[i].first != other.blocks_[i].first)
+        {
+            return false;
+        }
+
+        const auto &left_rows = blocks_[i].second->rows;
+        const auto &right_rows = other.blocks_[i].second->rows;
+
+        for (row_t offset = 0; offset < rows_per_block; ++offset)
+        {
+            const auto &left = left_rows[offset];
+            const auto &right = right_rows[offset];
+
+            if (left.size() != right.size())
+            {
+                return false;
+            }
+
+            for (std::size_t j = 0; j < left.size(); ++j)
+            {
+                if (left[j].first != right[j].first || !(*left[j].second == *right[j].second)
+                    || !attributes_equal(*left[j].second, other, *right[j].second))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+cell_store::row_block *cell_store::find_block(row_t row) const
+{
+    if (blocks_.empty())
+    {
+        return nullptr;
+    }
+
+    auto key = static_cast<row_t>((row - 1) / rows_per_block);
+
+    // cells are mostly accessed in ascending row order, so check the last block first
+    if (blocks_.back().first == key)
+    {
+        return blocks_.back().second.get();
+    }
+
+    auto match = std::lower_bound(blocks_.begin(), blocks_.end(), key,
+        [](const block_list::value_type &block, row_t k) { return block.first < k; });
+
+    return match != blocks_.end() && match->first == key ? match->second.get() : nullptr;
+}
+
+cell_store::row_block &cell_store::find_or_create_block(row_t row)
+{
+    auto key = static_cast<row_t>((row - 1) / rows_per_block);
+
+    if (blocks_.empty() || blocks_.back().first < key)
+    {
+        blocks_.emplace_back(key, std::unique_ptr<row_block>(new row_block()));
+        return *blocks_.back().second;
+    }
+
+    if (blocks_.back().first == key)
+    {
+        return *blocks_.back().second;
+    }
+
+    auto match = std::lower_bound(blocks_.begin(), blocks_.end(), key,
+        [](const block_list::value_type &block, row_t k) { return block.first < k; });
+
+    if (match == blocks_.end() || match->first != key)
+    {
+        match = blocks_.emplace(match, key, std::unique_ptr<row_block>(new row_block()));
+    }
+
+    return *match->second;
+}
+
+void cell_store::remove_empty_blocks()
+{
+    blocks_.erase(std::remove_if(blocks_.begin(), blocks_.end(),
+                      [](const block_list::value_type &block) { return block.second->cell_count == 0; }),
+        blocks_.end());
+}
+
+cell_store::row_entries::iterator cell_store::find_column(row_entries &entries, column_t::index_t column)
+{
+    // appending to the end of a row is by far the most common case
+    if (entries.empty() || entries.back().first < column)
+    {
+        return entries.end();
+    }
+
+    // dense rows without gaps can be indexed directly
+    auto first = entries.front().first;
+
+    if (column >= first && column - first < entries.size() && entries[column - first].first == column)
+    {
+        return entries.begin() + static_cast<std::ptrdiff_t>(column - first);
+    }
+
+    return std::lower_bound(entries.begin(), entries.end(), column,
+        [](const entry &e, column_t::index_t c) { return e.first < c; });
+}
+
+cell_store::row_entries::const_iterator cell_store::find_column(const row_entries &entries, column_t::index_t column)
+{
+    return find_column(const_cast<row_entries &>(entries), column);
+}
+
+cell_impl *cell_store::allocate(cell_impl &&value)
+{
+    void *slot = nullptr;
+
+    if (!free_cells_.empty())
+    {
+        slot = free_cells_.back();
+        free_cells_.pop_back();
+    }
+    else
+    {
+        if (chunks_.empty() || chunks_.back().used == chunks_.back().capacity)
+        {
+            auto next_size = chunks_.empty() ? min_chunk_size : std::min(chunks_.back().capacity * 2, max_chunk_size);
+            chunks_.emplace_back(std::max(next_size, min_chunk_size));
+        }
+
+        auto &last = chunks_.back();
+        slot = &last.storage[last.used++];
+    }
+
+    return new (slot) cell_impl(std::move(value));
+}
+
+void cell_store::release(cell_impl *cell)
+{
+    release_extension(*cell);
+    release_shared_string(*cell);
+    cell->~cell_impl();
+    free_cells_.push_back(cell);
+}
+
+void cell_store::release_extension(cell_impl &cell)
+{
+    if (cell.extension_ == 0)
+    {
+        return;
+    }
+
+    auto &ext = extension(cell);
+    formulas_.release(ext.formula_);
+    texts_.release(ext.text_);
+    hyperlinks_.release(ext.hyperlink_);
+    extensions_.release(cell.extension_);
+}
+
+void cell_store::extend_bounds(column_t::index_t column, row_t row)
+{
+    if (size_ == 0)
+    {
+        bounds_.first_column = bounds_.last_column = column;
+        bounds_.first_row = bounds_.last_row = row;
+        bounds_valid_ = true;
+    }
+    else if (bounds_valid_)
+    {
+        bounds_.first_column = std::min(bounds_.first_column, column);
+        bounds_.last_column = std::max(bounds_.last_column, column);
+        bounds_.first_row = std::min(bounds_.first_row, row);
+        bounds_.last_row = std::max(bounds_.last_row, row);
+    }
+}
+
+void cell_store::shrink_bounds(column_t::index_t column, row_t row)
+{
+    // only removing a cell on an edge can make the bounds smaller
+    if (bounds_valid_
+        && (column == bounds_.first_column || column == bounds_.last_column
+            || row == bounds_.first_row || row == bounds_.last_row))
+    {
+        bounds_valid_ = false;
+    }
+}
+
+void cell_store::add_to_column_order(cell_impl *cell)
+{
+    // the order is only kept once it was sorted, so loading cells doesn't pay for it
+    if (!column_order_valid_)
+    {
+        return;
+    }
+
+    auto position = std::lower_bound(column_order_.begin(), column_order_.end(),
+        cell_position(cell->column_.index, cell->row_), precedes);
+    column_order_.insert(position, cell);
+}
+
+void cell_store::remove_from_column_order(const cell_impl *cell)
+{
+    if (!column_order_valid_)
+    {
+        return;
+    }
+
+    auto position = std::lower_bound(column_order_.begin(), column_order_.end(),
+        cell_position(cell->column_.index, cell->row_), precedes);
+
+    if (position != column_order_.end() && *position == cell)
+    {
+        column_order_.erase(position);
+    }
+    else
+    {
+        column_order_valid_ = false;
+    }
+}
+
+void cell_store::copy_from(const cell_store &other)
+{
+    reserve(other.size_);
+
+    bounds_ = other.bounds_;
+    bounds_valid_ = other.bounds_valid_.load();
+
+    // the copied cells keep their extension indices and the extensions their attribute indices
+    extensions_ = other.extensions_;
+    formulas_ = other.formulas_;
+    texts_ = other.texts_;
+    hyperlinks_ = other.hyperlinks_;
+    shared_string_references_ = other.shared_string_references_;
+    shared_string_count_ = other.shared_string_count_;
+
+    for (const auto &block : other.blocks_)
+    {
+        std::unique_ptr<row_block> copy(new row_block());
+        copy->cell_count = block.second->cell_count;
+
+        for (row_t offset = 0; offset < rows_per_block; ++offset)
+        {
+            const auto &source = block.second->rows[offset];
+            auto &target = copy->rows[offset];
+            target.reserve(source.size());
+
+            for (const auto &current : source)
+            {
+                target.emplace_back(current.first, allocate(cell_impl(*current.second)));
+            }
+        }
+
+        blocks_.emplace_back(block.first, std::move(copy));
+    }
+
+    size_ = other.size_;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,737 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/cell/rich_text.hpp>
+#include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/hyperlink_impl.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// A table of cell attributes of one kind which are referenced by one-based index, 0 meaning none.
+/// Values keep their address until they are released, after which their slot is reused.
+/// </summary>
+template <typename T>
+class side_table
+{
+public:
+    /// <summary>
+    /// Returns the value with the given index or nullptr if the index is 0.
+    /// </summary>
+    const T *find(std::uint32_t index) const
+    {
+        return index == 0 ? nullptr : &values_[index - 1];
+    }
+
+    /// <summary>
+    /// Returns the value with the given index. If the index is 0, a default value is added
+    /// and its index is stored in index.
+    /// </summary>
+    T &get_or_create(std::uint32_t &index)
+    {
+        if (index == 0)
+        {
+            if (!free_.empty())
+            {
+                index = free_.back();
+                free_.pop_back();
+            }
+            else
+            {
+                values_.emplace_back();
+                index = static_cast<std::uint32_t>(values_.size());
+            }
+        }
+
+        return values_[index - 1];
+    }
+
+    /// <summary>
+    /// Releases the value with the given index, if any, and sets index to 0.
+    /// </summary>
+    void release(std::uint32_t &index)
+    {
+        if (index == 0)
+        {
+            return;
+        }
+
+        values_[index - 1] = T();
+        free_.push_back(index);
+        index = 0;
+    }
+
+    /// <summary>
+    /// Returns the number of values which haven't been released.
+    /// </summary>
+    std::size_t size() const
+    {
+        return values_.size() - free_.size();
+    }
+
+    void clear()
+    {
+        values_.clear();
+        free_.clear();
+    }
+
+private:
+    // a deque keeps the values in place when new ones are added
+    std::deque<T> values_;
+    std::vector<std::uint32_t> free_;
+};
+
+/// <summary>
+/// Owns the cells of a worksheet and keeps them ordered by row, then by column.
+/// Rows are grouped in fixed-size blocks, each row holding a vector of its populated
+/// columns sorted in ascending order. A lookup indexes directly into a row when its columns
+/// are contiguous and falls back to a binary search for sparse rows.
+/// The cells themselves live in chunks which are never reallocated, so a cell_impl keeps
+/// its address until it is erased, just like a node of the std::unordered_map this replaces.
+/// Rarely used cell attributes are stored in a side table of cell_extension records which
+/// are referenced by index from the cells that have them. Formulas, texts and hyperlinks
+/// are in tables of their own, referenced by index from the extensions.
+/// </summary>
+class XLNT_API_INTERNAL cell_store
+{
+public:
+    /// <summary>
+    /// A populated column of a row and the cell stored there.
+    /// </summary>
+    using entry = std::pair<column_t::index_t, cell_impl *>;
+
+    /// <summary>
+    /// The populated columns of a single row, sorted by column.
+    /// </summary>
+    using row_entries = std::vector<entry>;
+
+    /// <summary>
+    /// The number of consecutive rows grouped in one block.
+    /// </summary>
+    static constexpr row_t rows_per_block = 64;
+
+    /// <summary>
+    /// The smallest rectangle containing all cells of the store.
+    /// </summary>
+    struct cell_bounds
+    {
+        column_t::index_t first_column = 1;
+        column_t::index_t last_column = 1;
+        row_t first_row = 1;
+        row_t last_row = 1;
+    };
+
+    template <bool is_const>
+    class cell_iterator_base;
+
+    using iterator = cell_iterator_base<false>;
+    using const_iterator = cell_iterator_base<true>;
+
+    cell_store() = default;
+    cell_store(const cell_store &other);
+    cell_store(cell_store &&other) noexcept;
+    ~cell_store();
+
+    cell_store &operator=(const cell_store &other);
+    cell_store &operator=(cell_store &&other) noexcept;
+
+    /// <summary>
+    /// Returns the cell at the given position or nullptr if it doesn't exist.
+    /// </summary>
+    cell_impl *find(column_t::index_t column, row_t row);
+
+    /// <summary>
+    /// Returns the cell at the given position or nullptr if it doesn't exist.
+    /// </summary>
+    const cell_impl *find(column_t::index_t column, row_t row) const;
+
+    /// <summary>
+    /// Returns the cell at the given reference or nullptr if it doesn't exist.
+    /// </summary>
+    cell_impl *find(const cell_reference &reference)
+    {
+        return find(reference.column_index(), reference.row());
+    }
+
+    /// <summary>
+    /// Returns the cell at the given reference or nullptr if it doesn't exist.
+    /// </summary>
+    const cell_impl *find(const cell_reference &reference) const
+    {
+        return find(reference.column_index(), reference.row());
+    }
+
+    /// <summary>
+    /// Returns true if a cell exists at the given reference.
+    /// </summary>
+    bool contains(const cell_reference &reference) const
+    {
+        return find(reference) != nullptr;
+    }
+
+    /// <summary>
+    /// Returns the cell at the given reference, creating an empty one if it doesn't exist yet.
+    /// The second member of the returned pair is true if the cell was created.
+    /// </summary>
+    std::pair<cell_impl *, bool> emplace(const cell_reference &reference);
+
+    /// <summary>
+    /// Moves value into the store at the position given by its column_ and row_ members
+    /// if no cell exists there yet. Returns the stored cell and true if value was inserted.
+    /// </summary>
+    std::pair<cell_impl *, bool> emplace(cell_impl &&value);
+
+    /// <summary>
+    /// Moves value into the store at the position given by its column_ and row_ members,
+    /// replacing any cell which already exists there. Returns the stored cell.
+    /// </summary>
+    cell_impl *insert_or_assign(cell_impl &&value);
+
+    /// <summary>
+    /// Removes the cell at the given reference. Returns true if a cell was removed.
+    /// </summary>
+    bool erase(const cell_reference &reference);
+
+    /// <summary>
+    /// Removes every cell of the given row. Returns the number of cells removed.
+    /// </summary>
+    std::size_t erase_row(row_t row);
+
+    /// <summary>
+    /// Returns the extension of the given cell of this store or nullptr if it has none.
+    /// </summary>
+    const cell_extension *find_extension(const cell_impl &cell) const
+    {
+        return extensions_.find(cell.extension_);
+    }
+
+    /// <summary>
+    /// Returns the extension of the given cell of this store, creating an empty one if it has none.
+    /// The returned reference stays valid until the extension is released.
+    /// </summary>
+    cell_extension &extension(cell_impl &cell)
+    {
+        return extensions_.get_or_create(cell.extension_);
+    }
+
+    /// <summary>
+    /// Releases the extension of the given cell of this store if all of its attributes are unset.
+    /// </summary>
+    void compact_extension(cell_impl &cell);
+
+    /// <summary>
+    /// Releases the extension of the given cell and all of its attributes. This is also used for cells
+    /// which aren't part of this store but use its side tables, like the cell of the streaming reader.
+    /// </summary>
+    void release_extension(cell_impl &cell);
+
+    /// <summary>
+    /// Returns the formula of the given cell of this store or nullptr if it has none.
+    /// </summary>
+    const std::string *find_formula(const cell_impl &cell) const
+    {
+        auto ext = find_extension(cell);
+        return ext == nullptr ? nullptr : formulas_.find(ext->formula_);
+    }
+
+    /// <summary>
+    /// Returns the formula of the given cell of this store, creating an empty one if it has none.
+    /// </summary>
+    std::string &formula(cell_impl &cell)
+    {
+        return formulas_.get_or_create(extension(cell).formula_);
+    }
+
+    /// <summary>
+    /// Removes the formula of the given cell of this store.
+    /// </summary>
+    void clear_formula(cell_impl &cell);
+
+    /// <summary>
+    /// Returns the inline, formula or error text of the given cell of this store or nullptr if it has none.
+    /// </summary>
+    const rich_text *find_text(const cell_impl &cell) const
+    {
+        auto ext = find_extension(cell);
+        return ext == nullptr ? nullptr : texts_.find(ext->text_);
+    }
+
+    /// <summary>
+    /// Returns the text of the given cell of this store, creating an empty one if it has none.
+    /// </summary>
+    rich_text &text(cell_impl &cell)
+    {
+        return texts_.get_or_create(extension(cell).text_);
+    }
+
+    /// <summary>
+    /// Removes the text of the given cell of this store.
+    /// </summary>
+    void clear_text(cell_impl &cell);
+
+    /// <summary>
+    /// Returns the hyperlink of the given cell of this store or nullptr if it has none.
+    /// </summary>
+    const hyperlink_impl *find_hyperlink(const cell_impl &cell) const
+    {
+        auto ext = find_extension(cell);
+        return ext == nullptr ? nullptr : hyperlinks_.find(ext->hyperlink_);
+    }
+
+    /// <summary>
+    /// Returns the hyperlink of the given cell of this store, creating an empty one if it has none.
+    /// The returned reference stays valid until the hyperlink is removed.
+    /// </summary>
+    hyperlink_impl &hyperlink(cell_impl &cell)
+    {
+        return hyperlinks_.get_or_create(extension(cell).hyperlink_);
+    }
+
+    /// <summary>
+    /// Removes the hyperlink of the given cell of this store.
+    /// </summary>
+    void clear_hyperlink(cell_impl &cell);
+
+    /// <summary>
+    /// Returns true if the given cell of this store has the same rarely used attributes as
+    /// the given cell of the other store. A missing text is equal to an empty one.
+    /// </summary>
+    bool attributes_equal(const cell_impl &cell, const cell_store &other_store, const cell_impl &other) const;
+
+    /// <summary>
+    /// Counts a reference to the shared string of the given cell if it is of type shared_string.
+    /// Cells inserted into the store are counted automatically, so this only needs to be called
+    /// after the type or value of a stored cell was changed to a shared string.
+    /// </summary>
+    void reference_shared_string(const cell_impl &cell);
+
+    /// <summary>
+    /// Removes the reference counted for the given cell if it is of type shared_string.
+    /// This must be called before the type or value of a stored shared string cell is changed.
+    /// </summary>
+    void release_shared_string(const cell_impl &cell);
+
+    /// <summary>
+    /// Returns the number of cells which refer to the shared string with the given index.
+    /// </summary>
+    std::size_t shared_string_references(std::size_t index) const;
+
+    /// <summary>
+    /// Returns the number of cells which refer to a shared string.
+    /// </summary>
+    std::size_t shared_string_count() const
+    {
+        return shared_string_count_;
+    }
+
+    /// <summary>
+    /// Returns true if the given cell of this store holds no data and can be removed.
+    /// </summary>
+    bool is_garbage_collectible(const cell_impl &cell) const;
+
+    /// <summary>
+    /// Returns the number of cells which have an extension.
+    /// </summary>
+    std::size_t extension_count() const
+    {
+        return extensions_.size();
+    }
+
+    /// <summary>
+    /// Returns the number of cells which have a formula.
+    /// </summary>
+    std::size_t formula_count() const
+    {
+        return formulas_.size();
+    }
+
+    /// <summary>
+    /// Removes every cell for which predicate returns true. Returns the number of cells removed.
+    /// </summary>
+    template <typename Predicate>
+    std::size_t erase_if(Predicate predicate)
+    {
+        std::size_t removed = 0;
+
+        for (auto &block : blocks_)
+        {
+            auto first_row = static_cast<row_t>(block.first * rows_per_block + 1);
+
+            for (row_t offset = 0; offset < rows_per_block; ++offset)
+            {
+                auto &row = block.second->rows[offset];
+                auto kept = row.begin();
+
+                for (auto &current : row)
+                {
+                    if (predicate(*current.second))
+                    {
+                        // the predicate may have moved the cell away, so its position is taken from the entry
+                        shrink_bounds(current.first, static_cast<row_t>(first_row + offset));
+                        release(current.second);
+                        ++removed;
+                    }
+                    else
+                    {
+                        *kept++ = current;
+                    }
+                }
+
+                block.second->cell_count -= static_cast<std::size_t>(row.end() - kept);
+                row.erase(kept, row.end());
+            }
+        }
+
+        if (removed > 0)
+        {
+            column_order_valid_ = false;
+        }
+
+        size_ -= removed;
+        remove_empty_blocks();
+
+        return removed;
+    }
+
+    /// <summary>
+    /// Removes all cells.
+    /// </summary>
+    void clear();
+
+    /// <summary>
+    /// Allocates storage for at least n cells in total so that they can be created without further allocations.
+    /// </summary>
+    void reserve(std::size_t n);
+
+    /// <summary>
+    /// Returns the number of cells.
+    /// </summary>
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// <summary>
+    /// Returns true if there are no cells.
+    /// </summary>
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// <summary>
+    /// Returns the smallest rectangle containing all cells, which must not be called on an empty store.
+    /// The bounds are extended when cells are added and only recomputed on the next call
+    /// after a cell lying on one of their edges was removed. Like the other const methods,
+    /// this may be called by several threads at once, the recomputation is synchronized.
+    /// </summary>
+    const cell_bounds &bounds() const;
+
+    /// <summary>
+    /// Returns the populated columns of the given row, or nullptr if the row has no cells.
+    /// </summary>
+    const row_entries *row(row_t row) const;
+
+    /// <summary>
+    /// Returns the cell of the given row with the lowest column in [first_column, last_column]
+    /// or nullptr if there is none.
+    /// </summary>
+    const cell_impl *first_in_row(row_t row, column_t::index_t first_column, column_t::index_t last_column) const;
+
+    /// <summary>
+    /// Returns the cell of the given row with the highest column in [first_column, last_column]
+    /// or nullptr if there is none.
+    /// </summary>
+    const cell_impl *last_in_row(row_t row, column_t::index_t first_column, column_t::index_t last_column) const;
+
+    /// <summary>
+    /// Returns the cell of the given column with the lowest row in [first_row, last_row]
+    /// or nullptr if there is none. This is a binary search in column_order().
+    /// </summary>
+    const cell_impl *first_in_column(column_t::index_t column, row_t first_row, row_t last_row) const;
+
+    /// <summary>
+    /// Returns the cell of the given column with the highest row in [first_row, last_row]
+    /// or nullptr if there is none. This is a binary search in column_order().
+    /// </summary>
+    const cell_impl *last_in_column(column_t::index_t column, row_t first_row, row_t last_row) const;
+
+    /// <summary>
+    /// Returns all cells ordered by column and then by row. The order is sorted on the first call.
+    /// From then on, cells which are added or removed one by one are inserted into it or removed
+    /// from it. It is only sorted again after erase_if(), which may move cells.
+    /// </summary>
+    const std::vector<cell_impl *> &column_order() const;
+
+    /// <summary>
+    /// Calls visitor(row, entries) for each row which contains at least one cell,
+    /// in ascending row order.
+    /// </summary>
+    template <typename Visitor>
+    void for_each_row(Visitor &&visitor) const
+    {
+        for (const auto &block : blocks_)
+        {
+            auto first_row = static_cast<row_t>(block.first * rows_per_block + 1);
+
+            for (row_t offset = 0; offset < rows_per_block; ++offset)
+            {
+                const auto &row = block.second->rows[offset];
+
+                if (!row.empty())
+                {
+                    visitor(static_cast<row_t>(first_row + offset), row);
+                }
+            }
+        }
+    }
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    /// <summary>
+    /// Returns true if both stores contain equal cells at the same positions.
+    /// </summary>
+    bool operator==(const cell_store &other) const;
+
+    /// <summary>
+    /// Returns true if the stores differ.
+    /// </summary>
+    bool operator!=(const cell_store &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    struct row_block
+    {
+        row_entries rows[rows_per_block];
+        std::size_t cell_count = 0;
+    };
+
+    using block_list = std::vector<std::pair<row_t, std::unique_ptr<row_block>>>;
+
+    /// <summary>
+    /// A chunk of uninitialized storage for cells. Chunks are never reallocated.
+    /// </summary>
+    struct chunk
+    {
+        explicit chunk(std::size_t capacity);
+
+        std::unique_ptr<typename std::aligned_storage<sizeof(cell_impl), alignof(cell_impl)>::type[]> storage;
+        std::size_t capacity;
+        std::size_t used = 0;
+    };
+
+    row_block *find_block(row_t row) const;
+    row_block &find_or_create_block(row_t row);
+    void remove_empty_blocks();
+
+    static row_entries::iterator find_column(row_entries &row, column_t::index_t column);
+    static row_entries::const_iterator find_column(const row_entries &row, column_t::index_t column);
+
+    cell_impl *allocate(cell_impl &&value);
+    void release(cell_impl *cell);
+    void extend_bounds(column_t::index_t column, row_t row);
+    void shrink_bounds(column_t::index_t column, row_t row);
+    void add_to_column_order(cell_impl *cell);
+    void remove_from_column_order(const cell_impl *cell);
+    void copy_from(const cell_store &other);
+
+    block_list blocks_;
+    std::vector<chunk> chunks_;
+    std::vector<cell_impl *> free_cells_;
+    std::size_t size_ = 0;
+
+    // guards the recomputation of the caches below by const methods
+    mutable std::mutex cache_mutex_;
+
+    mutable cell_bounds bounds_;
+    mutable std::atomic<bool> bounds_valid_{false};
+
+    mutable std::vector<cell_impl *> column_order_;
+    mutable std::atomic<bool> column_order_valid_{false};
+
+    side_table<cell_extension> extensions_;
+    side_table<std::string> formulas_;
+    side_table<rich_text> texts_;
+    side_table<hyperlink_impl> hyperlinks_;
+
+    // the number of cells referring to each shared string of the workbook
+    std::vector<std::size_t> shared_string_references_;
+    std::size_t shared_string_count_ = 0;
+
+    template <bool is_const>
+    friend class cell_iterator_base;
+};
+
+/// <summary>
+/// Iterates over the cells of a cell_store in row-major order.
+/// </summary>
+template <bool is_const>
+class cell_store::cell_iterator_base
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = cell_impl;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::conditional<is_const, const cell_impl *, cell_impl *>::type;
+    using reference = typename std::conditional<is_const, const cell_impl &, cell_impl &>::type;
+    using store_pointer = typename std::conditional<is_const, const cell_store *, cell_store *>::type;
+
+    cell_iterator_base() = default;
+
+    cell_iterator_base(store_pointer store, std::size_t block, row_t row, std::size_t column)
+        : store_(store), block_(block), row_(row), column_(column)
+    {
+        skip_empty_rows();
+    }
+
+    operator cell_iterator_base<true>() const
+    {
+        return cell_iterator_base<true>(store_, block_, row_, column_);
+    }
+
+    reference operator*() const
+    {
+        return *store_->blocks_[block_].second->rows[row_][column_].second;
+    }
+
+    pointer operator->() const
+    {
+        return store_->blocks_[block_].second->rows[row_][column_].second;
+    }
+
+    cell_iterator_base &operator++()
+    {
+        ++column_;
+        skip_empty_rows();
+
+        return *this;
+    }
+
+    cell_iterator_base operator++(int)
+    {
+        auto old = *this;
+        ++(*this);
+
+        return old;
+    }
+
+    bool operator==(const cell_iterator_base &other) const
+    {
+        return block_ == other.block_ && row_ == other.row_ && column_ == other.column_;
+    }
+
+    bool operator!=(const cell_iterator_base &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    void skip_empty_rows()
+    {
+        while (block_ < store_->blocks_.size())
+        {
+            const auto &rows = store_->blocks_[block_].second->rows;
+
+            while (row_ < rows_per_block && column_ >= rows[row_].size())
+            {
+                ++row_;
+                column_ = 0;
+            }
+
+            if (row_ < rows_per_block)
+            {
+                return;
+            }
+
+            ++block_;
+            row_ = 0;
+        }
+
+        // normalize the end position
+        row_ = 0;
+        column_ = 0;
+    }
+
+    store_pointer store_ = nullptr;
+    std::size_t block_ = 0;
+    row_t row_ = 0;
+    std::size_t column_ = 0;
+};
+
+inline cell_store::iterator cell_store::begin()
+{
+    return iterator(this, 0, 0, 0);
+}
+
+inline cell_store::iterator cell_store::end()
+{
+    return iterator(this, blocks_.size(), 0, 0);
+}
+
+inline cell_store::const_iterator cell_store::begin() const
+{
+    return const_iterator(this, 0, 0, 0);
+}
+
+inline cell_store::const_iterator cell_store::end() const
+{
+    return const_iterator(this, blocks_.size(), 0, 0);
+}
+
+inline cell_store::const_iterator cell_store::cbegin() const
+{
+    return begin();
+}
+
+inline cell_store::const_iterator cell_store::cend() const
+{
+    return end();
+}
+
+} // namespace detail
+} // namespace xlnt
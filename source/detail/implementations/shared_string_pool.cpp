@@ -0,0 +1,468 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+
+#include <xlnt/utils/hash_combine.hpp>
+#include <detail/implementations/shared_string_pool.hpp>
+
+namespace xlnt {
+namespace detail {
+
+shared_string_pool::shared_string_pool(const shared_string_pool &other)
+    : entries_(other.entries_),
+      text_(other.text_),
+      rich_(other.rich_),
+      unused_text_(other.unused_text_),
+      values_(other.values_),
+      use_values_(other.use_values_),
+      positions_(other.positions_),
+      indexed_(other.indexed_)
+{
+}
+
+shared_string_pool &shared_string_pool::operator=(const shared_string_pool &other)
+{
+    if (this != &other)
+    {
+        entries_ = other.entries_;
+        text_ = other.text_;
+        rich_ = other.rich_;
+        unused_text_ = other.unused_text_;
+        values_ = other.values_;
+        use_values_ = other.use_values_;
+        positions_ = other.positions_;
+        indexed_ = other.indexed_;
+
+        std::lock_guard<std::mutex> lock(references_mutex_);
+        plain_references_.clear();
+    }
+
+    return *this;
+}
+
+std::size_t shared_string_pool::size() const
+{
+    return use_values_ ? values_.size() : entries_.size();
+}
+
+std::size_t shared_string_pool::push_back(const rich_text &text)
+{
+    if (use_values_)
+    {
+        values_.push_back(text);
+    }
+    else
+    {
+        entries_.push_back(make_entry(text));
+    }
+
+    return size() - 1;
+}
+
+void shared_string_pool::resize(std::size_t size)
+{
+    if (use_values_)
+    {
+        values_.resize(size);
+    }
+    else
+    {
+        entries_.resize(size, entry{text_.size(), 0, true, false});
+    }
+}
+
+void shared_string_pool::set(std::size_t index, const rich_text &text)
+{
+    if (use_values_)
+    {
+        values_.at(index) = text;
+    }
+    else if (is_plain(text))
+    {
+        const auto &run = text.runs_.front();
+        set_plain(index, run.first, run.preserve_space);
+    }
+    else
+    {
+        auto &e = entries_.at(index);
+
+        if (e.plain)
+        {
+            release(e);
+            e = make_entry(text);
+        }
+        else
+        {
+            rich_[static_cast<std::size_t>(e.offset)] = text;
+        }
+
+        forget_reference(index);
+    }
+
+    if (index < indexed_)
+    {
+        positions_.clear();
+        indexed_ = 0;
+    }
+}
+
+void shared_string_pool::set(std::size_t index, const std::string &plain_text, bool preserve_space)
+{
+    if (use_values_)
+    {
+        values_.at(index).plain_text(plain_text, preserve_space);
+    }
+    else
+    {
+        set_plain(index, plain_text, preserve_space);
+    }
+
+    if (index < indexed_)
+    {
+        positions_.clear();
+        indexed_ = 0;
+    }
+}
+
+bool shared_string_pool::is_plain(std::size_t index) const
+{
+    return use_values_ ? is_plain(values_.at(index)) : entries_.at(index).plain;
+}
+
+bool shared_string_pool::preserve_space(std::size_t index) const
+{
+    if (use_values_)
+    {
+        return is_plain(values_.at(index)) && values_[index].runs_.front().preserve_space;
+    }
+
+    return entries_.at(index).plain && entries_[index].preserve_space;
+}
+
+std::string shared_string_pool::plain_text(std::size_t index) const
+{
+    if (use_values_)
+    {
+        return values_.at(index).plain_text();
+    }
+
+    const auto &e = entries_.at(index);
+
+    return e.plain ? text_.substr(static_cast<std::size_t>(e.offset), e.length) : rich_[static_cast<std::size_t>(e.offset)].plain_text();
+}
+
+rich_text shared_string_pool::get(std::size_t index) const
+{
+    if (use_values_)
+    {
+        return values_.at(index);
+    }
+
+    const auto &e = entries_.at(index);
+
+    if (!e.plain)
+    {
+        return rich_[static_cast<std::size_t>(e.offset)];
+    }
+
+    rich_text text;
+    text.plain_text(plain_text(index), e.preserve_space);
+
+    return text;
+}
+
+const rich_text &shared_string_pool::at(std::size_t index) const
+{
+    if (use_values_)
+    {
+        return values_.at(index);
+    }
+
+    const auto &e = entries_.at(index);
+
+    if (!e.plain)
+    {
+        return rich_[static_cast<std::size_t>(e.offset)];
+    }
+
+    // references to the elements of an unordered_map stay valid when other elements are added
+    std::lock_guard<std::mutex> lock(references_mutex_);
+    auto match = plain_references_.find(index);
+
+    if (match == plain_references_.end())
+    {
+        match = plain_references_.emplace(index, get(index)).first;
+    }
+
+    return match->second;
+}
+
+std::size_t shared_string_pool::find(const rich_text &text)
+{
+    if (indexed_ > size())
+    {
+        positions_.clear();
+        indexed_ = 0;
+    }
+
+    for (; indexed_ < size(); ++indexed_)
+    {
+        positions_.emplace(hash(indexed_), indexed_);
+    }
+
+    auto result = size();
+    auto range = positions_.equal_range(hash(text));
+
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second < result && equals(iter->second, text))
+        {
+            result = iter->second;
+        }
+    }
+
+    return result;
+}
+
+std::vector<rich_text> &shared_string_pool::values()
+{
+    if (!use_values_)
+    {
+        values_.reserve(entries_.size());
+
+        for (std::size_t index = 0; index < entries_.size(); ++index)
+        {
+            values_.push_back(get(index));
+        }
+
+        entries_ = std::vector<entry>();
+        text_ = std::string();
+        rich_ = std::vector<rich_text>();
+        unused_text_ = 0;
+        use_values_ = true;
+
+        std::lock_guard<std::mutex> lock(references_mutex_);
+        plain_references_.clear();
+    }
+
+    return values_;
+}
+
+void shared_string_pool::clear()
+{
+    *this = shared_string_pool();
+}
+
+bool shared_string_pool::operator==(const shared_string_pool &other) const
+{
+    if (size() != other.size())
+    {
+        return false;
+    }
+
+    for (std::size_t index = 0; index < size(); ++index)
+    {
+        if (!use_values_ && !other.use_values_ && entries_[index].plain && other.entries_[index].plain)
+        {
+            const auto &e = entries_[index];
+            const auto &other_e = other.entries_[index];
+
+            if (e.length != other_e.length || e.preserve_space != other_e.preserve_space
+                || text_.compare(static_cast<std::size_t>(e.offset), e.length, other.text_, static_cast<std::size_t>(other_e.offset), other_e.length) != 0)
+            {
+                return false;
+            }
+        }
+        else if (get(index) != other.get(index))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool shared_string_pool::operator!=(const shared_string_pool &other) const
+{
+    return !(*this == other);
+}
+
+bool shared_string_pool::is_plain(const rich_text &text)
+{
+    return text.runs_.size() == 1 && !text.runs_.front().second.is_set()
+        && text.phonetic_runs_.empty() && !text.phonetic_properties_.is_set();
+}
+
+std::size_t shared_string_pool::hash(const char *text, std::size_t length)
+{
+    // FNV-1a
+    std::uint64_t result = 14695981039346656037ULL;
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        result = (result ^ static_cast<unsigned char>(text[i])) * 1099511628211ULL;
+    }
+
+    return static_cast<std::size_t>(result);
+}
+
+std::size_t shared_string_pool::hash(const rich_text &text)
+{
+    if (is_plain(text))
+    {
+        const auto &run = text.runs_.front().first;
+        return hash(run.data(), run.size());
+    }
+
+    std::size_t seed = 0;
+
+    for (const auto &run : text.runs_)
+    {
+        hash_combine(seed, hash(run.first.data(), run.first.size()));
+    }
+
+    return seed;
+}
+
+std::size_t shared_string_pool::hash(std::size_t index) const
+{
+    if (use_values_)
+    {
+        return hash(values_[index]);
+    }
+
+    const auto &e = entries_[index];
+
+    return e.plain ? hash(text_.data() + e.offset, e.length) : hash(rich_[static_cast<std::size_t>(e.offset)]);
+}
+
+bool shared_string_pool::equals(std::size_t index, const rich_text &text) const
+{
+    if (use_values_)
+    {
+        return values_[index] == text;
+    }
+
+    const auto &e = entries_[index];
+
+    if (!e.plain)
+    {
+        return rich_[static_cast<std::size_t>(e.offset)] == text;
+    }
+
+    if (!is_plain(text))
+    {
+        return false;
+    }
+
+    const auto &run = text.runs_.front();
+
+    return run.preserve_space == e.preserve_space
+        && text_.compare(static_cast<std::size_t>(e.offset), e.length, run.first) == 0;
+}
+
+shared_string_pool::entry shared_string_pool::make_entry(const rich_text &text)
+{
+    if (is_plain(text))
+    {
+        const auto &run = text.runs_.front();
+        const auto result = entry{text_.size(), static_cast<std::uint32_t>(run.first.size()), true, run.preserve_space};
+        text_.append(run.first);
+
+        return result;
+    }
+
+    rich_.push_back(text);
+
+    return entry{rich_.size() - 1, 0, false, false};
+}
+
+void shared_string_pool::set_plain(std::size_t index, const std::string &plain_text, bool preserve_space)
+{
+    auto &e = entries_.at(index);
+    const auto length = static_cast<std::uint32_t>(plain_text.size());
+
+    if (e.plain && length <= e.length)
+    {
+        std::copy(plain_text.begin(), plain_text.end(), text_.begin() + static_cast<std::ptrdiff_t>(e.offset));
+        unused_text_ += e.length - length;
+        e.length = length;
+        e.preserve_space = preserve_space;
+    }
+    else
+    {
+        release(e);
+        e = entry{text_.size(), length, true, preserve_space};
+        text_.append(plain_text);
+
+        if (unused_text_ > text_.size() / 2)
+        {
+            compact();
+        }
+    }
+
+    forget_reference(index);
+}
+
+void shared_string_pool::release(entry &e)
+{
+    if (e.plain)
+    {
+        unused_text_ += e.length;
+    }
+    else
+    {
+        // the slot isn't reused since the offsets of the other rich strings would change
+        rich_[static_cast<std::size_t>(e.offset)] = rich_text();
+    }
+}
+
+void shared_string_pool::forget_reference(std::size_t index)
+{
+    std::lock_guard<std::mutex> lock(references_mutex_);
+    plain_references_.erase(index);
+}
+
+void shared_string_pool::compact()
+{
+    std::string text;
+    text.reserve(text_.size() - unused_text_);
+
+    for (auto &e : entries_)
+    {
+        if (e.plain)
+        {
+            const auto offset = text.size();
+            text.append(text_, static_cast<std::size_t>(e.offset), e.length);
+            e.offset = offset;
+        }
+    }
+
+    text_.swap(text);
+    unused_text_ = 0;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,195 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/cell/rich_text.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The shared strings of a workbook. Strings which are plain text, a single run without
+/// a font or phonetic properties, are stored back to back in one buffer and referred to
+/// by offset and length instead of each owning a rich_text. Other strings are kept as rich_text.
+/// Once values() hands out all strings as a vector, which the caller may change, that
+/// vector is the storage of the pool.
+/// </summary>
+class XLNT_API_INTERNAL shared_string_pool
+{
+public:
+    shared_string_pool() = default;
+
+    /// <summary>
+    /// Copies don't take over the rich_text created by at(), they are created again when used.
+    /// </summary>
+    shared_string_pool(const shared_string_pool &other);
+
+    shared_string_pool &operator=(const shared_string_pool &other);
+
+    /// <summary>
+    /// Returns the number of strings.
+    /// </summary>
+    std::size_t size() const;
+
+    /// <summary>
+    /// Appends text and returns its index.
+    /// </summary>
+    std::size_t push_back(const rich_text &text);
+
+    /// <summary>
+    /// Appends empty strings up to the given size, which are replaced by set() later.
+    /// </summary>
+    void resize(std::size_t size);
+
+    /// <summary>
+    /// Replaces the string at index with text. Plain text which fits into the bytes of the
+    /// string it replaces is stored in their place, otherwise it is appended and the buffer
+    /// is compacted once more than half of it is unused.
+    /// </summary>
+    void set(std::size_t index, const rich_text &text);
+
+    /// <summary>
+    /// Replaces the string at index with plain text, like set(index, text).
+    /// </summary>
+    void set(std::size_t index, const std::string &plain_text, bool preserve_space);
+
+    /// <summary>
+    /// Returns true if the string at index is plain text.
+    /// </summary>
+    bool is_plain(std::size_t index) const;
+
+    /// <summary>
+    /// Returns true if the string at index is plain text whose whitespace is preserved.
+    /// </summary>
+    bool preserve_space(std::size_t index) const;
+
+    /// <summary>
+    /// Returns the text of the string at index without creating a rich_text for plain text.
+    /// </summary>
+    std::string plain_text(std::size_t index) const;
+
+    /// <summary>
+    /// Returns a copy of the string at index.
+    /// </summary>
+    rich_text get(std::size_t index) const;
+
+    /// <summary>
+    /// Returns a reference to the string at index, which stays valid until the string is replaced
+    /// or the pool is cleared. For plain text, this creates a rich_text which is kept by the pool,
+    /// so the library itself uses get() and plain_text() instead. This may be called by several
+    /// threads at once.
+    /// </summary>
+    const rich_text &at(std::size_t index) const;
+
+    /// <summary>
+    /// Returns the index of the first string which is equal to text, or size() if there is none.
+    /// Strings are hashed when they are first looked up, not when they are added.
+    /// </summary>
+    std::size_t find(const rich_text &text);
+
+    /// <summary>
+    /// Returns all strings as a vector, which is the storage of the pool from then on.
+    /// </summary>
+    std::vector<rich_text> &values();
+
+    /// <summary>
+    /// Removes all strings.
+    /// </summary>
+    void clear();
+
+    bool operator==(const shared_string_pool &other) const;
+
+    bool operator!=(const shared_string_pool &other) const;
+
+private:
+    struct entry
+    {
+        /// <summary>
+        /// The position of plain text in text_, otherwise of the string in rich_.
+        /// </summary>
+        std::uint64_t offset;
+        std::uint32_t length;
+        bool plain;
+        bool preserve_space;
+    };
+
+    static bool is_plain(const rich_text &text);
+
+    static std::size_t hash(const char *text, std::size_t length);
+
+    static std::size_t hash(const rich_text &text);
+
+    std::size_t hash(std::size_t index) const;
+
+    bool equals(std::size_t index, const rich_text &text) const;
+
+    entry make_entry(const rich_text &text);
+
+    void set_plain(std::size_t index, const std::string &plain_text, bool preserve_space);
+
+    void release(entry &e);
+
+    void forget_reference(std::size_t index);
+
+    void compact();
+
+    std::vector<entry> entries_;
+    std::string text_;
+    std::vector<rich_text> rich_;
+
+    /// <summary>
+    /// The number of bytes in text_ which no entry refers to anymore.
+    /// </summary>
+    std::size_t unused_text_ = 0;
+
+    /// <summary>
+    /// The rich_text created for plain strings by at(), guarded by references_mutex_.
+    /// </summary>
+    mutable std::unordered_map<std::size_t, rich_text> plain_references_;
+    mutable std::mutex references_mutex_;
+
+    /// <summary>
+    /// The storage once values() was called.
+    /// </summary>
+    std::vector<rich_text> values_;
+    bool use_values_ = false;
+
+    /// <summary>
+    /// Maps hashes to the indices of the strings with that hash, up to indexed_.
+    /// </summary>
+    std::unordered_multimap<std::size_t, std::size_t> positions_;
+    std::size_t indexed_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,351 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <detail/implementations/format_impl.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/hash_combine.hpp>
+#include <xlnt/utils/optional.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Hash index over one of the component pools of a stylesheet (fonts, fills, ...).
+/// Only the first of several equal items is indexed, which keeps find() returning
+/// the same position as a linear search would.
+/// Items appended to the pool are picked up lazily by the next find(). Anything else
+/// which changes existing positions, like garbage collection, has to call clear().
+/// </summary>
+template <typename T>
+class pool_index
+{
+public:
+    /// <summary>
+    /// Returns the position of the first item in pool that is equal to item,
+    /// or pool.size() if there is none.
+    /// </summary>
+    std::size_t find(const std::vector<T> &pool, const T &item)
+    {
+        catch_up(pool);
+
+        auto range = positions_.equal_range(std::hash<T>()(item));
+
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (pool[iter->second] == item)
+            {
+                return iter->second;
+            }
+        }
+
+        return pool.size();
+    }
+
+    /// <summary>
+    /// Forgets all indexed positions.
+    /// </summary>
+    void clear()
+    {
+        positions_.clear();
+        indexed_ = 0;
+    }
+
+private:
+    void catch_up(const std::vector<T> &pool)
+    {
+        if (indexed_ > pool.size())
+        {
+            clear();
+        }
+
+        for (; indexed_ < pool.size(); ++indexed_)
+        {
+            const auto &item = pool[indexed_];
+            const auto hash = std::hash<T>()(item);
+            auto range = positions_.equal_range(hash);
+            auto duplicate = false;
+
+            for (auto iter = range.first; iter != range.second && !duplicate; ++iter)
+            {
+                duplicate = pool[iter->second] == item;
+            }
+
+            if (!duplicate)
+            {
+                positions_.emplace(hash, indexed_);
+            }
+        }
+    }
+
+    std::unordered_multimap<std::size_t, std::size_t> positions_;
+    std::size_t indexed_ = 0;
+};
+
+/// <summary>
+/// Hash index over the formats of a stylesheet, keyed by the same properties
+/// which format_impl::operator== compares.
+/// Formats which are changed in place have to be passed to update().
+/// Whenever the index loses track of the list, e.g. after formats were appended
+/// directly while reading a file, it is rebuilt by the next find().
+/// </summary>
+class format_impl_index
+{
+public:
+    format_impl_index() = default;
+
+    // A copy belongs to another stylesheet and is rebuilt from its formats on first use
+    format_impl_index(const format_impl_index & /*other*/)
+    {
+    }
+
+    format_impl_index(format_impl_index &&other) = default;
+
+    format_impl_index &operator=(const format_impl_index & /*other*/)
+    {
+        clear();
+        return *this;
+    }
+
+    format_impl_index &operator=(format_impl_index &&other) = default;
+
+    /// <summary>
+    /// Returns the format with the lowest id in formats which is equal to pattern,
+    /// or nullptr if there is none. The format skip is never returned.
+    /// </summary>
+    format_impl *find(const format_impl &pattern, std::list<format_impl_list_item> &formats,
+        const format_impl *skip = nullptr)
+    {
+        if (hashes_.size() != formats.size())
+        {
+            rebuild(formats);
+        }
+
+        format_impl *result = nullptr;
+        auto range = formats_.equal_range(hash(pattern));
+
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second != skip && *iter->second == pattern
+                && (result == nullptr || iter->second->id < result->id))
+            {
+                result = iter->second;
+            }
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Adds a format which was appended to the list of formats.
+    /// </summary>
+    void insert(format_impl *impl)
+    {
+        const auto impl_hash = hash(*impl);
+        hashes_.emplace(impl, impl_hash);
+        formats_.emplace(impl_hash, impl);
+    }
+
+    /// <summary>
+    /// Removes a format before it is erased from the list of formats.
+    /// </summary>
+    void erase(format_impl *impl)
+    {
+        auto found = hashes_.find(impl);
+
+        if (found == hashes_.end())
+        {
+            // The index is already out of date, make sure it's rebuilt
+            clear();
+            return;
+        }
+
+        auto range = formats_.equal_range(found->second);
+
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second == impl)
+            {
+                formats_.erase(iter);
+                break;
+            }
+        }
+
+        hashes_.erase(found);
+    }
+
+    /// <summary>
+    /// Re-hashes a format after its properties were changed in place.
+    /// </summary>
+    void update(format_impl *impl)
+    {
+        if (hashes_.find(impl) == hashes_.end())
+        {
+            return;
+        }
+
+        erase(impl);
+        insert(impl);
+    }
+
+    /// <summary>
+    /// Forgets all indexed formats.
+    /// </summary>
+    void clear()
+    {
+        hashes_.clear();
+        formats_.clear();
+    }
+
+private:
+    void rebuild(std::list<format_impl_list_item> &formats)
+    {
+        clear();
+
+        for (auto &item : formats)
+        {
+            insert(&*item);
+        }
+    }
+
+    template <typename T>
+    static void hash_optional(std::size_t &seed, const optional<T> &value)
+    {
+        hash_combine(seed, value.is_set());
+
+        if (value.is_set())
+        {
+            hash_combine(seed, value.get());
+        }
+    }
+
+    static std::size_t hash(const format_impl &impl)
+    {
+        std::size_t seed = 0;
+
+        hash_optional(seed, impl.alignment_id);
+        hash_optional(seed, impl.border_id);
+        hash_optional(seed, impl.fill_id);
+        hash_optional(seed, impl.font_id);
+        hash_optional(seed, impl.number_format_id);
+        hash_optional(seed, impl.protection_id);
+
+        hash_optional(seed, impl.alignment_applied);
+        hash_optional(seed, impl.border_applied);
+        hash_optional(seed, impl.fill_applied);
+        hash_optional(seed, impl.font_applied);
+        hash_optional(seed, impl.number_format_applied);
+        hash_optional(seed, impl.protection_applied);
+
+        hash_combine(seed, impl.pivot_button_);
+        hash_combine(seed, impl.quote_prefix_);
+
+        hash_optional(seed, impl.style);
+
+        return seed;
+    }
+
+    std::unordered_map<const format_impl *, std::size_t> hashes_;
+    std::unordered_multimap<std::size_t, format_impl *> formats_;
+};
+
+/// <summary>
+/// Random access to the formats of a stylesheet by id, next to the list which owns them.
+/// Formats appended by the stylesheet are added with push_back(). When the table is
+/// out of step with the list otherwise, it is rebuilt by the next at().
+/// </summary>
+class format_impl_table
+{
+public:
+    format_impl_table() = default;
+
+    // A copy belongs to another stylesheet and is rebuilt from its formats on first use
+    format_impl_table(const format_impl_table & /*other*/)
+    {
+    }
+
+    format_impl_table(format_impl_table &&other) = default;
+
+    format_impl_table &operator=(const format_impl_table & /*other*/)
+    {
+        clear();
+        return *this;
+    }
+
+    format_impl_table &operator=(format_impl_table &&other) = default;
+
+    /// <summary>
+    /// Returns the format at the given position of formats.
+    /// Throws invalid_parameter if there is no such format.
+    /// </summary>
+    format_impl *at(std::size_t index, std::list<format_impl_list_item> &formats)
+    {
+        if (formats_.size() != formats.size())
+        {
+            formats_.clear();
+            formats_.reserve(formats.size());
+
+            for (auto &item : formats)
+            {
+                formats_.push_back(&*item);
+            }
+        }
+
+        if (index >= formats_.size())
+        {
+            throw invalid_parameter("format index " + std::to_string(index) + " is out of range");
+        }
+
+        return formats_[index];
+    }
+
+    /// <summary>
+    /// Adds a format which was appended to the list of formats.
+    /// </summary>
+    void push_back(format_impl *impl)
+    {
+        formats_.push_back(impl);
+    }
+
+    /// <summary>
+    /// Forgets all formats, e.g. after formats were removed from the list.
+    /// </summary>
+    void clear()
+    {
+        formats_.clear();
+    }
+
+private:
+    std::vector<format_impl *> formats_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -27,11 +27,14 @@
 #include <algorithm>
 #include <list>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <detail/implementations/conditional_format_impl.hpp>
 #include <detail/implementations/format_impl.hpp>
 #include <detail/implementations/style_impl.hpp>
+#include <detail/implementations/style_index.hpp>
+#include <detail/number_format/number_format_cache.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/styles/conditional_format.hpp>
 #include <xlnt/styles/format.hpp>
@@ -56,6 +59,8 @@ struct stylesheet
 
 		impl->parent = this;
 		impl->id = format_impls.size() - 1;
+        format_index.insert(&*impl);
+        format_table.push_back(&*impl);
 
         if (default_format)
             this->default_format_impl = impl;
@@ -70,13 +75,11 @@ struct stylesheet
 
     /// <summary>
     /// Returns a wrapper pointing to the format at the given index.
+    /// If there is no format at the index, an invalid_parameter exception will be thrown.
     /// </summary>
     class xlnt::format format(std::size_t index)
     {
-        auto iter = format_impls.begin();
-        std::advance(iter, static_cast<std::list<format_impl>::difference_type>(index));
-
-        return xlnt::format(*iter);
+        return xlnt::format(format_table.at(index, format_impls));
     }
 
     /// <summary>
@@ -215,19 +218,19 @@ struct stylesheet
 		return id;
 	}
 
-    template<typename T, typename C>
-    std::size_t find_or_add(C &container, const T &item)
+    /// <summary>
+    /// Returns the position of item in container, which has to be one of the
+    /// component pools of this stylesheet. The item is appended if it isn't found.
+    /// </summary>
+    template<typename T>
+    std::size_t find_or_add(std::vector<T> &container, const T &item)
     {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wsign-conversion"
-        auto iter = std::find(container.begin(), container.end(), item);
-        if (iter != container.end())
+        auto position = std::get<pool_index<T>>(pool_indexes).find(container, item);
+        if (position == container.size())
         {
-            return std::size_t(iter - container.begin());
+            container.push_back(item);
         }
-        iter = container.emplace(container.end(), item);
-        return std::size_t(iter - container.begin());
-#pragma GCC diagnostic pop
+        return position;
     }
 
     template<typename T>
@@ -251,6 +254,11 @@ struct stylesheet
             }
         }
 
+        if (unreferenced > 0)
+        {
+            std::get<pool_index<T>>(pool_indexes).clear();
+        }
+
         return id_map;
     }
 
@@ -269,6 +277,8 @@ struct stylesheet
             }
             else
             {
+                format_index.erase(&impl);
+                format_table.clear();
                 format_iter = format_impls.erase(format_iter);
             }
         }
@@ -362,6 +372,18 @@ struct stylesheet
         auto font_id_map = garbage_collect(font_reference_counts, fonts);
         auto protection_id_map = garbage_collect(protection_reference_counts, protections);
 
+        auto renumbered = [](const std::unordered_map<std::size_t, std::size_t> &id_map) {
+            return std::any_of(id_map.begin(), id_map.end(),
+                [](const std::pair<const std::size_t, std::size_t> &ids) { return ids.first != ids.second; });
+        };
+
+        // the formats are re-hashed with their new component ids by the next find()
+        if (renumbered(alignment_id_map) || renumbered(border_id_map) || renumbered(fill_id_map)
+            || renumbered(font_id_map) || renumbered(protection_id_map))
+        {
+            format_index.clear();
+        }
+
         for (auto &format_item : format_impls)
         {
             auto& impl = *format_item;
@@ -425,46 +447,61 @@ struct stylesheet
 
     format_impl_ptr find_or_create(format_impl &pattern)
     {
-        std::size_t id = 0;
-        auto iter = format_impls.begin();
-        while (iter != format_impls.end() && !(**iter == pattern))
+        auto existing = format_index.find(pattern, format_impls);
+        if (existing != nullptr)
         {
-            ++id;
-            ++iter;
+            existing->parent = this;
+            return existing;
         }
-        if (iter == format_impls.end())
-        {
-            iter = format_impls.emplace(format_impls.end(), pattern);
-        }
-        auto &result = *iter;
+
+        format_impls.emplace_back(pattern);
+        auto &result = format_impls.back();
 
         result->parent = this;
-        result->id = id;
+        result->id = format_impls.size() - 1;
+        format_index.insert(&*result);
+        format_table.push_back(&*result);
 
         return result;
     }
 
-    format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const std::string &style_name)
+    /// <summary>
+    /// Returns a format equal to new_format, which was derived from the format pattern points to.
+    /// Another equal format is preferred. Otherwise the pattern itself is changed if nothing else
+    /// uses it, or a new format is created.
+    /// </summary>
+    format_impl_ptr find_or_create_from(format_impl_ptr &pattern, format_impl &new_format)
     {
-        format_impl new_format = *pattern;
-        new_format.style = style_name;
-        if (!pattern->is_shared())
+        auto existing = format_index.find(new_format, format_impls, pattern.get());
+        if (existing != nullptr)
+        {
+            existing->parent = this;
+            return existing;
+        }
+
+        if (!pattern->is_shared() || *pattern == new_format)
         {
             *pattern = new_format;
+            format_index.update(pattern.get());
+            return pattern;
         }
+
         return find_or_create(new_format);
     }
 
+    format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const std::string &style_name)
+    {
+        format_impl new_format = *pattern;
+        new_format.style = style_name;
+        return find_or_create_from(pattern, new_format);
+    }
+
     format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const alignment &new_alignment, optional<bool> applied)
     {
         format_impl new_format = *pattern;
         new_format.alignment_id = find_or_add(alignments, new_alignment);
         new_format.alignment_applied = applied;
-        if (!pattern->is_shared())
-        {
-            *pattern = new_format;
-        }
-        return find_or_create(new_format);
+        return find_or_create_from(pattern, new_format);
     }
 
     format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const border &new_border, optional<bool> applied)
@@ -472,11 +509,7 @@ struct stylesheet
         format_impl new_format = *pattern;
         new_format.border_id = find_or_add(borders, new_border);
         new_format.border_applied = applied;
-        if (!pattern->is_shared())
-        {
-            *pattern = new_format;
-        }
-        return find_or_create(new_format);
+        return find_or_create_from(pattern, new_format);
     }
 
     format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const fill &new_fill, optional<bool> applied)
@@ -484,11 +517,7 @@ struct stylesheet
         format_impl new_format = *pattern;
         new_format.fill_id = find_or_add(fills, new_fill);
         new_format.fill_applied = applied;
-        if (!pattern->is_shared())
-        {
-            *pattern = new_format;
-        }
-        return find_or_create(new_format);
+        return find_or_create_from(pattern, new_format);
     }
 
     format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const font &new_font, optional<bool> applied)
@@ -496,11 +525,7 @@ struct stylesheet
         format_impl new_format = *pattern;
         new_format.font_id = find_or_add(fonts, new_font);
         new_format.font_applied = applied;
-        if (!pattern->is_shared())
-        {
-            *pattern = new_format;
-        }
-        return find_or_create(new_format);
+        return find_or_create_from(pattern, new_format);
     }
 
     format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const number_format &new_number_format, optional<bool> applied)
@@ -512,21 +537,17 @@ struct stylesheet
         }
         else
         {
-            auto iter = std::find(number_formats.begin(), number_formats.end(), new_number_format);
-            if (iter == number_formats.end())
+            auto position = std::get<pool_index<number_format>>(pool_indexes).find(number_formats, new_number_format);
+            if (position == number_formats.size())
             {
                 std::size_t new_id = next_custom_number_format_id();
-                iter = number_formats.emplace(number_formats.end(), new_number_format);
-                iter->id(new_id);
+                number_formats.push_back(new_number_format);
+                number_formats.back().id(new_id);
             }
-            new_format.number_format_id = iter->id();
+            new_format.number_format_id = number_formats[position].id();
         }
         new_format.number_format_applied = applied;
-        if (!pattern->is_shared())
-        {
-            *pattern = new_format;
-        }
-        return find_or_create(new_format);
+        return find_or_create_from(pattern, new_format);
     }
 
     format_impl_ptr find_or_create_with(format_impl_ptr& pattern, const protection &new_protection, optional<bool> applied)
@@ -534,11 +555,7 @@ struct stylesheet
         format_impl new_format = *pattern;
         new_format.protection_id = find_or_add(protections, new_protection);
         new_format.protection_applied = applied;
-        if (!pattern->is_shared())
-        {
-            *pattern = new_format;
-        }
-        return find_or_create(new_format);
+        return find_or_create_from(pattern, new_format);
     }
 
     std::size_t style_index(const std::string &name) const
@@ -563,6 +580,10 @@ struct stylesheet
         protections.clear();
 
         colors.clear();
+
+        format_index.clear();
+        format_table.clear();
+        pool_indexes = decltype(pool_indexes)();
     }
 
     /// <summary>
@@ -637,6 +658,20 @@ struct stylesheet
 	std::vector<protection> protections;
 
     std::vector<color> colors;
+
+    /// <summary>
+    /// Indexes which keep format(), find_or_create and find_or_add from scanning
+    /// all formats and components. They are not part of the stylesheet's value.
+    /// </summary>
+    format_impl_index format_index;
+    format_impl_table format_table;
+    std::tuple<pool_index<alignment>, pool_index<border>, pool_index<fill>,
+        pool_index<font>, pool_index<number_format>, pool_index<protection>> pool_indexes;
+
+    /// <summary>
+    /// The number formats which were compiled to format cell values, like for cell::to_string().
+    /// </summary>
+    number_format_cache compiled_number_formats;
 };
 
 } // namespace detail
@@ -23,15 +23,24 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <istream>
+#include <limits>
 #include <list>
+#include <memory>
+#include <streambuf>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <detail/formula/calculation_engine.hpp>
+#include <detail/implementations/shared_string_pool.hpp>
 #include <detail/implementations/stylesheet.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
+#include <detail/serialization/defined_name.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <xlnt/packaging/ext_list.hpp>
 #include <xlnt/packaging/manifest.hpp>
+#include <xlnt/packaging/relationship.hpp>
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/variant.hpp>
 #include <xlnt/workbook/calculation_properties.hpp>
@@ -46,6 +55,56 @@ namespace detail {
 
 struct worksheet_impl;
 
+/// <summary>
+/// The package of a workbook loaded with workbook::lazy_loading(), which is kept until
+/// the parts of all of its worksheets have been read.
+/// </summary>
+struct pending_worksheets
+{
+    std::vector<std::uint8_t> data;
+    std::unique_ptr<std::streambuf> buffer;
+    std::unique_ptr<std::istream> stream;
+    std::shared_ptr<izstream> archive;
+
+    relationship workbook_rel;
+    std::vector<defined_name> defined_names;
+
+    /// <summary>
+    /// The relationships of the worksheets whose parts haven't been read yet, in workbook order.
+    /// </summary>
+    std::vector<std::pair<relationship, worksheet_impl *>> worksheets;
+
+    /// <summary>
+    /// True while the parts of some of the worksheets are being read.
+    /// </summary>
+    bool reading = false;
+};
+
+/// <summary>
+/// The shared string table of a workbook loaded with workbook::lazy_shared_strings().
+/// Its entries are decoded from the inflated part the first time they are accessed.
+/// </summary>
+struct pending_shared_strings
+{
+    std::string part_path;
+    std::vector<std::uint8_t> data;
+
+    /// <summary>
+    /// The end of the start tag of <sst> and the beginning of its end tag in data.
+    /// The entries are parsed between the two, so that they see the namespace declarations.
+    /// </summary>
+    std::size_t header_end = 0;
+    std::size_t footer_begin = 0;
+
+    /// <summary>
+    /// The first and one past the last byte of each <si> element in data.
+    /// </summary>
+    std::vector<std::pair<std::size_t, std::size_t>> entries;
+
+    std::vector<bool> decoded;
+    std::size_t remaining = 0;
+};
+
 struct workbook_impl
 {
     workbook_impl() : base_date_(calendar::windows_1900)
@@ -55,8 +114,9 @@ struct workbook_impl
     workbook_impl(const workbook_impl &other)
         : active_sheet_index_(other.active_sheet_index_),
           worksheets_(other.worksheets_),
-          shared_strings_ids_(other.shared_strings_ids_),
-          shared_strings_values_(other.shared_strings_values_),
+          shared_strings_(other.shared_strings_),
+          pending_shared_strings_(other.pending_shared_strings_ == nullptr ? nullptr
+              : new pending_shared_strings(*other.pending_shared_strings_)),
           stylesheet_(other.stylesheet_),
           manifest_(other.manifest_),
           theme_(other.theme_),
@@ -65,7 +125,16 @@ struct workbook_impl
           custom_properties_(other.custom_properties_),
           view_(other.view_),
           code_name_(other.code_name_),
-          file_version_(other.file_version_)
+          file_version_(other.file_version_),
+          zip_buffer_size_(other.zip_buffer_size_),
+          memory_mapped_loading_(other.memory_mapped_loading_),
+          load_thread_count_(other.load_thread_count_),
+          calculation_thread_count_(other.calculation_thread_count_),
+          lazy_loading_(other.lazy_loading_),
+          lazy_shared_strings_(other.lazy_shared_strings_),
+          load_columns_(other.load_columns_),
+          load_first_row_(other.load_first_row_),
+          load_last_row_(other.load_last_row_)
     {
     }
 
@@ -74,8 +143,9 @@ struct workbook_impl
         active_sheet_index_ = other.active_sheet_index_;
         worksheets_.clear();
         std::copy(other.worksheets_.begin(), other.worksheets_.end(), back_inserter(worksheets_));
-        shared_strings_ids_ = other.shared_strings_ids_;
-        shared_strings_values_ = other.shared_strings_values_;
+        shared_strings_ = other.shared_strings_;
+        pending_shared_strings_.reset(other.pending_shared_strings_ == nullptr ? nullptr
+            : new pending_shared_strings(*other.pending_shared_strings_));
         theme_ = other.theme_;
         manifest_ = other.manifest_;
 
@@ -89,6 +159,8 @@ struct workbook_impl
         extended_properties_ = other.extended_properties_;
         custom_properties_ = other.custom_properties_;
 
+        calculation_engine_.reset();
+
         return *this;
     }
 
@@ -97,7 +169,7 @@ struct workbook_impl
         // not comparing abs_path_
         return active_sheet_index_ == other.active_sheet_index_
             && worksheets_ == other.worksheets_
-            && shared_strings_ids_ == other.shared_strings_ids_
+            && shared_strings_ == other.shared_strings_
             && stylesheet_ == other.stylesheet_
             && base_date_ == other.base_date_
             && title_ == other.title_
@@ -126,8 +198,10 @@ struct workbook_impl
     optional<std::size_t> active_sheet_index_;
 
     std::list<worksheet_impl> worksheets_;
-    std::unordered_map<rich_text, std::size_t, rich_text_hash> shared_strings_ids_;
-    std::vector<rich_text> shared_strings_values_;
+    shared_string_pool shared_strings_;
+
+    // entries of shared_strings_ which haven't been decoded yet, see workbook::lazy_shared_strings()
+    std::unique_ptr<pending_shared_strings> pending_shared_strings_;
 
     optional<stylesheet> stylesheet_;
 
@@ -175,6 +249,24 @@ struct workbook_impl
     optional<std::string> abs_path_;
     optional<std::size_t> arch_id_flags_;
     optional<ext_list> extensions_;
+
+    // not assigned by operator=, so that these survive clear() when loading
+    std::size_t zip_buffer_size_ = default_zip_buffer_size;
+    bool memory_mapped_loading_ = false;
+    std::size_t load_thread_count_ = 1;
+    std::size_t calculation_thread_count_ = 1;
+    bool lazy_loading_ = false;
+    bool lazy_shared_strings_ = false;
+    std::vector<column_t> load_columns_;
+    row_t load_first_row_ = 1;
+    row_t load_last_row_ = std::numeric_limits<row_t>::max();
+
+    // worksheets which are read on first access, see workbook::lazy_loading().
+    // Never copied, since it refers to the worksheets of this workbook.
+    std::unique_ptr<pending_worksheets> pending_worksheets_;
+
+    // created by workbook::calculate() and never copied, since it refers to the worksheets of this workbook
+    std::unique_ptr<calculation_engine> calculation_engine_;
 };
 
 } // namespace detail
@@ -42,6 +42,7 @@
 #include <xlnt/worksheet/print_options.hpp>
 #include <xlnt/worksheet/sheet_pr.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/cell_store.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 
 namespace xlnt {
@@ -50,6 +51,8 @@ class workbook;
 
 namespace detail {
 
+class calculation_engine;
+
 struct worksheet_impl
 {
     worksheet_impl(workbook *parent_workbook, std::size_t id, const std::string &title)
@@ -93,7 +96,7 @@ struct worksheet_impl
 
         for (auto &cell : cell_map_)
         {
-            cell.second.parent_ = this;
+            cell.parent_ = this;
         }
     }
 
@@ -138,7 +141,7 @@ struct worksheet_impl
     std::unordered_map<column_t, column_properties> column_properties_;
     std::unordered_map<row_t, row_properties> row_properties_;
 
-    std::unordered_map<cell_reference, cell_impl> cell_map_;
+    cell_store cell_map_;
 
     optional<page_setup> page_setup_;
     optional<range_reference> auto_filter_;
@@ -166,6 +169,10 @@ struct worksheet_impl
 
     std::string drawing_rel_id_;
     optional<drawing::spreadsheet_drawing> drawing_;
+
+    // the calculation engine of the workbook which is notified of changed cells, if there is one.
+    // Not assigned by operator=, the engine notices copied worksheets itself.
+    calculation_engine *calculation_engine_ = nullptr;
 };
 
 } // namespace detail
@@ -0,0 +1,74 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <detail/number_format/number_format_cache.hpp>
+
+namespace xlnt {
+namespace detail {
+
+number_format_cache::number_format_cache(const number_format_cache & /*other*/)
+{
+}
+
+number_format_cache &number_format_cache::operator=(const number_format_cache & /*other*/)
+{
+    clear();
+
+    return *this;
+}
+
+std::shared_ptr<const number_formatter> number_format_cache::formatter(const std::string &format_string, calendar base_date)
+{
+    auto &formatters = formatters_[base_date == calendar::mac_1904 ? 1 : 0];
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto match = formatters.find(format_string);
+
+        if (match != formatters.end())
+        {
+            return match->second;
+        }
+    }
+
+    // compiled without holding the lock, if another thread was faster its result is kept
+    auto compiled = std::make_shared<const number_formatter>(format_string, base_date);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return formatters.emplace(format_string, std::move(compiled)).first->second;
+}
+
+void number_format_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto &formatters : formatters_)
+    {
+        formatters.clear();
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,78 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <xlnt/utils/calendar.hpp>
+#include <detail/number_format/number_formatter.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The number formats of a workbook, compiled once and kept by its stylesheet so that
+/// formatting many cells doesn't parse the same format string for each of them.
+/// A compiled format isn't changed after it is created, so it may be used by several
+/// threads at once. Looking formats up is synchronized.
+/// </summary>
+class XLNT_API_INTERNAL number_format_cache
+{
+public:
+    number_format_cache() = default;
+
+    /// <summary>
+    /// Copies start out empty, the formats are compiled again when they are used.
+    /// </summary>
+    number_format_cache(const number_format_cache &other);
+
+    number_format_cache &operator=(const number_format_cache &other);
+
+    /// <summary>
+    /// Returns the compiled format_string for the given calendar, compiling it if this is the first use.
+    /// Throws like number_formatter if format_string is invalid.
+    /// </summary>
+    std::shared_ptr<const number_formatter> formatter(const std::string &format_string, calendar base_date);
+
+    /// <summary>
+    /// Removes all compiled formats.
+    /// </summary>
+    void clear();
+
+private:
+    std::mutex mutex_;
+
+    /// <summary>
+    /// The compiled formats by format string, indexed by calendar.
+    /// </summary>
+    std::unordered_map<std::string, std::shared_ptr<const number_formatter>> formatters_[2];
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <iterator>
 #include <unordered_map>
 
 #include <xlnt/utils/exceptions.hpp>
@@ -492,6 +493,30 @@ void unhandled_case(bool error, const std::string &unhandled_case)
     }
 }
 
+// Appends value to result, padded with zeros after the sign to at least width characters like "{:0{width}d}".
+template <typename T>
+void append_integer(std::string &result, T value, std::size_t width = 0)
+{
+    const auto formatted = fmt::format_int(value);
+    auto digits = formatted.data();
+    auto size = formatted.size();
+
+    if (size < width)
+    {
+        if (*digits == '-')
+        {
+            result.push_back('-');
+            ++digits;
+            --size;
+            --width;
+        }
+
+        result.append(width - size, '0');
+    }
+
+    result.append(digits, size);
+}
+
 } // namespace
 
 namespace xlnt {
@@ -1491,31 +1516,46 @@ number_formatter::number_formatter(const std::string &format_string, xlnt::calen
     format_ = parser_.result();
 }
 
-std::string number_formatter::format_number(double number)
+std::string number_formatter::format_number(double number) const
+{
+    std::string result;
+    format_number(number, result);
+
+    return result;
+}
+
+void number_formatter::format_number(double number, std::string &result) const
 {
+    result.clear();
+
     if (format_[0].has_condition)
     {
         if (format_[0].condition.satisfied_by(number))
         {
-            return format_number(format_[0], number);
+            format_number(format_[0], number, result);
+            return;
         }
 
         if (format_.size() == 1)
         {
-            return std::string(11, '#');
+            result.assign(11, '#');
+            return;
         }
 
         if (!format_[1].has_condition || format_[1].condition.satisfied_by(number))
         {
-            return format_number(format_[1], number);
+            format_number(format_[1], number, result);
+            return;
         }
 
         if (format_.size() == 2)
         {
-            return std::string(11, '#');
+            result.assign(11, '#');
+            return;
         }
 
-        return format_number(format_[2], number);
+        format_number(format_[2], number, result);
+        return;
     }
 
     // no conditions, format based on sign:
@@ -1523,18 +1563,18 @@ std::string number_formatter::format_number(double number)
     // 1 section, use for all
     if (format_.size() == 1)
     {
-        return format_number(format_[0], number);
+        format_number(format_[0], number, result);
     }
     // 2 sections, first for positive and zero, second for negative
     else if (format_.size() == 2)
     {
         if (number >= 0)
         {
-            return format_number(format_[0], number);
+            format_number(format_[0], number, result);
         }
         else
         {
-            return format_number(format_[1], std::fabs(number));
+            format_number(format_[1], std::fabs(number), result);
         }
     }
     // 3+ sections, first for positive, second for negative, third for zero
@@ -1542,42 +1582,37 @@ std::string number_formatter::format_number(double number)
     {
         if (number > 0)
         {
-            return format_number(format_[0], number);
+            format_number(format_[0], number, result);
         }
         else if (number < 0)
         {
-            return format_number(format_[1], std::fabs(number));
+            format_number(format_[1], std::fabs(number), result);
         }
         else
         {
-            return format_number(format_[2], number);
+            format_number(format_[2], number, result);
         }
     }
 }
 
-std::string number_formatter::format_text(const std::string &text)
+std::string number_formatter::format_text(const std::string &text) const
 {
     if (format_.size() < 4)
     {
-        format_code temp;
-        template_part temp_part;
-        temp_part.type = template_part::template_type::general;
-        temp_part.placeholders.type = format_placeholders::placeholders_type::general;
-        temp.parts.push_back(temp_part);
-        return format_text(temp, text);
+        // the implicit text section is "@" which shows the text unchanged
+        return text;
     }
 
     return format_text(format_[3], text);
 }
 
-std::string number_formatter::fill_placeholders(const format_placeholders &p, double number)
+void number_formatter::fill_placeholders(const format_placeholders &p, double number, std::string &result) const
 {
-    std::string result;
-
     if (p.type == format_placeholders::placeholders_type::general
         || p.type == format_placeholders::placeholders_type::text)
     {
-        return fmt::format("{}", number);
+        fmt::format_to(std::back_inserter(result), "{}", number);
+        return;
     }
 
     if (p.percentage)
@@ -1591,36 +1626,39 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, do
     }
 
     auto integer_part = static_cast<long long>(number);
+    const auto start = result.size();
 
     if (p.type == format_placeholders::placeholders_type::integer_only
         || p.type == format_placeholders::placeholders_type::integer_part
         || p.type == format_placeholders::placeholders_type::fraction_integer)
     {
         // Format with leading zeros (if necessary).
-        result = fmt::format("{:0{}d}", integer_part, p.num_zeros);
+        append_integer(result, integer_part, p.num_zeros);
 
-        if (result.size() < p.num_zeros + p.num_spaces)
+        if (result.size() - start < p.num_zeros + p.num_spaces)
         {
             // Add leading spaces.
-            result.insert(static_cast<size_t>(0), p.num_zeros + p.num_spaces - result.size(), ' ');
+            result.insert(start, p.num_zeros + p.num_spaces - (result.size() - start), ' ');
         }
 
         if (p.use_comma_separator)
         {
-            std::vector<char> digits(result.rbegin(), result.rend());
-            std::string temp;
+            // Insert a comma before every group of three digits, counted from the right.
+            // Characters are moved from the back so this works in place.
+            const auto digits = result.size() - start;
+            auto source = result.size();
+            result.resize(result.size() + digits / 3);
+            auto destination = result.size();
 
-            for (std::size_t i = 0; i < digits.size(); i++)
+            for (std::size_t i = 0; i < digits; i++)
             {
-                temp.push_back(digits[i]);
+                result[--destination] = result[--source];
 
                 if (i % 3 == 2)
                 {
-                    temp.push_back(',');
+                    result[--destination] = ',';
                 }
             }
-
-            result = std::string(temp.rbegin(), temp.rend());
         }
 
         if (p.percentage && p.type == format_placeholders::placeholders_type::integer_only)
@@ -1633,20 +1671,20 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, do
         auto fractional_part = number - integer_part;
 
         // Format with zeros.
-        result = fmt::format("{:.{}f}", fractional_part, p.num_zeros + p.num_optionals + p.num_spaces);
-        result.erase(0, 1); // Remove 0 at the beginning so that we only have the decimal point and the rest
+        fmt::format_to(std::back_inserter(result), "{:.{}f}", fractional_part, p.num_zeros + p.num_optionals + p.num_spaces);
+        result.erase(start, 1); // Remove 0 at the beginning so that we only have the decimal point and the rest
 
         // Remove unnecessary zeros outside of the maximum precision.
-        while (result.back() == '0' && result.size() > p.num_zeros + 1)
+        while (result.size() - start > p.num_zeros + 1 && result.back() == '0')
         {
             result.pop_back();
         }
 
         // +1 because the decimal point does not count
-        if (result.size() < p.num_zeros + p.num_optionals + p.num_spaces + 1)
+        if (result.size() - start < p.num_zeros + p.num_optionals + p.num_spaces + 1)
         {
             // Add trailing spaces
-            result.resize(p.num_zeros + p.num_optionals + p.num_spaces + 1, ' ');
+            result.resize(start + p.num_zeros + p.num_optionals + p.num_spaces + 1, ' ');
         }
 
         if (p.percentage)
@@ -1654,12 +1692,11 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, do
             result.push_back('%');
         }
     }
-
-    return result;
 }
 
-std::string number_formatter::fill_scientific_placeholders(const format_placeholders &integer_part,
-    const format_placeholders &fractional_part, const format_placeholders &exponent_part, double number)
+void number_formatter::fill_scientific_placeholders(const format_placeholders &integer_part,
+    const format_placeholders &fractional_part, const format_placeholders &exponent_part, double number,
+    std::string &result) const
 {
     std::size_t logarithm = 0;
 
@@ -1685,27 +1722,27 @@ std::string number_formatter::fill_scientific_placeholders(const format_placehol
     {
         integer_width += integer_part.num_optionals;
     }
-    std::string integer_string = fmt::format("{:0{}d}", integer, integer_width);
+    append_integer(result, integer, integer_width);
 
     // Format with zeros and (optionally) spaces.
-    std::string fractional_string = fmt::format("{:.{}f}", fraction, fractional_part.num_zeros + fractional_part.num_optionals);
-    fractional_string.erase(0, 1); // Remove 0 at the beginning so that we only have the decimal point and the rest
-    std::string exponent_string = fmt::format("{:0{}d}", logarithm, exponent_part.num_zeros);
+    const auto fraction_start = result.size();
+    fmt::format_to(std::back_inserter(result), "{:.{}f}", fraction, fractional_part.num_zeros + fractional_part.num_optionals);
+    result.erase(fraction_start, 1); // Remove 0 at the beginning so that we only have the decimal point and the rest
 
     if (exponent_part.type == format_placeholders::placeholders_type::scientific_exponent_plus)
     {
-        exponent_string.insert(0, "E+");
+        result.append("E+");
     }
     else
     {
-        exponent_string.insert(0, "E");
+        result.push_back('E');
     }
 
-    return integer_string + fractional_string + exponent_string;
+    append_integer(result, logarithm, exponent_part.num_zeros);
 }
 
-std::string number_formatter::fill_fraction_placeholders(const format_placeholders & /*numerator*/,
-    const format_placeholders &denominator, double number, bool /*improper*/)
+void number_formatter::fill_fraction_placeholders(const format_placeholders & /*numerator*/,
+    const format_placeholders &denominator, double number, bool /*improper*/, std::string &result) const
 {
     auto fractional_part = number - static_cast<long long>(number);
     auto original_fractional_part = fractional_part;
@@ -1740,10 +1777,12 @@ std::string number_formatter::fill_fraction_placeholders(const format_placeholde
     }
 
     auto numerator_rounded = static_cast<long long>(std::round(original_fractional_part * best_denominator));
-    return std::to_string(numerator_rounded) + "/" + std::to_string(best_denominator);
+    append_integer(result, numerator_rounded);
+    result.push_back('/');
+    append_integer(result, best_denominator);
 }
 
-std::string number_formatter::format_number(const format_code &format, double number)
+void number_formatter::format_number(const format_code &format, double number, std::string &result) const
 {
     static const std::vector<std::string> month_names = std::vector<std::string>{"January", "February", "March",
         "April", "May", "June", "July", "August", "September", "October", "November", "December"};
@@ -1751,7 +1790,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
     static const std::vector<std::string> day_names =
         std::vector<std::string>{"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
 
-    std::string result;
+    const auto start = result.size();
 
     if (number < 0)
     {
@@ -1759,7 +1798,9 @@ std::string number_formatter::format_number(const format_code &format, double nu
 
         if (format.is_datetime)
         {
-            return std::string(11, '#');
+            result.resize(start);
+            result.append(11, '#');
+            return;
         }
     }
 
@@ -1791,7 +1832,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
     bool improper_fraction = true;
     std::size_t fill_index = 0;
     bool fill = false;
-    std::string fill_character;
+    char fill_character = ' ';
 
     for (std::size_t i = 0; i < format.parts.size(); ++i)
     {
@@ -1812,7 +1853,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
         case template_part::template_type::fill: {
             fill = true;
             fill_index = result.size();
-            fill_character = part.string;
+            fill_character = part.string.front();
             break;
         }
 
@@ -1825,7 +1866,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 auto denominator = static_cast<long long>(std::pow(10.0, digits));
                 auto fractional_seconds = dt.get_microsecond() / 1.0E6 * denominator;
                 fractional_seconds = std::round(fractional_seconds) / denominator;
-                result.append(fill_placeholders(part.placeholders, fractional_seconds));
+                fill_placeholders(part.placeholders, fractional_seconds, result);
                 break;
             }
 
@@ -1844,8 +1885,8 @@ std::string number_formatter::format_number(const format_code &format, double nu
                     break;
                 }
 
-                result.append(fill_fraction_placeholders(
-                    part.placeholders, format.parts[i].placeholders, number, improper_fraction));
+                fill_fraction_placeholders(
+                    part.placeholders, format.parts[i].placeholders, number, improper_fraction, result);
             }
             else if (part.placeholders.scientific
                 && part.placeholders.type == format_placeholders::placeholders_type::integer_part)
@@ -1854,18 +1895,18 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 ++i;
                 auto fractional_part = format.parts[i++].placeholders;
                 auto exponent_part = format.parts[i++].placeholders;
-                result.append(fill_scientific_placeholders(integer_part, fractional_part, exponent_part, number));
+                fill_scientific_placeholders(integer_part, fractional_part, exponent_part, number, result);
             }
             else
             {
-                result.append(fill_placeholders(part.placeholders, number));
+                fill_placeholders(part.placeholders, number, result);
             }
 
             break;
         }
 
         case template_part::template_type::day_number: {
-            result.append(std::to_string(dt.get_day()));
+            append_integer(result, dt.get_day());
             break;
         }
 
@@ -1875,12 +1916,12 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 result.push_back('0');
             }
 
-            result.append(std::to_string(dt.get_day()));
+            append_integer(result, dt.get_day());
             break;
         }
 
         case template_part::template_type::month_abbreviation: {
-            result.append(month_names.at(static_cast<std::size_t>(dt.get_month()) - 1).substr(0, 3));
+            result.append(month_names.at(static_cast<std::size_t>(dt.get_month()) - 1), 0, 3);
             break;
         }
 
@@ -1890,7 +1931,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
         }
 
         case template_part::template_type::month_number: {
-            result.append(std::to_string(dt.get_month()));
+            append_integer(result, dt.get_month());
             break;
         }
 
@@ -1900,7 +1941,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 result.push_back('0');
             }
 
-            result.append(std::to_string(dt.get_month()));
+            append_integer(result, dt.get_month());
             break;
         }
 
@@ -1910,17 +1951,17 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 result.push_back('0');
             }
 
-            result.append(std::to_string(dt.get_year() % 1000));
+            append_integer(result, dt.get_year() % 1000);
             break;
         }
 
         case template_part::template_type::year_long: {
-            result.append(std::to_string(dt.get_year()));
+            append_integer(result, dt.get_year());
             break;
         }
 
         case template_part::template_type::hour: {
-            result.append(std::to_string(hour));
+            append_integer(result, hour);
             break;
         }
 
@@ -1930,12 +1971,12 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 result.push_back('0');
             }
 
-            result.append(std::to_string(hour));
+            append_integer(result, hour);
             break;
         }
 
         case template_part::template_type::minute: {
-            result.append(std::to_string(dt.get_minute()));
+            append_integer(result, dt.get_minute());
             break;
         }
 
@@ -1945,17 +1986,17 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 result.push_back('0');
             }
 
-            result.append(std::to_string(dt.get_minute()));
+            append_integer(result, dt.get_minute());
             break;
         }
 
         case template_part::template_type::second: {
-            result.append(std::to_string(dt.get_second() + (dt.get_microsecond() > 500000 ? 1 : 0)));
+            append_integer(result, dt.get_second() + (dt.get_microsecond() > 500000 ? 1 : 0));
             break;
         }
 
         case template_part::template_type::second_fractional: {
-            result.append(std::to_string(dt.get_second()));
+            append_integer(result, dt.get_second());
             break;
         }
 
@@ -1965,7 +2006,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 result.push_back('0');
             }
 
-            result.append(std::to_string(dt.get_second() + (dt.get_microsecond() > 500000 ? 1 : 0)));
+            append_integer(result, dt.get_second() + (dt.get_microsecond() > 500000 ? 1 : 0));
             break;
         }
 
@@ -1975,7 +2016,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
                 result.push_back('0');
             }
 
-            result.append(std::to_string(dt.get_second()));
+            append_integer(result, dt.get_second());
             break;
         }
 
@@ -2006,24 +2047,24 @@ std::string number_formatter::format_number(const format_code &format, double nu
         }
 
         case template_part::template_type::elapsed_hours: {
-            result.append(std::to_string(24 * static_cast<long long>(number) + dt.get_hour()));
+            append_integer(result, 24 * static_cast<long long>(number) + dt.get_hour());
             break;
         }
 
         case template_part::template_type::elapsed_minutes: {
-            result.append(std::to_string(24 * 60 * static_cast<long long>(number)
-                + (60 * dt.get_hour()) + dt.get_minute()));
+            append_integer(result, 24 * 60 * static_cast<long long>(number)
+                + (60 * dt.get_hour()) + dt.get_minute());
             break;
         }
 
         case template_part::template_type::elapsed_seconds: {
-            result.append(std::to_string(24 * 60 * 60 * static_cast<long long>(number)
-                + (60 * 60 * dt.get_hour()) + (60 * dt.get_minute()) + dt.get_second()));
+            append_integer(result, 24 * 60 * 60 * static_cast<long long>(number)
+                + (60 * 60 * dt.get_hour()) + (60 * dt.get_minute()) + dt.get_second());
             break;
         }
 
         case template_part::template_type::month_letter: {
-            result.append(month_names.at(static_cast<std::size_t>(dt.get_month()) - 1).substr(0, 1));
+            result.append(month_names.at(static_cast<std::size_t>(dt.get_month()) - 1), 0, 1);
             break;
         }
 
@@ -2032,7 +2073,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
 
             if (weekday != -1)
             {
-                result.append(day_names.at(static_cast<std::size_t>(weekday)).substr(0, 3));
+                result.append(day_names.at(static_cast<std::size_t>(weekday)), 0, 3);
             }
             break;
         }
@@ -2051,20 +2092,16 @@ std::string number_formatter::format_number(const format_code &format, double nu
 
     const std::size_t width = 11;
 
-    if (fill && result.size() < width)
+    if (fill && result.size() - start < width)
     {
-        auto remaining = width - result.size();
+        auto remaining = width - (result.size() - start);
 
-        std::string fill_string(remaining, fill_character.front());
         // TODO: A UTF-8 character could be multiple bytes
-
-        result = result.substr(0, fill_index) + fill_string + result.substr(fill_index);
+        result.insert(fill_index, remaining, fill_character);
     }
-
-    return result;
 }
 
-std::string number_formatter::format_text(const format_code &format, const std::string &text)
+std::string number_formatter::format_text(const format_code &format, const std::string &text) const
 {
     std::string result;
     bool any_text_part = false;
@@ -679,18 +679,26 @@ class XLNT_API_INTERNAL number_formatter
 {
 public:
     number_formatter(const std::string &format_string, xlnt::calendar calendar);
-    std::string format_number(double number);
-    std::string format_text(const std::string &text);
+    std::string format_number(double number) const;
+
+    /// <summary>
+    /// Replaces the contents of result with number formatted by this format. Once result has grown
+    /// to the length of the longest output, formatting more numbers into it doesn't allocate.
+    /// </summary>
+    void format_number(double number, std::string &result) const;
+
+    std::string format_text(const std::string &text) const;
 
 private:
-    std::string fill_placeholders(const format_placeholders &p, double number);
-    std::string fill_fraction_placeholders(const format_placeholders &numerator,
-        const format_placeholders &denominator, double number, bool improper);
-    std::string fill_scientific_placeholders(const format_placeholders &integer_part,
+    // the fill_* and format_code overloads append their output to result
+    void fill_placeholders(const format_placeholders &p, double number, std::string &result) const;
+    void fill_fraction_placeholders(const format_placeholders &numerator,
+        const format_placeholders &denominator, double number, bool improper, std::string &result) const;
+    void fill_scientific_placeholders(const format_placeholders &integer_part,
         const format_placeholders &fractional_part, const format_placeholders &exponent_part,
-        double number);
-    std::string format_number(const format_code &format, double number);
-    std::string format_text(const format_code &format, const std::string &text);
+        double number, std::string &result) const;
+    void format_number(const format_code &format, double number, std::string &result) const;
+    std::string format_text(const format_code &format, const std::string &text) const;
 
     number_format_parser parser_;
     std::vector<format_code> format_;
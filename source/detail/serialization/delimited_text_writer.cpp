@@ -0,0 +1,183 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <detail/serialization/delimited_text_writer.hpp>
+#include <detail/implementations/stylesheet.hpp>
+#include <detail/implementations/workbook_impl.hpp>
+#include <detail/serialization/serialisation_helpers.hpp>
+
+namespace xlnt {
+namespace detail {
+
+delimited_text_writer::delimited_text_writer(std::ostream &stream, const delimited_text_options &options, const workbook &wb)
+    : stream_(stream),
+      options_(options),
+      workbook_(wb),
+      base_date_(wb.base_date())
+{
+}
+
+void delimited_text_writer::next_format(bool has_format, std::size_t format_id)
+{
+    next_has_format_ = has_format;
+    next_format_id_ = format_id;
+}
+
+void delimited_text_writer::on_row_begin(row_t row)
+{
+    // rows between the previous row and this one are empty lines
+    for (; last_row_ + 1 < row; ++last_row_)
+    {
+        stream_.write(options_.line_ending.data(), static_cast<std::streamsize>(options_.line_ending.size()));
+    }
+
+    last_row_ = row;
+    last_column_ = 0;
+    line_.clear();
+}
+
+void delimited_text_writer::on_number(row_t /*row*/, column_t::index_t column, double value)
+{
+    if (!begin_field(column)) return;
+
+    const auto formatter = options_.apply_number_formats ? next_formatter() : nullptr;
+
+    if (formatter == nullptr)
+    {
+        serialise(value, value_);
+    }
+    else
+    {
+        formatter->format_number(value, value_);
+    }
+
+    append_field(value_);
+}
+
+void delimited_text_writer::on_shared_string(row_t /*row*/, column_t::index_t column, std::size_t index)
+{
+    if (!begin_field(column)) return;
+
+    append_field(workbook_.shared_string_text(index));
+}
+
+void delimited_text_writer::on_inline_string(row_t /*row*/, column_t::index_t column, const std::string &value)
+{
+    if (!begin_field(column)) return;
+
+    append_field(value);
+}
+
+void delimited_text_writer::on_boolean(row_t /*row*/, column_t::index_t column, bool value)
+{
+    if (!begin_field(column)) return;
+
+    value_ = value ? "TRUE" : "FALSE";
+    append_field(value_);
+}
+
+void delimited_text_writer::on_error(row_t /*row*/, column_t::index_t column, const std::string &value)
+{
+    if (!begin_field(column)) return;
+
+    append_field(value);
+}
+
+void delimited_text_writer::on_row_end(row_t /*row*/)
+{
+    line_.append(options_.line_ending);
+    stream_.write(line_.data(), static_cast<std::streamsize>(line_.size()));
+}
+
+bool delimited_text_writer::begin_field(column_t::index_t column)
+{
+    if (column <= last_column_)
+    {
+        return false;
+    }
+
+    // one delimiter after each of the fields before this one, including the empty ones
+    const auto written_delimiters = last_column_ == 0 ? 0 : last_column_ - 1;
+    line_.append(column - 1 - written_delimiters, options_.delimiter);
+    last_column_ = column;
+
+    return true;
+}
+
+void delimited_text_writer::append_field(const std::string &value)
+{
+    const auto needs_quotes = options_.quote_all
+        || value.find_first_of({options_.delimiter, options_.quote, '\r', '\n'}) != std::string::npos;
+
+    if (!needs_quotes)
+    {
+        line_.append(value);
+        return;
+    }
+
+    line_.push_back(options_.quote);
+
+    for (auto c : value)
+    {
+        if (c == options_.quote)
+        {
+            line_.push_back(options_.quote);
+        }
+
+        line_.push_back(c);
+    }
+
+    line_.push_back(options_.quote);
+}
+
+const number_formatter *delimited_text_writer::next_formatter()
+{
+    if (!next_has_format_)
+    {
+        return nullptr;
+    }
+
+    if (next_format_id_ >= formatters_.size())
+    {
+        formatters_.resize(next_format_id_ + 1);
+        formatter_resolved_.resize(next_format_id_ + 1, false);
+    }
+
+    if (!formatter_resolved_[next_format_id_])
+    {
+        const auto format_string = workbook_.format(next_format_id_).number_format().format_string();
+
+        if (format_string != "General")
+        {
+            formatters_[next_format_id_] = workbook_.d_->stylesheet_.get().compiled_number_formats.formatter(format_string, base_date_);
+        }
+
+        formatter_resolved_[next_format_id_] = true;
+    }
+
+    return formatters_[next_format_id_].get();
+}
+
+} // namespace detail
+} // namespace xlnt
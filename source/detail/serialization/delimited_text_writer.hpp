@@ -0,0 +1,115 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/utils/calendar.hpp>
+#include <xlnt/workbook/sheet_visitor.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/delimited_text_options.hpp>
+#include <detail/number_format/number_formatter.hpp>
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Writes the rows and cells it is told about as delimited text, one line per row.
+/// Rows which are skipped become empty lines and columns which are skipped empty fields,
+/// so every value is written at the position of its cell. Each line ends after its last cell.
+/// Values are formatted like cell::to_string(), but with the number format of their cell.
+/// The format of each format id is only looked up once.
+/// </summary>
+class XLNT_API_INTERNAL delimited_text_writer : public sheet_visitor
+{
+public:
+    delimited_text_writer(std::ostream &stream, const delimited_text_options &options, const workbook &wb);
+
+    /// <summary>
+    /// Sets the format of the next cell which is reported to the index of a format of the workbook,
+    /// or to no format if has_format is false.
+    /// </summary>
+    void next_format(bool has_format, std::size_t format_id);
+
+    void on_row_begin(row_t row) override;
+    void on_number(row_t row, column_t::index_t column, double value) override;
+    void on_shared_string(row_t row, column_t::index_t column, std::size_t index) override;
+    void on_inline_string(row_t row, column_t::index_t column, const std::string &value) override;
+    void on_boolean(row_t row, column_t::index_t column, bool value) override;
+    void on_error(row_t row, column_t::index_t column, const std::string &value) override;
+    void on_row_end(row_t row) override;
+
+private:
+    /// <summary>
+    /// Appends the delimiters which precede the field of column to line_.
+    /// Returns false if column was already written.
+    /// </summary>
+    bool begin_field(column_t::index_t column);
+
+    /// <summary>
+    /// Appends value to line_, quoted if necessary.
+    /// </summary>
+    void append_field(const std::string &value);
+
+    /// <summary>
+    /// Returns the compiled number format of the next cell or nullptr for the general format.
+    /// </summary>
+    const number_formatter *next_formatter();
+
+    std::ostream &stream_;
+    delimited_text_options options_;
+    workbook workbook_;
+    calendar base_date_;
+
+    /// <summary>
+    /// The compiled number formats by format id, looked up once each.
+    /// An unset entry hasn't been looked up yet, null stands for the general format.
+    /// </summary>
+    std::vector<std::shared_ptr<const number_formatter>> formatters_;
+    std::vector<bool> formatter_resolved_;
+
+    bool next_has_format_ = false;
+    std::size_t next_format_id_ = 0;
+
+    /// <summary>
+    /// The row which was written last and the last column written in the current row.
+    /// </summary>
+    row_t last_row_ = 0;
+    column_t::index_t last_column_ = 0;
+
+    /// <summary>
+    /// The current line and a value, which keep their capacity from one row to the next.
+    /// </summary>
+    std::string line_;
+    std::string value_;
+};
+
+} // namespace detail
+} // namespace xlnt
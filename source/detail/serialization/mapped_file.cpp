@@ -0,0 +1,202 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <cerrno>
+#include <utility>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/path.hpp>
+#include <detail/external/include_windows.hpp>
+#include <detail/serialization/mapped_file.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/utils/error_helpers.hpp>
+
+namespace {
+
+[[noreturn]] void throw_map_error(const std::string &path, const std::string &reason, int error)
+{
+    throw xlnt::invalid_file("Could not map file at path \"" + path + "\". Reason: \"" + reason
+        + "\" (internal error " + std::to_string(error) + ": " + xlnt::detail::strerror_safe(error) + ")");
+}
+
+class mapped_file_streambuf : public xlnt::detail::memory_istreambuf
+{
+public:
+    explicit mapped_file_streambuf(std::unique_ptr<xlnt::detail::mapped_file> file)
+        : memory_istreambuf(file->data(), file->size()),
+          file_(std::move(file))
+    {
+    }
+
+private:
+    std::unique_ptr<xlnt::detail::mapped_file> file_;
+};
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+#ifdef _MSC_VER
+
+mapped_file::mapped_file(const std::string &path)
+{
+    file_ = CreateFileW(xlnt::path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        file_ = nullptr;
+        throw_map_error(path, "CreateFileW failed", static_cast<int>(GetLastError()));
+    }
+
+    LARGE_INTEGER file_size;
+
+    if (!GetFileSizeEx(file_, &file_size))
+    {
+        const auto error = static_cast<int>(GetLastError());
+        CloseHandle(file_);
+        throw_map_error(path, "GetFileSizeEx failed", error);
+    }
+
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+
+    if (size_ == 0)
+    {
+        // empty files can't be mapped
+        return;
+    }
+
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mapping_ == nullptr)
+    {
+        const auto error = static_cast<int>(GetLastError());
+        CloseHandle(file_);
+        throw_map_error(path, "CreateFileMappingW failed", error);
+    }
+
+    data_ = static_cast<const std::uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+
+    if (data_ == nullptr)
+    {
+        const auto error = static_cast<int>(GetLastError());
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw_map_error(path, "MapViewOfFile failed", error);
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(mapping_);
+    }
+
+    if (file_ != nullptr)
+    {
+        CloseHandle(file_);
+    }
+}
+
+#else
+
+mapped_file::mapped_file(const std::string &path)
+{
+    errno = 0;
+    const auto descriptor = ::open(path.c_str(), O_RDONLY);
+
+    if (descriptor < 0)
+    {
+        throw_map_error(path, "open failed", errno);
+    }
+
+    struct stat file_status;
+
+    if (::fstat(descriptor, &file_status) != 0)
+    {
+        const auto error = errno;
+        ::close(descriptor);
+        throw_map_error(path, "fstat failed", error);
+    }
+
+    size_ = static_cast<std::size_t>(file_status.st_size);
+
+    if (size_ > 0)
+    {
+        auto mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+            const auto error = errno;
+            ::close(descriptor);
+            throw_map_error(path, "mmap failed", error);
+        }
+
+        data_ = static_cast<const std::uint8_t *>(mapping);
+    }
+
+    // the mapping stays valid after the file is closed
+    ::close(descriptor);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(const_cast<std::uint8_t *>(data_), size_);
+    }
+}
+
+#endif
+
+const std::uint8_t *mapped_file::data() const
+{
+    return data_;
+}
+
+std::size_t mapped_file::size() const
+{
+    return size_;
+}
+
+std::unique_ptr<std::streambuf> open_mapped_file(const std::string &path)
+{
+    return std::unique_ptr<std::streambuf>(new mapped_file_streambuf(std::unique_ptr<mapped_file>(new mapped_file(path))));
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,81 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Maps a whole file into memory for reading. The mapping is released by the destructor.
+/// </summary>
+class XLNT_API_INTERNAL mapped_file
+{
+public:
+    /// <summary>
+    /// Maps the file at the given path, which is expected to be encoded as UTF-8.
+    /// Throws invalid_file if the file can't be opened or mapped.
+    /// </summary>
+    explicit mapped_file(const std::string &path);
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    ~mapped_file();
+
+    /// <summary>
+    /// Returns the first byte of the file, or nullptr if the file is empty.
+    /// </summary>
+    const std::uint8_t *data() const;
+
+    /// <summary>
+    /// Returns the size of the file in bytes.
+    /// </summary>
+    std::size_t size() const;
+
+private:
+    const std::uint8_t *data_ = nullptr;
+    std::size_t size_ = 0;
+
+#ifdef _MSC_VER
+    void *file_ = nullptr;
+    void *mapping_ = nullptr;
+#endif
+};
+
+/// <summary>
+/// Maps the file at the given path and returns a streambuf which reads the mapped
+/// bytes and keeps the mapping alive. izstream reads entries straight from the mapping.
+/// </summary>
+XLNT_API_INTERNAL std::unique_ptr<std::streambuf> open_mapped_file(const std::string &path);
+
+} // namespace detail
+} // namespace xlnt
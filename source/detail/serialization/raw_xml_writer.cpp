@@ -0,0 +1,92 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <xlnt/utils/exceptions.hpp>
+#include <detail/serialization/raw_xml_writer.hpp>
+
+namespace xlnt {
+namespace detail {
+
+void raw_xml_writer::write_escaped(const std::string &text, bool in_attribute)
+{
+    const auto begin = text.data();
+    const auto end = begin + text.size();
+    auto unwritten = begin;
+
+    for (auto position = begin; position != end; ++position)
+    {
+        const auto c = static_cast<unsigned char>(*position);
+
+        // most characters are written as they are, so these are checked first
+        if (c > '>' || (c >= ' ' && c != '&' && c != '<' && c != '>' && c != '"'))
+        {
+            continue;
+        }
+
+        const char *replacement = nullptr;
+
+        switch (c)
+        {
+        case '&':
+            replacement = "&amp;";
+            break;
+        case '<':
+            replacement = "&lt;";
+            break;
+        case '>':
+            replacement = "&gt;";
+            break;
+        case '\r':
+            replacement = "&#xD;";
+            break;
+        case '"':
+            replacement = in_attribute ? "&quot;" : nullptr;
+            break;
+        case '\t':
+            replacement = in_attribute ? "&#x9;" : nullptr;
+            break;
+        case '\n':
+            replacement = in_attribute ? "&#xA;" : nullptr;
+            break;
+        default:
+            if (c < ' ')
+            {
+                throw illegal_character(static_cast<char>(c));
+            }
+            break;
+        }
+
+        if (replacement != nullptr)
+        {
+            write(unwritten, static_cast<std::size_t>(position - unwritten));
+            write(replacement, std::char_traits<char>::length(replacement));
+            unwritten = position + 1;
+        }
+    }
+
+    write(unwritten, static_cast<std::size_t>(end - unwritten));
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,112 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <streambuf>
+#include <string>
+
+#include <detail/xlnt_config_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Writes markup straight into the streambuf of a part, without the element and
+/// namespace bookkeeping of xml::serializer. The caller is responsible for well-formedness.
+/// This is used for the rows and cells of sheetData, which make up most of a worksheet.
+/// Text and attribute values are escaped the same way xml::serializer escapes them.
+/// </summary>
+class XLNT_API_INTERNAL raw_xml_writer
+{
+public:
+    /// <summary>
+    /// Writes to buffer from now on.
+    /// </summary>
+    void reset(std::streambuf *buffer)
+    {
+        buffer_ = buffer;
+    }
+
+    /// <summary>
+    /// Writes markup which doesn't need to be escaped, like "<c r=\"".
+    /// </summary>
+    template <std::size_t N>
+    void write(const char (&markup)[N])
+    {
+        write(markup, N - 1);
+    }
+
+    void write(const std::string &markup)
+    {
+        write(markup.data(), markup.size());
+    }
+
+    void write(const char *data, std::size_t size)
+    {
+        buffer_->sputn(data, static_cast<std::streamsize>(size));
+    }
+
+    /// <summary>
+    /// Writes the attribute name="value" with a leading space.
+    /// </summary>
+    template <std::size_t N>
+    void attribute(const char (&name)[N], const std::string &value)
+    {
+        write(" ");
+        write(name, N - 1);
+        write("=\"");
+        write_escaped(value, true);
+        write("\"");
+    }
+
+    /// <summary>
+    /// Writes the element <name>text</name>.
+    /// </summary>
+    template <std::size_t N>
+    void element(const char (&name)[N], const std::string &text)
+    {
+        write("<");
+        write(name, N - 1);
+        write(">");
+        write_escaped(text, false);
+        write("</");
+        write(name, N - 1);
+        write(">");
+    }
+
+    /// <summary>
+    /// Writes text, escaping the characters which can't appear in an attribute value if
+    /// in_attribute is true and those which can't appear in character data otherwise.
+    /// Throws illegal_character for characters which aren't allowed in XML.
+    /// </summary>
+    void write_escaped(const std::string &text, bool in_attribute);
+
+private:
+    std::streambuf *buffer_ = nullptr;
+};
+
+} // namespace detail
+} // namespace xlnt
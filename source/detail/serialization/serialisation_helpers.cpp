@@ -1,8 +1,9 @@
 #include <detail/serialization/serialisation_helpers.hpp>
 #include <detail/serialization/parsers.hpp>
 
-#include <limits>
 #include <cassert>
+#include <iterator>
+#include <limits>
 
 #define FMT_HEADER_ONLY
 #include <fmt/format.h>
@@ -15,6 +16,39 @@ std::string serialise(double d)
     return fmt::format("{}", d);
 }
 
+void serialise(double d, std::string &buffer)
+{
+    buffer.clear();
+    fmt::format_to(std::back_inserter(buffer), "{}", d);
+}
+
+void serialise_integer(long long value, std::string &buffer)
+{
+    buffer.clear();
+    fmt::format_to(std::back_inserter(buffer), "{}", value);
+}
+
+void serialise_integer(unsigned long long value, std::string &buffer)
+{
+    buffer.clear();
+    fmt::format_to(std::back_inserter(buffer), "{}", value);
+}
+
+void serialise(const Cell_Reference &reference, std::string &buffer)
+{
+    // column letters in reverse order, see column_t::column_string_from_index
+    char letters[8];
+    auto length = std::size_t(0);
+
+    for (auto column = reference.column; column > 0; column = (column - 1) / 26)
+    {
+        letters[length++] = static_cast<char>('A' + (column - 1) % 26);
+    }
+
+    buffer.assign(std::reverse_iterator<const char *>(letters + length), std::reverse_iterator<const char *>(letters));
+    fmt::format_to(std::back_inserter(buffer), "{}", reference.row);
+}
+
 double deserialise(const std::string &s, size_t *len_converted)
 {
     assert(!s.empty());
@@ -5,7 +5,9 @@
 #include <xlnt/cell/index_types.hpp>
 #include <detail/xlnt_config_impl.hpp>
 
+#include <limits>
 #include <string>
+#include <vector>
 
 namespace xlnt {
 namespace detail {
@@ -96,10 +98,37 @@ struct Cell
     std::string formula_string; // <f>
 };
 
+// the rows and columns of <sheetData> which are read, see workbook::load_columns() and workbook::load_rows()
+struct Sheet_Filter
+{
+    bool has_column(xlnt::column_t::index_t column) const
+    {
+        return columns.empty() || (column < columns.size() && columns[column]);
+    }
+
+    bool has_cell(xlnt::column_t::index_t column, xlnt::row_t row) const
+    {
+        return row >= first_row && row <= last_row && has_column(column);
+    }
+
+    std::vector<bool> columns; // indexed by column, empty if all columns are read
+    xlnt::row_t first_row = 0;
+    xlnt::row_t last_row = std::numeric_limits<xlnt::row_t>::max();
+};
+
 // for printing to file.
 // This matches the output format of excel irrespective of current locale
 XLNT_API_INTERNAL std::string serialise(double d);
 
+// The following functions format like the ones above, but replace the contents of buffer
+// instead of returning a new string. Reusing one buffer for many values avoids an allocation for each.
+XLNT_API_INTERNAL void serialise(double d, std::string &buffer);
+XLNT_API_INTERNAL void serialise_integer(long long value, std::string &buffer);
+XLNT_API_INTERNAL void serialise_integer(unsigned long long value, std::string &buffer);
+
+// Formats a reference like "B12", the same as xlnt::cell_reference::to_string() for a relative reference
+XLNT_API_INTERNAL void serialise(const Cell_Reference &reference, std::string &buffer);
+
 // Parses a string to a double-precision floating-point number. Optionally, num_characters_parsed can point
 // to a variable where the number of parsed characters will be stored.
 XLNT_API_INTERNAL double deserialise(const std::string &s, size_t *num_characters_parsed = nullptr);
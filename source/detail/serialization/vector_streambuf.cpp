@@ -122,6 +122,58 @@ std::streampos vector_istreambuf::seekpos(std::streampos sp, std::ios_base::open
     return static_cast<std::ptrdiff_t>(position_);
 }
 
+memory_istreambuf::memory_istreambuf(const std::uint8_t *data, std::size_t size)
+    : data_(data),
+      size_(size)
+{
+    // the get area is never written to, std::streambuf just doesn't know about const
+    auto begin = const_cast<char *>(reinterpret_cast<const char *>(data_));
+    setg(begin, begin, begin + size_);
+}
+
+memory_istreambuf::memory_istreambuf(const std::vector<std::uint8_t> &data)
+    : memory_istreambuf(data.data(), data.size())
+{
+}
+
+const std::uint8_t *memory_istreambuf::data() const
+{
+    return data_;
+}
+
+std::size_t memory_istreambuf::size() const
+{
+    return size_;
+}
+
+std::streampos memory_istreambuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode)
+{
+    auto position = off;
+
+    if (way == std::ios_base::cur)
+    {
+        position += gptr() - eback();
+    }
+    else if (way == std::ios_base::end)
+    {
+        position += static_cast<std::streamoff>(size_);
+    }
+
+    if (position < 0 || position > static_cast<std::streamoff>(size_))
+    {
+        return static_cast<std::streampos>(-1);
+    }
+
+    setg(eback(), eback() + position, egptr());
+
+    return static_cast<std::streampos>(position);
+}
+
+std::streampos memory_istreambuf::seekpos(std::streampos sp, std::ios_base::openmode which)
+{
+    return seekoff(static_cast<std::streamoff>(sp), std::ios_base::beg, which);
+}
+
 vector_ostreambuf::vector_ostreambuf(std::vector<std::uint8_t> &data)
     : data_(data),
       position_(0)
@@ -62,6 +62,40 @@ private:
     std::size_t position_;
 };
 
+/// <summary>
+/// Allows a contiguous block of memory, e.g. a mapped file, to be read through a std::istream.
+/// The memory isn't copied and has to outlive the streambuf.
+/// </summary>
+class XLNT_API_INTERNAL memory_istreambuf : public std::streambuf
+{
+public:
+    memory_istreambuf(const std::uint8_t *data, std::size_t size);
+
+    explicit memory_istreambuf(const std::vector<std::uint8_t> &data);
+
+    memory_istreambuf(const memory_istreambuf &) = delete;
+    memory_istreambuf &operator=(const memory_istreambuf &) = delete;
+
+    /// <summary>
+    /// Returns the first byte of the memory which is read.
+    /// </summary>
+    const std::uint8_t *data() const;
+
+    /// <summary>
+    /// Returns the number of bytes which can be read in total.
+    /// </summary>
+    std::size_t size() const;
+
+private:
+    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode) override;
+
+    std::streampos seekpos(std::streampos sp, std::ios_base::openmode) override;
+
+private:
+    const std::uint8_t *data_;
+    std::size_t size_;
+};
+
 /// <summary>
 /// Allows a std::vector to be written through a std::ostream.
 /// </summary>
@@ -22,9 +22,15 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <array>
 #include <cassert>
 #include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 
 #include <xlnt/cell/cell.hpp>
@@ -34,6 +40,7 @@
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/sheet_visitor.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/selection.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
@@ -42,6 +49,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/defined_name.hpp>
+#include <detail/serialization/delimited_text_writer.hpp>
 #include <detail/serialization/serialisation_helpers.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
@@ -80,7 +88,8 @@ inline bool string_equal(const std::string &lhs, const char (&rhs)[N])
 xml::qname &qn(const std::string &namespace_, const std::string &name)
 {
     using qname_map = std::unordered_map<std::string, xml::qname>;
-    static auto memo = std::unordered_map<std::string, qname_map>();
+    // per thread, since worksheets may be read on several threads at once
+    static thread_local auto memo = std::unordered_map<std::string, qname_map>();
 
     auto &ns_memo = memo[namespace_];
 
@@ -137,13 +146,87 @@ void set_style_by_xfid(const std::vector<style_id_pair> &styles,
     }
 }
 
-// <sheetData> element
+// The number of rows and cells of <sheetData> which are parsed before they are inserted into the worksheet
+constexpr std::size_t sheet_data_batch_size = 4096;
+
+// A batch of rows inside the <sheetData> element.
+// Batches are reused, so cells are overwritten in place and their strings keep their capacity.
 struct Sheet_Data
 {
     std::vector<std::pair<xlnt::row_properties, xlnt::row_t>> parsed_rows;
     std::vector<xlnt::detail::Cell> parsed_cells;
+    std::size_t cell_count = 0; // number of cells of parsed_cells which belong to this batch
+    bool finished = false; // true once the end of <sheetData> was reached
+    bool truncated = false; // true if finished at a row after the rows which are read
+
+    xlnt::detail::Cell &next_cell()
+    {
+        if (cell_count == parsed_cells.size())
+        {
+            parsed_cells.emplace_back();
+        }
+
+        return parsed_cells[cell_count++];
+    }
+
+    void clear()
+    {
+        parsed_rows.clear();
+        cell_count = 0;
+    }
 };
 
+// Skips the rest of an element of <sheetData> which isn't read because of a Sheet_Filter,
+// without decoding any values. Only the formulae of shared formula master cells are kept,
+// since cells which are read may refer to them.
+void skip_sheet_data_element(xml::parser *parser, std::unordered_map<int, std::string> &shared_formulae)
+{
+    // Prevents unhandled exceptions from being triggered.
+    parser->attribute_map();
+
+    std::string *shared_formula = nullptr;
+    int level = 1;
+    while (level > 0)
+    {
+        xml::parser::event_type e = parser->next();
+        switch (e)
+        {
+        case xml::parser::start_element: {
+            ++level;
+            shared_formula = nullptr;
+            if (string_equal(parser->name(), "f") && parser->attribute_present("ref")
+                && parser->attribute_present("t") && parser->attribute("t") == "shared")
+            {
+                shared_formula = &shared_formulae[parser->attribute<int>("si")];
+                shared_formula->clear();
+            }
+            break;
+        }
+        case xml::parser::end_element: {
+            --level;
+            shared_formula = nullptr;
+            break;
+        }
+        case xml::parser::characters: {
+            if (shared_formula != nullptr)
+            {
+                shared_formula->append(parser->value());
+            }
+            break;
+        }
+        case xml::parser::start_namespace_decl:
+        case xml::parser::end_namespace_decl:
+        case xml::parser::start_attribute:
+        case xml::parser::end_attribute:
+        case xml::parser::eof:
+        default: {
+            throw xlnt::exception("unexpected XML parsing event " + std::to_string(e));
+        }
+        }
+        parser->attribute_map();
+    }
+}
+
 xlnt::cell_type type_from_string(const std::string &str)
 {
     if (string_equal(str, "s"))
@@ -173,9 +256,18 @@ xlnt::cell_type type_from_string(const std::string &str)
     return xlnt::cell::type::shared_string;
 }
 
-xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+// <c> inside <row> element
+// Returns false if the cell was skipped because its column isn't read.
+bool parse_cell(xlnt::row_t row_arg, xml::parser *parser, xlnt::detail::Cell &c, const xlnt::detail::Sheet_Filter &filter, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
 {
-    xlnt::detail::Cell c;
+    c.is_phonetic = false;
+    c.type = xlnt::cell_type::number;
+    c.cell_metadata_idx = -1;
+    c.style_index = -1;
+    c.ref = xlnt::detail::Cell_Reference(0, 0);
+    c.value.clear();
+    c.formula_string.clear();
+
     for (auto &attr : parser->attribute_map())
     {
         if (string_equal(attr.first.name(), "r"))
@@ -199,6 +291,11 @@ xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser, std::uno
             xlnt::detail::parse(attr.second.value, c.cell_metadata_idx);
         }
     }
+    if (!filter.has_column(c.ref.column))
+    {
+        skip_sheet_data_element(parser, shared_formulae);
+        return false;
+    }
     int level = 1; // nesting level
         // 1 == <c>
         // 2 == <v>/<f>
@@ -280,11 +377,11 @@ xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser, std::uno
         // Prevents unhandled exceptions from being triggered.
         parser->attribute_map();
     }
-    return c;
+    return true;
 }
 
-// <row> inside <sheetData> element
-std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, std::vector<xlnt::detail::Cell> &parsed_cells, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+// attributes of <row> inside <sheetData> element
+std::pair<xlnt::row_properties, int> parse_row_attributes(xml::parser *parser)
 {
     std::pair<xlnt::row_properties, int> props;
     for (auto &attr : parser->attribute_map())
@@ -340,6 +437,26 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, std::vector<
         }
     }
 
+    return props;
+}
+
+// <row> inside <sheetData> element
+// Returns false without reading the row if it comes after the rows which are read.
+bool parse_row(xml::parser *parser, Sheet_Data &sheet_data, const xlnt::detail::Sheet_Filter &filter, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+{
+    auto props = parse_row_attributes(parser);
+    const auto row = static_cast<xlnt::row_t>(props.second);
+
+    if (row > filter.last_row)
+    {
+        return false;
+    }
+    if (row < filter.first_row)
+    {
+        skip_sheet_data_element(parser, shared_formulae);
+        return true;
+    }
+
     int level = 1;
     while (level > 0)
     {
@@ -347,7 +464,11 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, std::vector<
         switch (e)
         {
         case xml::parser::start_element: {
-            parsed_cells.push_back(parse_cell(static_cast<xlnt::row_t>(props.second), parser, array_formulae, shared_formulae));
+            if (!parse_cell(row, parser, sheet_data.next_cell(), filter, array_formulae, shared_formulae))
+            {
+                // give the skipped cell back to the batch
+                --sheet_data.cell_count;
+            }
             break;
         }
         case xml::parser::end_element: {
@@ -368,29 +489,36 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, std::vector<
         }
         }
     }
-    return props;
+    sheet_data.parsed_rows.emplace_back(std::move(props.first), row);
+    return true;
 }
 
 // <sheetData> inside <worksheet> element
-Sheet_Data parse_sheet_data(xml::parser *parser, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+// Parses the next rows into sheet_data until it holds about batch_size rows and cells
+// or the end of <sheetData> is reached. Rows and cells which aren't read because of filter are skipped.
+void parse_sheet_data(xml::parser *parser, Sheet_Data &sheet_data, std::size_t batch_size, const xlnt::detail::Sheet_Filter &filter, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
 {
-    Sheet_Data sheet_data;
-    int level = 1; // nesting level
-        // 1 == <sheetData>
-        // 2 == <row>
+    sheet_data.clear();
 
-    while (level > 0)
+    while (sheet_data.parsed_rows.size() + sheet_data.cell_count < batch_size)
     {
         xml::parser::event_type e = parser->next();
         switch (e)
         {
         case xml::parser::start_element: {
-            sheet_data.parsed_rows.push_back(parse_row(parser, sheet_data.parsed_cells, array_formulae, shared_formulae));
+            if (!parse_row(parser, sheet_data, filter, array_formulae, shared_formulae))
+            {
+                // The remaining rows aren't read, so stop parsing the worksheet here
+                sheet_data.finished = true;
+                sheet_data.truncated = true;
+                return;
+            }
             break;
         }
         case xml::parser::end_element: {
-            --level;
-            break;
+            // </sheetData>
+            sheet_data.finished = true;
+            return;
         }
         case xml::parser::characters: {
             // ignore, whitespace formatting normally
@@ -406,7 +534,285 @@ Sheet_Data parse_sheet_data(xml::parser *parser, std::unordered_map<std::string,
         }
         }
     }
-    return sheet_data;
+}
+
+// Sets the phonetics, formula and value of a cell parsed by parse_cell on cell,
+// which uses the extensions and shared string references of cells
+void read_parsed_cell(xlnt::detail::cell_store &cells, xlnt::detail::cell_impl &cell, const xlnt::detail::Cell &parsed)
+{
+    if (parsed.is_phonetic)
+    {
+        cells.extension(cell).phonetics_visible_ = true;
+    }
+    if (!parsed.formula_string.empty())
+    {
+        cells.formula(cell) = parsed.formula_string[0] == '=' ? parsed.formula_string.substr(1) : parsed.formula_string;
+    }
+    if (!parsed.value.empty())
+    {
+        cells.release_shared_string(cell);
+        cell.type_ = parsed.type;
+        switch (parsed.type)
+        {
+        case xlnt::cell::type::boolean: {
+            cell.value_numeric_ = is_true(parsed.value) ? 1.0 : 0.0;
+            break;
+        }
+        case xlnt::cell::type::empty:
+        case xlnt::cell::type::number:
+        case xlnt::cell::type::date: {
+            cell.value_numeric_ = xlnt::detail::deserialise(parsed.value);
+            break;
+        }
+        case xlnt::cell::type::shared_string: {
+            long long value = -1;
+            if (xlnt::detail::parse(parsed.value, value) == std::errc())
+            {
+                cell.value_numeric_ = static_cast<double>(value);
+            }
+            break;
+        }
+        case xlnt::cell::type::inline_string:
+        case xlnt::cell::type::formula_string: {
+            cells.text(cell) = parsed.value;
+            break;
+        }
+        case xlnt::cell::type::error: {
+            cells.text(cell).plain_text(parsed.value, false);
+            break;
+        }
+        }
+        cells.reference_shared_string(cell);
+    }
+}
+
+/// the streamed cell isn't owned by the cell store of its worksheet, so its extension
+/// and shared string reference have to be released explicitly before it is replaced
+void reset_streaming_cell(std::unique_ptr<xlnt::detail::cell_impl> &cell, xlnt::detail::cell_impl *replacement)
+{
+    if (cell && cell->parent_ != nullptr)
+    {
+        cell->parent_->cell_map_.release_extension(*cell);
+        cell->parent_->cell_map_.release_shared_string(*cell);
+    }
+
+    cell.reset(replacement);
+}
+
+/// Returns the position of the first occurrence of token in [begin, end), or end if there is none
+const char *find_token(const char *begin, const char *end, const char *token)
+{
+    return std::search(begin, end, token, token + std::char_traits<char>::length(token));
+}
+
+bool starts_with(const char *begin, const char *end, const char *token)
+{
+    const auto length = std::char_traits<char>::length(token);
+    return static_cast<std::size_t>(end - begin) >= length && std::equal(token, token + length, begin);
+}
+
+/// Finds the <si> elements of the shared string table in table.data without decoding them.
+/// Returns false if the table can't be indexed this way, e.g. if it has a document type declaration.
+bool index_shared_strings(xlnt::detail::pending_shared_strings &table)
+{
+    const auto data = reinterpret_cast<const char *>(table.data.data());
+    const auto end = data + table.data.size();
+    const char *entry = nullptr;
+    std::size_t depth = 0;
+
+    for (auto position = std::find(data, end, '<'); position != end; position = std::find(position, end, '<'))
+    {
+        const char *tag_end = end;
+
+        if (starts_with(position, end, "<?"))
+        {
+            tag_end = find_token(position, end, "?>");
+            tag_end = tag_end == end ? end : tag_end + 1;
+        }
+        else if (starts_with(position, end, "<!--"))
+        {
+            tag_end = find_token(position, end, "-->");
+            tag_end = tag_end == end ? end : tag_end + 2;
+        }
+        else if (starts_with(position, end, "<![CDATA["))
+        {
+            tag_end = find_token(position, end, "]]>");
+            tag_end = tag_end == end ? end : tag_end + 2;
+        }
+        else if (starts_with(position, end, "<!"))
+        {
+            // a document type declaration could declare entities used by the entries
+            return false;
+        }
+        else if (starts_with(position, end, "</"))
+        {
+            tag_end = std::find(position, end, '>');
+
+            if (depth == 1)
+            {
+                table.footer_begin = static_cast<std::size_t>(position - data);
+                return true;
+            }
+
+            if (--depth == 1 && entry != nullptr && tag_end != end)
+            {
+                table.entries.emplace_back(static_cast<std::size_t>(entry - data), static_cast<std::size_t>(tag_end + 1 - data));
+                entry = nullptr;
+            }
+        }
+        else
+        {
+            // attribute values may contain '>'
+            auto quote = '\0';
+
+            for (tag_end = position + 1; tag_end < end && (quote != '\0' || *tag_end != '>'); ++tag_end)
+            {
+                if (*tag_end == quote)
+                {
+                    quote = '\0';
+                }
+                else if (quote == '\0' && (*tag_end == '"' || *tag_end == '\''))
+                {
+                    quote = *tag_end;
+                }
+            }
+
+            if (tag_end == end)
+            {
+                return false;
+            }
+
+            auto name_end = position + 1;
+
+            while (name_end != tag_end && *name_end != '/' && !std::isspace(static_cast<unsigned char>(*name_end)))
+            {
+                ++name_end;
+            }
+
+            const auto self_closing = tag_end[-1] == '/';
+            const auto prefix_end = std::find(position + 1, name_end, ':');
+            const auto local_name = prefix_end == name_end ? position + 1 : prefix_end + 1;
+            const auto is_entry = depth == 1 && name_end - local_name == 2 && starts_with(local_name, name_end, "si");
+
+            if (depth == 0)
+            {
+                if (self_closing)
+                {
+                    return false;
+                }
+
+                table.header_end = static_cast<std::size_t>(tag_end + 1 - data);
+            }
+            else if (is_entry && self_closing)
+            {
+                table.entries.emplace_back(static_cast<std::size_t>(position - data), static_cast<std::size_t>(tag_end + 1 - data));
+            }
+            else if (is_entry)
+            {
+                entry = position;
+            }
+
+            if (!self_closing)
+            {
+                ++depth;
+            }
+        }
+
+        // an unterminated comment, processing instruction or tag
+        if (tag_end == end)
+        {
+            return false;
+        }
+
+        position = tag_end + 1;
+    }
+
+    return false;
+}
+
+/// Decodes an entry of a shared string table which only holds plain text, like
+/// <si><t>text</t></si>, without an XML parser. Returns false if the entry has to be parsed.
+bool read_plain_shared_string(const char *begin, const char *end, std::string &text, bool &preserve_space)
+{
+    // the prefix of the elements, if any, is the part of the name of <si> before "si"
+    const auto si_end = std::find(begin, end, '>');
+
+    if (si_end == end || si_end - begin < 3 || *begin != '<' || !starts_with(si_end - 2, end, "si"))
+    {
+        return false;
+    }
+
+    const auto prefix = std::string(begin + 1, si_end - 2);
+
+    if (!prefix.empty() && (prefix.back() != ':' || prefix.find_first_of(" \t\r\n/:") != prefix.size() - 1))
+    {
+        return false;
+    }
+
+    const auto t_start = "<" + prefix + "t";
+    auto position = si_end + 1;
+
+    if (!starts_with(position, end, t_start.c_str()))
+    {
+        return false;
+    }
+
+    position += t_start.size();
+    preserve_space = false;
+
+    if (starts_with(position, end, " xml:space=\"preserve\">"))
+    {
+        preserve_space = true;
+        position += std::char_traits<char>::length(" xml:space=\"preserve\">");
+    }
+    else if (starts_with(position, end, ">"))
+    {
+        position += 1;
+    }
+    else
+    {
+        return false;
+    }
+
+    const auto text_end = std::find(position, end, '<');
+    const auto closing = "</" + prefix + "t></" + prefix + "si>";
+
+    if (static_cast<std::size_t>(end - text_end) != closing.size() || !starts_with(text_end, end, closing.c_str()))
+    {
+        return false;
+    }
+
+    static const std::pair<const char *, char> entities[] = {
+        {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+
+    text.clear();
+    text.reserve(static_cast<std::size_t>(text_end - position));
+
+    while (true)
+    {
+        const auto special = std::find_if(position, text_end, [](char c) { return c == '&' || c == '\r'; });
+        text.append(position, special);
+        position = special;
+
+        if (position == text_end)
+        {
+            break;
+        }
+
+        // line breaks are normalized and character references are decoded by the parser
+        const auto entity = std::find_if(std::begin(entities), std::end(entities),
+            [position, text_end](const std::pair<const char *, char> &e) { return starts_with(position, text_end, e.first); });
+
+        if (entity == std::end(entities))
+        {
+            return false;
+        }
+
+        text.push_back(entity->second);
+        position += std::char_traits<char>::length(entity->first);
+    }
+
+    return true;
 }
 
 } // namespace
@@ -437,9 +843,21 @@ xlsx_consumer::xlsx_consumer(workbook &target)
 {
 }
 
+xlsx_consumer::xlsx_consumer(xlsx_consumer &parent, worksheet_impl *worksheet)
+    : archive_(parent.archive_),
+      parent_(&parent),
+      target_(parent.target_),
+      parser_(nullptr),
+      current_worksheet_(worksheet),
+      defined_names_(parent.defined_names_)
+{
+}
+
 xlsx_consumer::~xlsx_consumer()
 {
-    if (target_.impl().stylesheet_.is_set())
+    // formats which are only used by worksheets which haven't been read yet must not be collected
+    if (restores_garbage_collection_ && target_.impl().stylesheet_.is_set()
+        && target_.impl().pending_worksheets_ == nullptr)
     {
         // re-enable garbage collection, but do not run the garbage collection immediately, to allow a successful roundtrip without losing non-used formats.
         target_.impl().stylesheet_.get().garbage_collection_enabled = true;
@@ -448,13 +866,213 @@ xlsx_consumer::~xlsx_consumer()
 
 void xlsx_consumer::read(std::istream &source)
 {
-    archive_.reset(new izstream(source));
+    auto memory = dynamic_cast<memory_istreambuf *>(source.rdbuf());
+
+    if (memory == nullptr && (target_.load_thread_count() != 1 || target_.lazy_loading()))
+    {
+        // Worksheets are decompressed on several threads, or after load() returned,
+        // which is only possible if the archive isn't read through a stream
+        read(to_vector(source));
+
+        return;
+    }
+
+    if (target_.lazy_loading())
+    {
+        // The worksheets are read from the archive after load() returned, so it
+        // has to own a copy of the package
+        read(std::vector<std::uint8_t>(memory->data(), memory->data() + memory->size()));
+
+        return;
+    }
+
+    archive_.reset(new izstream(source, target_.zip_buffer_size()));
+    populate_workbook(false);
+}
+
+void xlsx_consumer::read(std::vector<std::uint8_t> &&data)
+{
+    // moving the vector keeps its elements where they are
+    std::unique_ptr<std::streambuf> buffer(new memory_istreambuf(data));
+    read_owned(std::move(data), std::move(buffer));
+}
+
+void xlsx_consumer::read(std::unique_ptr<std::streambuf> source)
+{
+    read_owned(std::vector<std::uint8_t>(), std::move(source));
+}
+
+void xlsx_consumer::read_owned(std::vector<std::uint8_t> data, std::unique_ptr<std::streambuf> buffer)
+{
+    if (!target_.lazy_loading() || dynamic_cast<memory_istreambuf *>(buffer.get()) == nullptr)
+    {
+        std::istream source(buffer.get());
+        read(source);
+
+        return;
+    }
+
+    pending_worksheets_.reset(new pending_worksheets());
+    pending_worksheets_->data = std::move(data);
+    pending_worksheets_->buffer = std::move(buffer);
+    pending_worksheets_->stream.reset(new std::istream(pending_worksheets_->buffer.get()));
+    pending_worksheets_->archive = std::make_shared<izstream>(*pending_worksheets_->stream, target_.zip_buffer_size());
+    archive_ = pending_worksheets_->archive;
     populate_workbook(false);
 }
 
+void xlsx_consumer::read_pending_worksheets(worksheet_impl *worksheet)
+{
+    auto &pending = *target_.d_->pending_worksheets_;
+
+    // the worksheets are still pending while they are read, so an access from within is left to this call
+    if (pending.reading)
+    {
+        return;
+    }
+
+    std::vector<std::pair<relationship, worksheet_impl *>> worksheets;
+
+    if (worksheet == nullptr)
+    {
+        worksheets = pending.worksheets;
+    }
+    else
+    {
+        auto match = std::find_if(pending.worksheets.begin(), pending.worksheets.end(),
+            [worksheet](const std::pair<relationship, worksheet_impl *> &p) { return p.second == worksheet; });
+
+        if (match == pending.worksheets.end())
+        {
+            return;
+        }
+
+        worksheets.push_back(*match);
+    }
+
+    archive_ = pending.archive;
+    defined_names_ = pending.defined_names;
+    restores_garbage_collection_ = true;
+
+    pending.reading = true;
+
+    try
+    {
+        read_worksheets(pending.workbook_rel, worksheets);
+    }
+    catch (...)
+    {
+        pending.reading = false;
+        throw;
+    }
+
+    pending.reading = false;
+
+    // only worksheets which have been read successfully are removed, a failed one is read again on the next access
+    pending.worksheets.erase(std::remove_if(pending.worksheets.begin(), pending.worksheets.end(),
+                                 [&worksheets](const std::pair<relationship, worksheet_impl *> &p) {
+                                     return std::find(worksheets.begin(), worksheets.end(), p) != worksheets.end();
+                                 }),
+        pending.worksheets.end());
+
+    if (pending.worksheets.empty())
+    {
+        // the archive reads from the package, so it is released first.
+        // This also re-enables garbage collection of the stylesheet once this consumer is destroyed
+        archive_.reset();
+        target_.d_->pending_worksheets_.reset();
+    }
+}
+
+bool xlsx_consumer::read_pending_plain_shared_strings(workbook_impl &workbook, std::size_t first, std::size_t last)
+{
+    auto &table = *workbook.pending_shared_strings_;
+    auto &strings = workbook.shared_strings_;
+    const auto data = reinterpret_cast<const char *>(table.data.data());
+    last = std::min({last, table.entries.size(), strings.size()});
+    std::string text;
+    auto preserve_space = false;
+    auto complete = true;
+
+    for (auto index = first; index < last; ++index)
+    {
+        if (table.decoded[index])
+        {
+            continue;
+        }
+
+        const auto &entry = table.entries[index];
+
+        if (!read_plain_shared_string(data + entry.first, data + entry.second, text, preserve_space))
+        {
+            complete = false;
+            continue;
+        }
+
+        strings.set(index, text, preserve_space);
+        table.decoded[index] = true;
+        --table.remaining;
+    }
+
+    if (table.remaining == 0)
+    {
+        workbook.pending_shared_strings_.reset();
+    }
+
+    return complete;
+}
+
+void xlsx_consumer::read_pending_shared_strings(std::size_t first, std::size_t last)
+{
+    if (read_pending_plain_shared_strings(*target_.d_, first, last))
+    {
+        return;
+    }
+
+    auto &table = *target_.d_->pending_shared_strings_;
+    auto &strings = target_.d_->shared_strings_;
+    const auto data = reinterpret_cast<const char *>(table.data.data());
+    last = std::min({last, table.entries.size(), strings.size()});
+
+    for (auto index = first; index < last; ++index)
+    {
+        if (table.decoded[index])
+        {
+            continue;
+        }
+
+        // the entry is parsed on its own between the tags of <sst>, which declare its namespaces
+        const auto &entry = table.entries[index];
+        std::string entry_xml(data, table.header_end);
+        entry_xml.append(data + entry.first, data + entry.second);
+        entry_xml.append(data + table.footer_begin, data + table.data.size());
+
+        std::istringstream entry_stream(entry_xml);
+        xml::parser parser(entry_stream, table.part_path);
+        parser_ = &parser;
+
+        expect_start_element(qn("spreadsheetml", "sst"), xml::content::complex);
+        skip_attributes();
+        expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
+        strings.set(index, read_rich_text(qn("spreadsheetml", "si")));
+        expect_end_element(qn("spreadsheetml", "si"));
+        expect_end_element(qn("spreadsheetml", "sst"));
+
+        parser_ = nullptr;
+
+        table.decoded[index] = true;
+        --table.remaining;
+    }
+
+    if (table.remaining == 0)
+    {
+        target_.d_->pending_shared_strings_.reset();
+    }
+}
+
 void xlsx_consumer::open(std::istream &source)
 {
-    archive_.reset(new izstream(source));
+    archive_.reset(new izstream(source, target_.zip_buffer_size()));
     populate_workbook(true);
 }
 
@@ -560,6 +1178,25 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
         streaming_cell_.reset(new detail::cell_impl());
     }
 
+    streaming_in_row_ = false;
+    streaming_calc_chain_registered_ = false;
+    worksheet_truncated_ = false;
+
+    sheet_filter_ = Sheet_Filter();
+    sheet_filter_.last_row = target_.load_last_row();
+    if (target_.load_first_row() > 1)
+    {
+        sheet_filter_.first_row = target_.load_first_row();
+    }
+    for (const auto &column : target_.load_columns())
+    {
+        if (column.index >= sheet_filter_.columns.size())
+        {
+            sheet_filter_.columns.resize(column.index + 1, false);
+        }
+        sheet_filter_.columns[column.index] = true;
+    }
+
     array_formulae_.clear();
     shared_formulae_.clear();
 
@@ -708,7 +1345,14 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
                 if (parser().attribute_present("tabSelected")
                     && is_true(parser().attribute("tabSelected")))
                 {
-                    target_.d_->view_.get().active_tab = ws.id() - 1;
+                    if (parent_ != nullptr)
+                    {
+                        deferred_tab_selected_ = true;
+                    }
+                    else
+                    {
+                        target_.d_->view_.get().active_tab = ws.id() - 1;
+                    }
                 }
 
                 skip_attributes({"windowProtection", "showFormulas", "showRowColHeaders", "showZeros", "rightToLeft", "showRuler", "showOutlineSymbols", "showWhiteSpace",
@@ -895,86 +1539,353 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
             return title;
         }
 
-        expect_end_element(current_worksheet_element);
+        expect_end_element(current_worksheet_element);
+    }
+
+    if (streaming_)
+    {
+        // There is no <sheetData>, so there are no cells to stream
+        reset_streaming_cell(streaming_cell_, nullptr);
+    }
+
+    return title;
+}
+
+void xlsx_consumer::read_worksheet_sheetdata()
+{
+    if (stack_.back() != qn("spreadsheetml", "sheetData"))
+    {
+        return;
+    }
+
+    // Inserts the rows and cells of a parsed batch into the worksheet
+    auto insert_batch = [this](Sheet_Data &batch) {
+        for (auto &row : batch.parsed_rows)
+        {
+            current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
+        }
+        current_worksheet_->cell_map_.reserve(current_worksheet_->cell_map_.size() + batch.cell_count);
+        auto impl = detail::cell_impl();
+        for (std::size_t i = 0; i < batch.cell_count; ++i)
+        {
+            Cell &cell = batch.parsed_cells[i];
+            impl.parent_ = current_worksheet_;
+            impl.column_ = cell.ref.column;
+            impl.row_ = cell.ref.row;
+            detail::cell_impl *ws_cell_impl = current_worksheet_->cell_map_.emplace(std::move(impl)).first;
+            if (cell.style_index != -1)
+            {
+                if (parent_ != nullptr)
+                {
+                    deferred_formats_.emplace_back(ws_cell_impl, static_cast<std::size_t>(cell.style_index));
+                }
+                else
+                {
+                    read_cell_format(*ws_cell_impl, static_cast<std::size_t>(cell.style_index));
+                }
+            }
+            if (cell.cell_metadata_idx != -1)
+            {
+            }
+            read_parsed_cell(current_worksheet_->cell_map_, *ws_cell_impl, cell);
+        }
+    };
+
+    // Worksheets which are read by a worker of read_worksheets are already parsed in parallel
+    auto thread_count = target_.load_thread_count();
+    const auto pipelined = parent_ == nullptr
+        && (thread_count > 1 || (thread_count == 0 && std::thread::hardware_concurrency() > 1));
+
+    if (!pipelined)
+    {
+        Sheet_Data batch;
+
+        do
+        {
+            parse_sheet_data(parser_, batch, sheet_data_batch_size, sheet_filter_, array_formulae_, shared_formulae_);
+            insert_batch(batch);
+        } while (!batch.finished);
+
+        worksheet_truncated_ = batch.truncated;
+        stack_.pop_back();
+        return;
+    }
+
+    // The XML is parsed on a second thread while this thread inserts the cells.
+    // A fixed number of batches is passed back and forth between the two threads,
+    // so memory doesn't grow with the size of the sheet.
+    // Only the parsing thread touches parser_ and the formulae maps until it's joined.
+    std::array<Sheet_Data, 3> batches;
+    std::deque<Sheet_Data *> free_batches;
+    std::deque<Sheet_Data *> parsed_batches;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::exception_ptr error;
+    bool cancelled = false;
+
+    for (auto &batch : batches)
+    {
+        free_batches.push_back(&batch);
+    }
+
+    std::thread parser_thread([&]() {
+        try
+        {
+            auto finished = false;
+
+            while (!finished)
+            {
+                Sheet_Data *batch = nullptr;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&]() { return cancelled || !free_batches.empty(); });
+
+                    if (cancelled)
+                    {
+                        return;
+                    }
+
+                    batch = free_batches.front();
+                    free_batches.pop_front();
+                }
+
+                parse_sheet_data(parser_, *batch, sheet_data_batch_size, sheet_filter_, array_formulae_, shared_formulae_);
+                finished = batch->finished;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                parsed_batches.push_back(batch);
+                changed.notify_all();
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = std::current_exception();
+            changed.notify_all();
+        }
+    });
+
+    try
+    {
+        auto finished = false;
+
+        while (!finished)
+        {
+            Sheet_Data *batch = nullptr;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return error || !parsed_batches.empty(); });
+
+                if (parsed_batches.empty())
+                {
+                    std::rethrow_exception(error);
+                }
+
+                batch = parsed_batches.front();
+                parsed_batches.pop_front();
+            }
+
+            insert_batch(*batch);
+            finished = batch->finished;
+            worksheet_truncated_ = batch->truncated;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            free_batches.push_back(batch);
+            changed.notify_all();
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+            changed.notify_all();
+        }
+
+        parser_thread.join();
+        throw;
+    }
+
+    parser_thread.join();
+    stack_.pop_back();
+}
+
+void xlsx_consumer::read_cell_format(cell_impl &cell, std::size_t style_index)
+{
+    if (style_index >= target_.format_count())
+    {
+        throw xlnt::invalid_file("cell style index " + std::to_string(style_index) + " is out of range");
     }
 
-    return title;
+    cell.format_ = target_.format(style_index).d_;
 }
 
-void xlsx_consumer::read_worksheet_sheetdata()
+void xlsx_consumer::read_worksheets(const relationship &workbook_rel,
+    const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets)
 {
-    if (stack_.back() != qn("spreadsheetml", "sheetData"))
+    auto thread_count = target_.load_thread_count();
+
+    if (thread_count == 0)
     {
-        return;
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
     }
 
-    auto ws_data = parse_sheet_data(parser_, array_formulae_, shared_formulae_);
-    // NOTE: parse->construct are seperated here and could easily be threaded
-    // with a SPSC queue for what is likely to be an easy performance win
-    for (auto &row : ws_data.parsed_rows)
+    thread_count = std::min(thread_count, worksheets.size());
+
+    if (thread_count <= 1)
     {
-        current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
+        for (const auto &worksheet : worksheets)
+        {
+            current_worksheet_ = worksheet.second;
+            read_part({workbook_rel, worksheet.first});
+        }
+
+        return;
     }
-    auto impl = detail::cell_impl();
-    for (Cell &cell : ws_data.parsed_cells)
+
+    // A worksheet part which is decompressed and parsed up to the end of its sheet data
+    // by a worker thread, then finished on this thread.
+    struct worksheet_part
+    {
+        path part_path;
+        std::vector<std::uint8_t> data;
+        std::unique_ptr<memory_istreambuf> buffer;
+        std::unique_ptr<std::istream> stream;
+        std::unique_ptr<xml::parser> parser;
+        std::unique_ptr<xlsx_consumer> consumer;
+        std::exception_ptr error;
+        bool parsed = false;
+    };
+
+    std::vector<worksheet_part> parts(worksheets.size());
+
+    for (std::size_t i = 0; i < worksheets.size(); ++i)
     {
-        impl.parent_ = current_worksheet_;
-        impl.column_ = cell.ref.column;
-        impl.row_ = cell.ref.row;
-        detail::cell_impl *ws_cell_impl = &current_worksheet_->cell_map_.emplace(cell_reference(impl.column_, impl.row_), std::move(impl)).first->second;
-        if (cell.style_index != -1)
+        parts[i].part_path = manifest().canonicalize({workbook_rel, worksheets[i].first});
+        parts[i].consumer.reset(new xlsx_consumer(*this, worksheets[i].second));
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::size_t next_part = 0;
+    std::size_t finished_parts = 0;
+    bool cancelled = false;
+
+    // Workers only touch their own worksheet and the archive, which is in memory and
+    // can be read concurrently. Everything shared by the workbook is done on this thread.
+    auto parse_parts = [&]() {
+        while (true)
+        {
+            std::size_t i = 0;
+
+            {
+                // Parts are started at most thread_count parts ahead of the one which is finished next,
+                // so that a slow part doesn't keep the inflated data of all later parts in memory
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() {
+                    return cancelled || next_part == parts.size() || next_part < finished_parts + thread_count;
+                });
+
+                if (cancelled || next_part == parts.size())
+                {
+                    return;
+                }
+
+                i = next_part++;
+            }
+
+            auto &part = parts[i];
+
+            try
+            {
+                archive_->read(part.part_path, part.data);
+                part.buffer.reset(new memory_istreambuf(part.data));
+                part.stream.reset(new std::istream(part.buffer.get()));
+                part.parser.reset(new xml::parser(*part.stream, part.part_path.string()));
+                part.consumer->parser_ = part.parser.get();
+                part.consumer->read_worksheet_begin(worksheets[i].first.id());
+                part.consumer->read_worksheet_sheetdata();
+            }
+            catch (...)
+            {
+                part.error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            part.parsed = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    auto join_workers = [&]() {
         {
-            ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+            changed.notify_all();
         }
-        if (cell.cell_metadata_idx != -1)
+
+        for (auto &worker : workers)
         {
+            worker.join();
         }
-        ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
-        if (!cell.formula_string.empty())
+
+        workers.clear();
+    };
+
+    try
+    {
+        for (std::size_t i = 0; i < thread_count; ++i)
         {
-            ws_cell_impl->formula_ = cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string);
+            workers.emplace_back(parse_parts);
         }
-        if (!cell.value.empty())
+
+        for (std::size_t i = 0; i < parts.size(); ++i)
         {
-            ws_cell_impl->type_ = cell.type;
-            switch (cell.type)
+            auto &part = parts[i];
+
             {
-            case cell::type::boolean: {
-                ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
-                break;
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&part]() { return part.parsed; });
             }
-            case cell::type::empty:
-            case cell::type::number:
-            case cell::type::date: {
-                ws_cell_impl->value_numeric_ = xlnt::detail::deserialise(cell.value);
-                break;
-            }
-            case cell::type::shared_string: {
-                long long value = -1;
-                if (xlnt::detail::parse(cell.value, value) == std::errc())
-                {
-                    ws_cell_impl->value_numeric_ = static_cast<double>(value);
-                }
-                break;
-            }
-            case cell::type::inline_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
-            }
-            case cell::type::formula_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
+
+            if (part.error)
+            {
+                std::rethrow_exception(part.error);
             }
-            case cell::type::error: {
-                ws_cell_impl->value_text_.plain_text(cell.value, false);
-                break;
+
+            auto &consumer = *part.consumer;
+
+            for (const auto &deferred : consumer.deferred_formats_)
+            {
+                read_cell_format(*deferred.first, deferred.second);
             }
+
+            if (consumer.deferred_tab_selected_)
+            {
+                target_.d_->view_.get().active_tab = consumer.current_worksheet_->id_ - 1;
             }
+
+            consumer.read_worksheet_end(worksheets[i].first.id());
+
+            // the remaining parts are still being read, release this one right away
+            part = worksheet_part();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            finished_parts = i + 1;
+            changed.notify_all();
         }
     }
-    stack_.pop_back();
-
+    catch (...)
+    {
+        join_workers();
+        throw;
+    }
 
+    join_workers();
 }
 
 worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
@@ -988,7 +1899,8 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 
     auto ws = worksheet(current_worksheet_);
 
-    while (in_element(qn("spreadsheetml", "worksheet")))
+    // Nothing after the last row which is read has been parsed, see workbook::load_rows()
+    while (!worksheet_truncated_ && in_element(qn("spreadsheetml", "worksheet")))
     {
         auto current_worksheet_element = expect_start_element(xml::content::complex);
 
@@ -1065,7 +1977,17 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
                 // CT_Hyperlink
                 expect_start_element(qn("spreadsheetml", "hyperlink"), xml::content::simple);
 
-                auto cell = ws.cell(parser().attribute("ref"));
+                const auto reference = cell_reference(parser().attribute("ref"));
+
+                // cells outside of the rows and columns which are loaded aren't created
+                if (!sheet_filter_.has_cell(reference.column_index(), reference.row()))
+                {
+                    skip_attributes();
+                    expect_end_element(qn("spreadsheetml", "hyperlink"));
+                    continue;
+                }
+
+                auto cell = ws.cell(reference);
 
                 if (parser().attribute_present(qn("r", "id")))
                 {
@@ -1105,7 +2027,7 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
                         hyperlink.tooltip = parser().attribute("tooltip");
                     }
 
-                    cell.d_->hyperlink_ = hyperlink;
+                    current_worksheet_->cell_map_.hyperlink(*cell.d_) = hyperlink;
                 }
 
                 expect_end_element(qn("spreadsheetml", "hyperlink"));
@@ -1374,7 +2296,14 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         expect_end_element(current_worksheet_element);
     }
 
-    expect_end_element(qn("spreadsheetml", "worksheet"));
+    if (worksheet_truncated_)
+    {
+        stack_.pop_back();
+    }
+    else
+    {
+        expect_end_element(qn("spreadsheetml", "worksheet"));
+    }
 
     if (manifest.has_relationship(sheet_path, xlnt::relationship_type::comments))
     {
@@ -1424,13 +2353,21 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
                 relationship_type::printer_settings)});
     }
 
-    for (auto array_formula : array_formulae_)
+    for (const auto &array_formula : array_formulae_)
     {
-        for (auto row : ws.range(array_formula.first))
+        // an array formula is clipped to the rows and columns which are loaded
+        const auto reference = range_reference(array_formula.first);
+        const auto first_row = std::max(reference.top_left().row(), sheet_filter_.first_row);
+        const auto last_row = std::min(reference.bottom_right().row(), sheet_filter_.last_row);
+
+        for (auto row = first_row; row <= last_row; ++row)
         {
-            for (auto cell : row)
+            for (auto column = reference.top_left().column_index(); column <= reference.bottom_right().column_index(); ++column)
             {
-                cell.formula(array_formula.second);
+                if (sheet_filter_.has_column(column))
+                {
+                    ws.cell(cell_reference(column, row)).formula(array_formula.second);
+                }
             }
         }
     }
@@ -1443,241 +2380,206 @@ xml::parser &xlsx_consumer::parser()
     return *parser_;
 }
 
-bool xlsx_consumer::has_cell()
+bool xlsx_consumer::parse_next_cell(sheet_visitor *visitor)
 {
-    auto ws = worksheet(current_worksheet_);
-
-    while (streaming_cell_ // we're not at the end of the file
-           && !in_element(qn("spreadsheetml", "row"))) // we're at the end of a row, or between rows
+    // Rows and cells are parsed by the same functions as in read_worksheet_sheetdata(),
+    // which work on the parser events without copying element names. The parsed cell
+    // and its strings are reused for every cell of the worksheet.
+    while (streaming_cell_) // we're not at the end of the worksheet
     {
-        if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "row"))
-        {
-            // We're at the end of a row.
-            expect_end_element(qn("spreadsheetml", "row"));
-            // ... and keep parsing.
-        }
+        xml::parser::event_type e = parser().next();
 
-        if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "sheetData"))
+        switch (e)
         {
-            // End of sheet. Mark it by setting streaming_cell_ to nullptr, so we never get here again.
-            expect_end_element(qn("spreadsheetml", "sheetData"));
-            streaming_cell_.reset(nullptr);
-            break;
-        }
-
-        expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-        row_t row_index = 0;
-        bool ok = detail::parse(parser().attribute("r"), row_index) == std::errc();
+        case xml::parser::start_element: {
+            if (!streaming_in_row_)
+            {
+                auto row = parse_row_attributes(parser_);
+                streaming_row_ = static_cast<row_t>(row.second);
 
-        if (!ok)
-        {
-#ifdef THROW_ON_INVALID_XML
-            throw xlnt::invalid_parameter("cannot parse row index \"" + parser().attribute("r") + "\"");
-#endif
-        }
-        auto &row_properties = ws.row_properties(row_index);
+                if (streaming_row_ > sheet_filter_.last_row)
+                {
+                    // The remaining rows aren't read, so stop parsing the worksheet here
+                    worksheet_truncated_ = true;
+                    stack_.pop_back();
+                    reset_streaming_cell(streaming_cell_, nullptr);
+                    break;
+                }
 
-        if (parser().attribute_present("ht"))
-        {
-            row_properties.height = xlnt::detail::deserialise(parser().attribute("ht"));
-        }
+                if (streaming_row_ < sheet_filter_.first_row)
+                {
+                    skip_sheet_data_element(parser_, shared_formulae_);
+                    break;
+                }
 
-        if (parser().attribute_present("customHeight"))
-        {
-            row_properties.custom_height = is_true(parser().attribute("customHeight"));
-        }
+                streaming_in_row_ = true;
 
-        if (parser().attribute_present("hidden") && is_true(parser().attribute("hidden")))
-        {
-            row_properties.hidden = true;
-        }
+                if (visitor != nullptr)
+                {
+                    // the cells of a visited worksheet aren't kept either, so its memory use
+                    // doesn't grow with the number of rows
+                    visitor->on_row_begin(streaming_row_);
+                }
+                else
+                {
+                    worksheet(current_worksheet_).row_properties(streaming_row_) = std::move(row.first);
+                }
 
-        if (parser().attribute_present(qn("x14ac", "dyDescent")))
-        {
-            row_properties.dy_descent = xlnt::detail::deserialise(parser().attribute(qn("x14ac", "dyDescent")));
-        }
+                break;
+            }
 
-        if (parser().attribute_present("spans"))
-        {
-            row_properties.spans = parser().attribute("spans");
-        }
+            assert(streaming_);
+            if (parse_cell(streaming_row_, parser_, streaming_cell_data_, sheet_filter_, array_formulae_, shared_formulae_))
+            {
+                return true;
+            }
 
-        if (parser().attribute_present("outlineLevel"))
-        {
-            row_properties.outline_level = parser().attribute<uint16_t>("outlineLevel");
+            break;
         }
+        case xml::parser::end_element: {
+            if (streaming_in_row_)
+            {
+                // </row>
+                streaming_in_row_ = false;
 
-        if (parser().attribute_present("collapsed"))
-        {
-            row_properties.collapsed = is_true(parser().attribute("collapsed"));
-        }
+                if (visitor != nullptr)
+                {
+                    visitor->on_row_end(streaming_row_);
+                }
 
+                break;
+            }
 
-        skip_attributes({"customFormat", "s", "customFont",
-            "thickTop", "thickBot", "ph"});
+            // </sheetData>. Mark it by setting streaming_cell_ to nullptr, so we never get here again.
+            stack_.pop_back();
+            reset_streaming_cell(streaming_cell_, nullptr);
+            break;
+        }
+        case xml::parser::characters: {
+            // ignore, whitespace formatting normally
+            break;
+        }
+        case xml::parser::start_namespace_decl:
+        case xml::parser::start_attribute:
+        case xml::parser::end_namespace_decl:
+        case xml::parser::end_attribute:
+        case xml::parser::eof:
+        default: {
+            throw xlnt::exception("unexpected XML parsing event " + std::to_string(e));
+        }
+        }
     }
 
-    if (!streaming_cell_)
+    return false;
+}
+
+bool xlsx_consumer::has_cell()
+{
+    if (!parse_next_cell(nullptr))
     {
-        // We're at the end of the worksheet
         return false;
     }
 
-    expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
-
-    assert(streaming_);
-    streaming_cell_.reset(new detail::cell_impl()); // Clean cell state - otherwise it might contain information from the previously streamed cell.
-    auto cell = xlnt::cell(streaming_cell_.get());
-    auto reference = cell_reference(parser().attribute("r"));
-    cell.d_->parent_ = current_worksheet_;
-    cell.d_->column_ = reference.column_index();
-    cell.d_->row_ = reference.row();
-
-    if (parser().attribute_present("ph"))
+    // Clean cell state - otherwise it might contain information from the previously streamed cell.
+    auto &cell = *streaming_cell_;
+    auto &cells = current_worksheet_->cell_map_;
+    cells.release_extension(cell);
+    cells.release_shared_string(cell);
+    cell.parent_ = current_worksheet_;
+    cell.column_ = streaming_cell_data_.ref.column;
+    cell.row_ = streaming_cell_data_.ref.row;
+    cell.type_ = cell_type::empty;
+    cell.value_numeric_ = 0.0;
+    cell.format_.clear();
+
+    if (streaming_cell_data_.style_index != -1)
     {
-        cell.d_->phonetics_visible_ = parser().attribute<bool>("ph");
+        read_cell_format(cell, static_cast<std::size_t>(streaming_cell_data_.style_index));
     }
 
-    auto has_type = parser().attribute_present("t");
-    auto type = has_type ? parser().attribute("t") : "n";
+    read_parsed_cell(cells, cell, streaming_cell_data_);
 
-    if (parser().attribute_present("s"))
+    if (!streaming_cell_data_.formula_string.empty() && !streaming_calc_chain_registered_)
     {
-        size_t s = 0;
-        bool ok = detail::parse(parser().attribute("s"), s) == std::errc();
-
-        if (!ok)
-        {
-#ifdef THROW_ON_INVALID_XML
-            throw xlnt::invalid_parameter("cannot parse format index \"" + parser().attribute("s") + "\"");
-#endif
-        }
-
-        cell.format(target_.format(s));
+        worksheet(current_worksheet_).register_calc_chain_in_manifest();
+        streaming_calc_chain_registered_ = true;
     }
 
-    auto has_value = false;
-    auto value_string = std::string();
-    auto formula_string = std::string();
+    return true;
+}
 
-    while (in_element(qn("spreadsheetml", "c")))
+void xlsx_consumer::read_cells(sheet_visitor &visitor)
+{
+    while (parse_next_cell(&visitor))
     {
-        auto current_element = expect_start_element(xml::content::mixed);
-
-        if (current_element == qn("spreadsheetml", "v")) // s:ST_Xstring
-        {
-            has_value = true;
-            value_string = read_text();
-        }
-        else if (current_element == qn("spreadsheetml", "f")) // CT_CellFormula
-        {
-            auto has_shared_formula = false;
-            auto has_array_formula = false;
-            auto is_master_cell = false;
-            auto shared_formula_index = 0;
-            auto formula_range = range_reference();
-
-            if (parser().attribute_present("t"))
-            {
-                auto formula_type = parser().attribute("t");
-                if (formula_type == "shared")
-                {
-                    has_shared_formula = true;
-                    shared_formula_index = parser().attribute<int>("si");
-                    if (parser().attribute_present("ref"))
-                    {
-                        is_master_cell = true;
-                    }
-                }
-                else if (formula_type == "array")
-                {
-                    has_array_formula = true;
-                    formula_range = range_reference(parser().attribute("ref"));
-                    is_master_cell = true;
-                }
-            }
+        visit_parsed_cell(visitor);
+    }
+}
 
-            skip_attributes({"aca", "dt2D", "dtr", "del1", "del2", "r1",
-                "r2", "ca", "bx"});
+void xlsx_consumer::write_delimited(delimited_text_writer &writer)
+{
+    while (parse_next_cell(&writer))
+    {
+        const auto style_index = streaming_cell_data_.style_index;
+        writer.next_format(style_index != -1, static_cast<std::size_t>(style_index));
+        visit_parsed_cell(writer);
+    }
+}
 
-            formula_string = read_text();
+void xlsx_consumer::visit_parsed_cell(sheet_visitor &visitor)
+{
+    const auto &parsed = streaming_cell_data_;
+    const auto row = parsed.ref.row;
+    const auto column = parsed.ref.column;
 
-            if (is_master_cell)
-            {
-                if (has_shared_formula)
-                {
-                    shared_formulae_[shared_formula_index] = formula_string;
-                }
-                else if (has_array_formula)
-                {
-                    array_formulae_[formula_range.to_string()] = formula_string;
-                }
-            }
-            else if (has_shared_formula)
-            {
-                auto shared_formula = shared_formulae_.find(shared_formula_index);
-                if (shared_formula != shared_formulae_.end())
-                {
-                    formula_string = shared_formula->second;
-                }
-            }
-        }
-        else if (current_element == qn("spreadsheetml", "is")) // CT_Rst
+    if (!parsed.formula_string.empty())
+    {
+        // stripped like the formulas read by read_parsed_cell
+        if (parsed.formula_string[0] == '=')
         {
-            expect_start_element(qn("spreadsheetml", "t"), xml::content::simple);
-            has_value = true;
-            value_string = read_text();
-            expect_end_element(qn("spreadsheetml", "t"));
+            visitor.on_formula(row, column, parsed.formula_string.substr(1));
         }
         else
         {
-            unexpected_element(current_element);
+            visitor.on_formula(row, column, parsed.formula_string);
         }
-
-        expect_end_element(current_element);
     }
 
-    expect_end_element(qn("spreadsheetml", "c"));
-
-    if (!formula_string.empty())
+    if (parsed.value.empty())
     {
-        cell.formula(formula_string);
+        return;
     }
 
-    if (has_value)
+    switch (parsed.type)
     {
-        if (type == "str")
-        {
-            cell.d_->value_text_ = value_string;
-            cell.data_type(cell::type::formula_string);
-        }
-        else if (type == "inlineStr")
-        {
-            cell.d_->value_text_ = value_string;
-            cell.data_type(cell::type::inline_string);
-        }
-        else if (type == "s")
-        {
-            cell.d_->value_numeric_ = xlnt::detail::deserialise(value_string);
-            cell.data_type(cell::type::shared_string);
-        }
-        else if (type == "b") // boolean
-        {
-            cell.value(is_true(value_string));
-        }
-        else if (type == "n") // numeric
-        {
-            cell.value(xlnt::detail::deserialise(value_string));
-        }
-        else if (!value_string.empty() && value_string[0] == '#')
+    case cell::type::boolean: {
+        visitor.on_boolean(row, column, is_true(parsed.value));
+        break;
+    }
+    case cell::type::empty:
+    case cell::type::number:
+    case cell::type::date: {
+        visitor.on_number(row, column, xlnt::detail::deserialise(parsed.value));
+        break;
+    }
+    case cell::type::shared_string: {
+        std::size_t index = 0;
+        if (xlnt::detail::parse(parsed.value, index) == std::errc())
         {
-            cell.error(value_string);
+            visitor.on_shared_string(row, column, index);
         }
+        break;
+    }
+    case cell::type::inline_string:
+    case cell::type::formula_string: {
+        visitor.on_inline_string(row, column, parsed.value);
+        break;
+    }
+    case cell::type::error: {
+        visitor.on_error(row, column, parsed.value);
+        break;
+    }
     }
-
-    return true;
 }
 
 std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
@@ -1734,6 +2636,13 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
 {
     const auto &manifest = target_.manifest();
     const auto part_path = manifest.canonicalize(rel_chain);
+
+    if (rel_chain.back().type() == relationship_type::shared_string_table && target_.lazy_shared_strings())
+    {
+        read_shared_string_table_index(part_path);
+        return;
+    }
+
     auto part_streambuf = archive_->open(part_path);
     std::istream part_stream(part_streambuf.get());
     xml::parser parser(part_stream, part_path.string());
@@ -2316,6 +3225,8 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         }
     }
 
+    std::vector<std::pair<relationship, worksheet_impl *>> worksheets;
+
     for (auto worksheet_rel : manifest().relationships(workbook_path, relationship_type::worksheet))
     {
         auto it_title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
@@ -2343,9 +3254,24 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
         if (!streaming_)
         {
-            read_part({workbook_rel, worksheet_rel});
+            worksheets.emplace_back(worksheet_rel, current_worksheet_);
+        }
+    }
+
+    if (pending_worksheets_ != nullptr && !streaming_)
+    {
+        if (!worksheets.empty())
+        {
+            pending_worksheets_->workbook_rel = workbook_rel;
+            pending_worksheets_->defined_names = defined_names_;
+            pending_worksheets_->worksheets = std::move(worksheets);
+            target_.d_->pending_worksheets_ = std::move(pending_worksheets_);
         }
+
+        return;
     }
+
+    read_worksheets(workbook_rel, worksheets);
 }
 
 // Write Workbook Relationship Target Parts
@@ -2401,14 +3327,44 @@ void xlsx_consumer::read_shared_string_table()
     if (parser().attribute_present("uniqueCount"))
     {
         std::size_t unique_count = parser().attribute<std::size_t>("uniqueCount");
-        if (unique_count != target_.shared_strings().size())
+        if (unique_count != target_.d_->shared_strings_.size())
         {
-            throw invalid_file("shared string sizes don't match (expected " + std::to_string(unique_count) + ", got " + std::to_string(target_.shared_strings().size()) + ")");
+            throw invalid_file("shared string sizes don't match (expected " + std::to_string(unique_count) + ", got " + std::to_string(target_.d_->shared_strings_.size()) + ")");
         }
     }
 #endif
 }
 
+void xlsx_consumer::read_shared_string_table_index(const path &part_path)
+{
+    std::unique_ptr<pending_shared_strings> table(new pending_shared_strings());
+    table->part_path = part_path.string();
+    archive_->read(part_path, table->data);
+
+    if (!index_shared_strings(*table))
+    {
+        // the table is read as usual if its entries can't be found without a parser
+        memory_istreambuf table_buffer(table->data);
+        std::istream table_stream(&table_buffer);
+        xml::parser parser(table_stream, table->part_path);
+        parser_ = &parser;
+        read_shared_string_table();
+
+        return;
+    }
+
+    if (table->entries.empty())
+    {
+        return;
+    }
+
+    target_.register_workbook_part(relationship_type::shared_string_table);
+    target_.d_->shared_strings_.resize(table->entries.size());
+    table->decoded.resize(table->entries.size(), false);
+    table->remaining = table->entries.size();
+    target_.d_->pending_shared_strings_ = std::move(table);
+}
+
 void xlsx_consumer::read_shared_workbook_revision_headers()
 {
 }
@@ -2425,6 +3381,7 @@ void xlsx_consumer::read_stylesheet()
 {
     target_.impl().stylesheet_ = detail::stylesheet();
     auto &stylesheet = target_.impl().stylesheet_.get();
+    restores_garbage_collection_ = true;
     stylesheet.garbage_collection_enabled = false; // garbage collection isn't allowed while reading the file, as other parts of the xlsx file reference to the index of a format in the stylesheet. If garbage collection is enabled, all formats will be deleted immediately (before the format usage is read).
 
     expect_start_element(qn("spreadsheetml", "styleSheet"), xml::content::complex);
@@ -3215,7 +4172,14 @@ void xlsx_consumer::read_comments(worksheet ws)
 
         expect_start_element(qn("spreadsheetml", "text"), xml::content::complex);
 
-        ws.cell(cell_ref).comment(comment(read_rich_text(qn("spreadsheetml", "text")), authors.at(author_id)));
+        const auto text = read_rich_text(qn("spreadsheetml", "text"));
+        const auto reference = cell_reference(cell_ref);
+
+        // cells outside of the rows and columns which are loaded aren't created
+        if (sheet_filter_.has_cell(reference.column_index(), reference.row()))
+        {
+            ws.cell(reference).comment(comment(text, authors.at(author_id)));
+        }
 
         expect_end_element(qn("spreadsheetml", "text"));
 
@@ -3267,18 +4231,12 @@ void xlsx_consumer::read_unknown_relationships()
 
 void xlsx_consumer::read_image(const xlnt::path &image_path)
 {
-    auto image_streambuf = archive_->open(image_path);
-    vector_ostreambuf buffer(target_.d_->images_[image_path.string()]);
-    std::ostream out_stream(&buffer);
-    out_stream << image_streambuf.get();
+    archive_->read(image_path, target_.d_->images_[image_path.string()]);
 }
 
 void xlsx_consumer::read_binary(const xlnt::path &binary_path)
 {
-    auto binary_streambuf = archive_->open(binary_path);
-    vector_ostreambuf buffer(target_.d_->binaries_[binary_path.string()]);
-    std::ostream out_stream(&buffer);
-    out_stream << binary_streambuf.get();
+    archive_->read(binary_path, target_.d_->binaries_[binary_path.string()]);
 }
 
 std::string xlsx_consumer::read_text()
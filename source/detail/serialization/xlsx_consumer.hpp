@@ -30,6 +30,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <detail/external/include_libstudxml.hpp>
@@ -55,6 +56,7 @@ class optional;
 class path;
 class range_reference;
 class relationship;
+class sheet_visitor;
 class streaming_workbook_reader;
 class variant;
 class workbook;
@@ -62,9 +64,12 @@ class worksheet;
 
 namespace detail {
 
+class delimited_text_writer;
 class izstream;
 struct cell_impl;
 struct defined_name;
+struct pending_worksheets;
+struct workbook_impl;
 struct worksheet_impl;
 
 /// <summary>
@@ -81,6 +86,18 @@ public:
 
 	void read(std::istream &source);
 
+    /// <summary>
+    /// Reads the package in data, which is kept without copying it while worksheets
+    /// skipped by a load with workbook::lazy_loading() haven't been read.
+    /// </summary>
+    void read(std::vector<std::uint8_t> &&data);
+
+    /// <summary>
+    /// Reads the package read by source, which reads from memory, e.g. a mapped file.
+    /// It is kept like the data of the overload above.
+    /// </summary>
+    void read(std::unique_ptr<std::streambuf> source);
+
 	void read(std::istream &source, const std::string &password);
 
 #if XLNT_HAS_FEATURE(U8_STRING_VIEW)
@@ -90,16 +107,69 @@ public:
     // For unit testing purpose only
     void read_stylesheet (const std::string& xml);
 
+    /// <summary>
+    /// Reads the parts of the worksheets which were skipped by a load with
+    /// workbook::lazy_loading(), or only the one of worksheet if it isn't null.
+    /// </summary>
+    void read_pending_worksheets(worksheet_impl *worksheet);
+
+    /// <summary>
+    /// Decodes the shared strings from first to last exclusive which were skipped by
+    /// a load with workbook::lazy_shared_strings().
+    /// </summary>
+    void read_pending_shared_strings(std::size_t first, std::size_t last);
+
+    /// <summary>
+    /// Decodes the shared strings from first to last exclusive like read_pending_shared_strings()
+    /// if they are plain text, which doesn't need an XML parser nor a consumer.
+    /// Returns false if some of them are rich text and have to be read by a consumer.
+    /// </summary>
+    static bool read_pending_plain_shared_strings(workbook_impl &workbook, std::size_t first, std::size_t last);
+
 private:
     friend class xlnt::streaming_workbook_reader;
 
+    /// <summary>
+    /// Creates a consumer which reads the part of the given worksheet of the package
+    /// being read by parent on another thread. See read_worksheets().
+    /// </summary>
+    xlsx_consumer(xlsx_consumer &parent, worksheet_impl *worksheet);
+
     void open(std::istream &source);
 
+    /// <summary>
+    /// Reads the package read by buffer, which reads from data or from memory owned by buffer.
+    /// </summary>
+    void read_owned(std::vector<std::uint8_t> data, std::unique_ptr<std::streambuf> buffer);
+
     template <typename T>
     void read_internal(std::istream &source, const T &password);
 
+    /// <summary>
+    /// Parses the next cell of the current worksheet into streaming_cell_data_.
+    /// The rows passed on the way are stored in the worksheet and reported to visitor
+    /// if it isn't null. Returns false at the end of the worksheet.
+    /// </summary>
+    bool parse_next_cell(sheet_visitor *visitor);
+
     bool has_cell();
 
+    /// <summary>
+    /// Passes the remaining rows and cells of the current worksheet to visitor.
+    /// </summary>
+    void read_cells(sheet_visitor &visitor);
+
+    /// <summary>
+    /// Writes the remaining rows and cells of the current worksheet with writer,
+    /// passing the style of each cell so its number format can be applied.
+    /// </summary>
+    void write_delimited(delimited_text_writer &writer);
+
+    /// <summary>
+    /// Passes the cell in streaming_cell_data_ to the callbacks of visitor.
+    /// </summary>
+    void visit_parsed_cell(sheet_visitor &visitor);
+
     /// <summary>
     /// Reads the next cell in the current worksheet and returns a wrapper pointing to it if
     /// the last cell in the sheet has not yet been read. An exception will be thrown
@@ -180,6 +250,11 @@ private:
 	/// </summary>
 	void read_shared_string_table();
 
+	/// <summary>
+	/// xl/sharedStrings.xml with workbook::lazy_shared_strings(), which only finds its entries.
+	/// </summary>
+	void read_shared_string_table_index(const path &part_path);
+
 	/// <summary>
 	///
 	/// </summary>
@@ -241,6 +316,20 @@ private:
     /// </summary>
     worksheet read_worksheet_end(const std::string &rel_id);
 
+    /// <summary>
+    /// Reads the given worksheet parts, whose worksheets have already been created.
+    /// Depending on workbook::load_thread_count(), the parts are decompressed and
+    /// their sheet data is parsed on worker threads. The rest of each part and the
+    /// parts it refers to are then read on this thread in the original order.
+    /// </summary>
+    void read_worksheets(const relationship &workbook_rel,
+        const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets);
+
+    /// <summary>
+    /// Sets the format of cell to the format at style_index of the stylesheet.
+    /// </summary>
+    void read_cell_format(cell_impl &cell, std::size_t style_index);
+
 	// Sheet Relationship Target Parts
 
 	/// <summary>
@@ -405,10 +494,33 @@ private:
     /// </summary>
     class manifest &manifest();
 
+	/// <summary>
+	/// The package and the worksheets which are left to be read after a load with
+	/// workbook::lazy_loading(), until it is handed over to target_.
+	/// </summary>
+	std::unique_ptr<pending_worksheets> pending_worksheets_;
+
 	/// <summary>
 	/// The ZIP file containing the files that make up the OOXML package.
+	/// Shared with the consumers which read worksheets on other threads.
+	/// </summary>
+	std::shared_ptr<izstream> archive_;
+
+	/// <summary>
+	/// The consumer which started this one to read a worksheet on another thread, otherwise nullptr.
+	/// </summary>
+	xlsx_consumer *parent_ = nullptr;
+
+	/// <summary>
+	/// Cells and style indices whose formats are set by parent_ once the worksheet has been parsed,
+	/// since formats are shared by all worksheets.
 	/// </summary>
-	std::unique_ptr<izstream> archive_;
+	std::vector<std::pair<cell_impl *, std::size_t>> deferred_formats_;
+
+	/// <summary>
+	/// True if a worksheet read for parent_ is the selected tab.
+	/// </summary>
+	bool deferred_tab_selected_ = false;
 
 	/// <summary>
 	/// Map of sheet titles to relationship IDs.
@@ -441,6 +553,41 @@ private:
 
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
+    /// <summary>
+    /// The last cell parsed by has_cell(). Its strings keep their capacity from cell to cell.
+    /// </summary>
+    detail::Cell streaming_cell_data_;
+
+    /// <summary>
+    /// True while has_cell() is inside a <row> element, whose index is streaming_row_.
+    /// </summary>
+    bool streaming_in_row_ = false;
+
+    row_t streaming_row_ = 0;
+
+    /// <summary>
+    /// True once a streamed cell of the current worksheet with a formula registered the calculation chain.
+    /// </summary>
+    bool streaming_calc_chain_registered_ = false;
+
+    /// <summary>
+    /// The rows and columns of the current worksheet which are read, taken from the
+    /// load options of target_ by read_worksheet_begin().
+    /// </summary>
+    detail::Sheet_Filter sheet_filter_;
+
+    /// <summary>
+    /// True if the current worksheet reached a row after the rows which are read,
+    /// so the rest of its part was not parsed.
+    /// </summary>
+    bool worksheet_truncated_ = false;
+
+    /// <summary>
+    /// True if this consumer is responsible for re-enabling the garbage collection of
+    /// the stylesheet of target_ when it's destroyed, which is disabled while reading.
+    /// </summary>
+    bool restores_garbage_collection_ = false;
+
     std::unordered_map<int, std::string> shared_formulae_;
     std::unordered_map<std::string, std::string> array_formulae_;
 
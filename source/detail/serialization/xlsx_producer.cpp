@@ -22,6 +22,7 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <cmath>
 #include <numeric> // for std::accumulate
 #include <string>
@@ -84,54 +85,195 @@ namespace detail {
 
 xlsx_producer::xlsx_producer(const workbook &target)
     : source_(target),
-      current_part_stream_(nullptr),
-      current_cell_(nullptr),
-      current_worksheet_(nullptr)
+      current_part_stream_(nullptr)
 {
 }
 
 xlsx_producer::~xlsx_producer()
 {
-    if (current_cell_)
-    {
-        delete current_cell_;
-        current_cell_ = nullptr;
-    }
-
-    if (current_worksheet_)
-    {
-        delete current_worksheet_;
-        current_worksheet_ = nullptr;
-    }
-
     end_part();
     archive_.reset();
 }
 
 void xlsx_producer::write(std::ostream &destination)
 {
-    archive_.reset(new ozstream(destination));
+    archive_.reset(new ozstream(destination, source_.zip_buffer_size()));
     populate_archive(false);
 }
 
 void xlsx_producer::open(std::ostream &destination)
 {
-    archive_.reset(new ozstream(destination));
-    populate_archive(true);
+    archive_.reset(new ozstream(destination, source_.zip_buffer_size()));
+    streaming_ = true;
+}
+
+void xlsx_producer::begin_worksheet(const worksheet &ws)
+{
+    end_worksheet();
+
+    streaming_worksheet_ = ws.d_;
+    streaming_worksheet_rel_ = ws.referring_relationship();
+    streaming_worksheet_started_ = false;
+    streaming_row_ = 0;
+    last_streamed_row_ = 0;
+
+    const auto part = ws.path();
+    streamed_worksheets_.insert(part.string());
+    begin_part(part);
 }
 
 cell xlsx_producer::add_cell(const cell_reference &ref)
 {
-    current_cell_->column_ = ref.column();
-    current_cell_->row_ = ref.row();
+    if (streaming_worksheet_ == nullptr)
+    {
+        if (!streamed_worksheets_.empty())
+        {
+            throw invalid_parameter("the streamed workbook is already closed");
+        }
 
-    return cell(current_cell_);
+        // cells added before any worksheet go to the first sheet of the workbook
+        begin_worksheet(worksheet(&source_.d_->worksheets_.front()));
+    }
+
+    if (ref.row() <= last_streamed_row_ || (streaming_row_ != 0 && ref.row() < streaming_row_))
+    {
+        throw invalid_parameter("cell " + ref.to_string() + " is above a row which was already added");
+    }
+
+    if (ref.row() != streaming_row_)
+    {
+        if (streaming_row_ != 0)
+        {
+            write_streamed_rows(ref.row() - 1);
+        }
+
+        streaming_row_ = ref.row();
+    }
+
+    return worksheet(streaming_worksheet_).cell(ref);
+}
+
+std::size_t xlsx_producer::streamed_worksheet_count() const
+{
+    return streamed_worksheets_.size();
 }
 
-worksheet xlsx_producer::add_worksheet(const std::string &title)
+void xlsx_producer::write_streamed_rows(row_t last_row)
 {
-    current_worksheet_->title_ = title;
-    return worksheet(current_worksheet_);
+    auto ws = worksheet(streaming_worksheet_);
+    auto &cells = streaming_worksheet_->cell_map_;
+    auto &row_properties = streaming_worksheet_->row_properties_;
+
+    if (!streaming_worksheet_started_)
+    {
+        write_worksheet_start(ws);
+        streaming_worksheet_started_ = true;
+    }
+
+    // rows with properties but without cells are written in order with the buffered row
+    std::vector<row_t> rows;
+
+    for (const auto &props : row_properties)
+    {
+        if (props.first > last_streamed_row_ && props.first <= last_row)
+        {
+            rows.push_back(props.first);
+        }
+    }
+
+    const auto write_buffered_row = streaming_row_ != 0 && streaming_row_ <= last_row;
+
+    if (write_buffered_row && row_properties.find(streaming_row_) == row_properties.end())
+    {
+        rows.push_back(streaming_row_);
+    }
+
+    std::sort(rows.begin(), rows.end());
+
+    for (auto row : rows)
+    {
+        write_worksheet_row(ws, row, row == streaming_row_ ? cells.row(row) : nullptr);
+        row_properties.erase(row);
+        last_streamed_row_ = row;
+    }
+
+    if (!write_buffered_row)
+    {
+        return;
+    }
+
+    const auto *entries = cells.row(streaming_row_);
+
+    if (entries != nullptr)
+    {
+        std::vector<cell_reference> written;
+        written.reserve(entries->size());
+
+        for (const auto &entry : *entries)
+        {
+            auto cell = xlnt::cell(entry.second);
+
+            if (cell.has_format())
+            {
+                // The rows were written with the ids their formats have now. Keeping these formats
+                // and all formats before them alive makes sure that garbage collection of the
+                // stylesheet doesn't remove or renumber them once their cells are released.
+                for (auto id = streamed_formats_.size(); id <= cell.format().d_->id; ++id)
+                {
+                    streamed_formats_.push_back(source_.format(id));
+                }
+            }
+
+            if (cell.has_comment() || cell.has_hyperlink())
+            {
+                // comments and hyperlinks are only written after the rows, so these cells are kept
+                cell.clear_value();
+                continue;
+            }
+
+            written.push_back(cell.reference());
+        }
+
+        for (const auto &reference : written)
+        {
+            cells.erase(reference);
+        }
+    }
+
+    streaming_row_ = 0;
+
+    if (cells.shared_string_count() == 0)
+    {
+        // streamed strings are written inline, so the table only holds strings of the row which was just written
+        source_.d_->shared_strings_.clear();
+    }
+}
+
+void xlsx_producer::end_worksheet()
+{
+    if (streaming_worksheet_ == nullptr)
+    {
+        return;
+    }
+
+    auto ws = worksheet(streaming_worksheet_);
+    write_streamed_rows(constants::max_row());
+    write_worksheet_finish(ws, streaming_worksheet_rel_);
+    end_part();
+
+    streaming_worksheet_ = nullptr;
+}
+
+void xlsx_producer::close()
+{
+    if (!archive_)
+    {
+        return;
+    }
+
+    end_worksheet();
+    populate_archive(true);
+    archive_.reset();
 }
 
 // Part Writing Methods
@@ -766,6 +908,12 @@ void xlsx_producer::write_workbook(const relationship &rel)
         auto child_target_path = child_rel.target().path();
         path archive_path(child_rel.source().path().parent().append(child_target_path));
 
+        // worksheets which were streamed are already part of the archive
+        if (streamed_worksheets_.find(archive_path.string()) != streamed_worksheets_.end())
+        {
+            continue;
+        }
+
         // write binary
         if (child_rel.type() == relationship_type::vbaproject)
         {
@@ -1022,39 +1170,34 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_start_element(xmlns, "sst");
     write_namespace(xmlns, "");
 
-    // todo: is there a more elegant way to get this number?
+    // the worksheets keep track of the cells referring to shared strings
     std::size_t string_count = 0;
 
     for (const auto ws : source_)
     {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
-
-        while (current_cell.row() <= dimension.bottom_right().row())
-        {
-            while (current_cell.column() <= dimension.bottom_right().column())
-            {
-                auto c_iter = ws.d_->cell_map_.find(current_cell);
-                if (c_iter != ws.d_->cell_map_.end() && c_iter->second.type_ == cell_type::shared_string)
-                {
-                    ++string_count;
-                }
-
-                current_cell.column_index(current_cell.column_index() + 1);
-            }
-
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
-        }
+        string_count += ws.d_->cell_map_.shared_string_count();
     }
 
     write_attribute("count", string_count);
-    write_attribute("uniqueCount", source_.shared_strings().size());
+    const auto &strings = source_.d_->shared_strings_;
+    write_attribute("uniqueCount", strings.size());
 
-    for (const auto &text : source_.shared_strings())
+    for (std::size_t index = 0; index < strings.size(); ++index)
     {
         write_start_element(xmlns, "si");
-        write_rich_text(xmlns, text);
+
+        // plain text is written like write_rich_text() does, without creating a rich_text
+        if (strings.is_plain(index))
+        {
+            write_start_element(xmlns, "t");
+            write_characters(strings.plain_text(index), strings.preserve_space(index));
+            write_end_element(xmlns, "t");
+        }
+        else
+        {
+            write_rich_text(xmlns, strings.get(index));
+        }
+
         write_end_element(xmlns, "si");
     }
 
@@ -2286,11 +2429,6 @@ void xlsx_producer::write_volatile_dependencies(const relationship & /*rel*/)
 
 void xlsx_producer::write_worksheet(const relationship &rel)
 {
-    static const auto &xmlns = constants::ns("spreadsheetml");
-    static const auto &xmlns_r = constants::ns("r");
-    static const auto &xmlns_mc = constants::ns("mc");
-    static const auto &xmlns_x14ac = constants::ns("x14ac");
-
     auto it_title = std::find_if(source_.d_->sheet_title_rel_id_map_.begin(), source_.d_->sheet_title_rel_id_map_.end(),
         [&rel](const std::pair<std::string, std::string> &p) {
             return p.second == rel.id();
@@ -2301,11 +2439,67 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     }
     const auto &title = it_title->first;
 
-    auto worksheet_part = rel.source().path().parent().append(rel.target().path());
-    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
-
     auto ws = source_.sheet_by_title(title);
 
+    write_worksheet_start(ws);
+
+    const auto &cells = ws.d_->cell_map_;
+
+    // rows with properties are written even if they don't contain any cells,
+    // so these are merged in ascending order with the rows of the cell store
+    std::vector<row_t> property_rows;
+    property_rows.reserve(ws.d_->row_properties_.size());
+    for (const auto &props : ws.d_->row_properties_)
+    {
+        property_rows.push_back(props.first);
+    }
+    std::sort(property_rows.begin(), property_rows.end());
+
+    if (!property_rows.empty())
+    {
+        worksheet_state_.first_row = std::min(worksheet_state_.first_row, property_rows.front());
+    }
+
+    auto next_property_row = property_rows.begin();
+
+    cells.for_each_row([&](row_t row, const detail::cell_store::row_entries &entries) {
+        while (next_property_row != property_rows.end() && *next_property_row < row)
+        {
+            write_worksheet_row(ws, *next_property_row++, nullptr);
+        }
+
+        if (next_property_row != property_rows.end() && *next_property_row == row)
+        {
+            ++next_property_row;
+        }
+
+        write_worksheet_row(ws, row, &entries);
+    });
+
+    while (next_property_row != property_rows.end())
+    {
+        write_worksheet_row(ws, *next_property_row++, nullptr);
+    }
+
+    write_worksheet_finish(ws, rel);
+}
+
+void xlsx_producer::write_worksheet_start(const worksheet &ws)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+    static const auto &xmlns_mc = constants::ns("mc");
+    static const auto &xmlns_x14ac = constants::ns("x14ac");
+
+    worksheet_state_ = worksheet_state();
+
+    const auto &cells = ws.d_->cell_map_;
+
+    if (!cells.empty())
+    {
+        worksheet_state_.first_row = cells.begin()->row_;
+    }
+
     write_start_element(xmlns, "worksheet");
     write_namespace(xmlns, "");
     write_namespace(xmlns_r, "r");
@@ -2336,6 +2530,7 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_namespace(xmlns_mc, "mc");
         write_namespace(xmlns_x14ac, "x14ac");
         write_attribute(xml::qname(xmlns_mc, "Ignorable"), "x14ac");
+        worksheet_state_.x14ac_declared = true;
     }
 
     if (ws.d_->sheet_properties_.is_set())
@@ -2416,10 +2611,14 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_end_element(xmlns, "sheetPr");
     }
 
-    write_start_element(xmlns, "dimension");
-    const auto dimension = ws.calculate_dimension();
-    write_attribute("ref", dimension.to_string());
-    write_end_element(xmlns, "dimension");
+    // the dimension isn't known yet when the rows are streamed, but it's optional
+    if (!streaming_)
+    {
+        write_start_element(xmlns, "dimension");
+        const auto dimension = ws.calculate_dimension();
+        write_attribute("ref", dimension.to_string());
+        write_end_element(xmlns, "dimension");
+    }
 
     if (ws.has_view())
     {
@@ -2614,241 +2813,296 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_end_element(xmlns, "cols");
     }
 
-    std::vector<std::pair<std::string, hyperlink>> hyperlinks;
-    std::vector<cell_reference> cells_with_comments;
-
     write_start_element(xmlns, "sheetData");
-    auto first_row = ws.lowest_row_or_props();
-    auto last_row = ws.highest_row_or_props();
-    auto first_block_column = constants::max_column();
-    auto last_block_column = constants::min_column();
+}
 
-    for (auto row = first_row; row <= last_row; ++row)
+void xlsx_producer::write_worksheet_row(const worksheet &ws, row_t row, const cell_store::row_entries *entries)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    const auto &cells = ws.d_->cell_map_;
+    auto any_non_null = false;
+
+    if (entries != nullptr)
     {
-        bool any_non_null = false;
-        auto first_check_row = row;
-        auto last_check_row = row;
-        auto first_row_in_block = row == first_row || row % 16 == 1;
+        for (const auto &entry : *entries)
+        {
+            if (!cells.is_garbage_collectible(*entry.second))
+            {
+                any_non_null = true;
+                break;
+            }
+        }
+    }
+
+    if (!any_non_null && !ws.has_row_properties(row)) return;
 
-        // See note for CT_Row, span attribute about block optimization
-        if (first_row_in_block)
+    // rows and cells are written directly to the part, see begin_raw_markup()
+    auto &raw = begin_raw_markup();
+
+    raw.write("<row");
+    raw.attribute("r", format_number(row));
+
+    // The spans of a block can only be calculated once all of its rows are known,
+    // which isn't the case while they are streamed. They are optional, so they are left out.
+    if (!streaming_)
+    {
+        // See note for CT_Row, span attribute about block optimization.
+        // A block starts at the first row and at each row following a multiple of 16
+        // and ends at the next multiple of 16 after its start.
+        auto block_start = std::max(worksheet_state_.first_row, static_cast<row_t>(row - (row - 1) % 16));
+
+        if (block_start != worksheet_state_.current_block_start)
         {
-            // reset block column range
-            first_block_column = constants::max_column();
-            last_block_column = constants::min_column();
+            worksheet_state_.current_block_start = block_start;
+            worksheet_state_.first_block_column = constants::max_column();
+            worksheet_state_.last_block_column = constants::min_column();
 
-            first_check_row = row;
             // round up to the next multiple of 16
-            last_check_row = ((row / 16) + 1) * 16;
-        }
+            auto block_end = ((block_start / 16) + 1) * 16;
 
-        for (auto check_row = first_check_row; check_row <= last_check_row; ++check_row)
-        {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
+            for (auto check_row = block_start; check_row <= block_end && check_row >= block_start; ++check_row)
             {
-                auto ref = cell_reference(column, check_row);
-                auto cell = ws.d_->cell_map_.find(ref);
-                if (cell == ws.d_->cell_map_.end())
-                {
-                    continue;
-                }
-                if (cell->second.is_garbage_collectible())
-                {
-                    continue;
-                }
+                auto check_entries = cells.row(check_row);
+                if (check_entries == nullptr) continue;
 
-                first_block_column = std::min(first_block_column, cell->second.column_);
-                last_block_column = std::max(last_block_column, cell->second.column_);
-
-                if (row == check_row)
+                for (const auto &entry : *check_entries)
                 {
-                    any_non_null = true;
+                    if (cells.is_garbage_collectible(*entry.second)) continue;
+
+                    worksheet_state_.first_block_column = std::min(worksheet_state_.first_block_column, entry.second->column_);
+                    worksheet_state_.last_block_column = std::max(worksheet_state_.last_block_column, entry.second->column_);
                 }
             }
         }
 
-        if (!any_non_null && !ws.has_row_properties(row)) continue;
+        raw.write(" spans=\"");
+        raw.write(format_number(worksheet_state_.first_block_column.index));
+        raw.write(":");
+        raw.write(format_number(worksheet_state_.last_block_column.index));
+        raw.write("\"");
+    }
+
+    if (ws.has_row_properties(row))
+    {
+        const auto &props = ws.row_properties(row);
+
+        if (props.style.is_set())
+        {
+            raw.attribute("s", format_number(props.style.get()));
+        }
+        if (props.custom_format.is_set())
+        {
+            raw.attribute("customFormat", write_bool(props.custom_format.get()));
+        }
 
-        write_start_element(xmlns, "row");
-        write_attribute("r", row);
+        if (props.height.is_set())
+        {
+            raw.attribute("ht", format_number(props.height.get()));
+        }
 
-        auto span_string = std::to_string(first_block_column.index) + ":"
-            + std::to_string(last_block_column.index);
-        write_attribute("spans", span_string);
+        if (props.hidden)
+        {
+            raw.attribute("hidden", write_bool(true));
+        }
 
-        if (ws.has_row_properties(row))
+        if (props.custom_height)
         {
-            const auto &props = ws.row_properties(row);
+            raw.attribute("customHeight", write_bool(true));
+        }
 
-            if (props.style.is_set())
-            {
-                write_attribute("s", props.style.get());
-            }
-            if (props.custom_format.is_set())
+        if (props.dy_descent.is_set())
+        {
+            // rows which are streamed after the start of the worksheet may need to declare the prefix
+            if (!worksheet_state_.x14ac_declared)
             {
-                write_attribute("customFormat", write_bool(props.custom_format.get()));
+                raw.attribute("xmlns:x14ac", constants::ns("x14ac"));
             }
 
-            if (props.height.is_set())
-            {
-                auto height = props.height.get();
-                write_attribute("ht", xlnt::detail::serialise(height));
-            }
+            raw.attribute("x14ac:dyDescent", format_number(props.dy_descent.get()));
+        }
 
-            if (props.hidden)
-            {
-                write_attribute("hidden", write_bool(true));
-            }
+        if (props.outline_level.is_set())
+        {
+            raw.attribute("outlineLevel", format_number(props.outline_level.get()));
+        }
 
-            if (props.custom_height)
-            {
-                write_attribute("customHeight", write_bool(true));
-            }
+        if (props.collapsed.is_set())
+        {
+            raw.attribute("collapsed", write_bool(props.collapsed.get()));
+        }
+    }
 
-            if (props.dy_descent.is_set())
-            {
-                write_attribute<double>(xml::qname(xmlns_x14ac, "dyDescent"), props.dy_descent.get());
-            }
+    if (!any_non_null)
+    {
+        raw.write("/>");
+        return;
+    }
 
-            if (props.outline_level.is_set())
-            {
-                write_attribute("outlineLevel", props.outline_level.get());
-            }
+    raw.write(">");
 
-            if (props.collapsed.is_set())
-            {
-                write_attribute("collapsed", write_bool(props.collapsed.get()));
-            }
+    for (const auto &entry : *entries)
+    {
+        if (cells.is_garbage_collectible(*entry.second)) continue;
+
+        auto cell = xlnt::cell(entry.second);
+
+        // record data about the cell needed later
+
+        if (cell.has_comment())
+        {
+            worksheet_state_.cells_with_comments.push_back(cell.reference());
         }
 
-        if (any_non_null)
+        if (cell.has_hyperlink())
         {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-            {
-                if (!ws.has_cell(cell_reference(column, row))) continue;
+            worksheet_state_.hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
+        }
 
-                auto cell = ws.cell(cell_reference(column, row));
+        // begin cell attributes
 
-                if (cell.garbage_collectible()) continue;
+        raw.write("<c r=\"");
+        xlnt::detail::serialise(xlnt::detail::Cell_Reference(entry.second->row_, entry.second->column_.index), number_buffer_);
+        raw.write(number_buffer_);
+        raw.write("\"");
 
-                // record data about the cell needed later
+        if (cell.phonetics_visible())
+        {
+            raw.attribute("ph", write_bool(true));
+        }
 
-                if (cell.has_comment())
-                {
-                    cells_with_comments.push_back(cell.reference());
-                }
+        if (cell.has_format())
+        {
+            raw.attribute("s", format_number(cell.format().d_->id));
+        }
 
-                if (cell.has_hyperlink())
-                {
-                    hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
-                }
+        switch (cell.data_type())
+        {
+        case cell::type::empty:
+            break;
 
-                write_start_element(xmlns, "c");
+        case cell::type::boolean:
+            raw.write(" t=\"b\"");
+            break;
 
-                // begin cell attributes
+        case cell::type::date:
+            raw.write(" t=\"d\"");
+            break;
 
-                write_attribute("r", cell.reference().to_string());
+        case cell::type::error:
+            raw.write(" t=\"e\"");
+            break;
 
-                if (cell.phonetics_visible())
-                {
-                    write_attribute("ph", write_bool(true));
-                }
+        case cell::type::inline_string:
+            raw.write(" t=\"inlineStr\"");
+            break;
 
-                if (cell.has_format())
-                {
-                    write_attribute("s", cell.format().d_->id);
-                }
+        case cell::type::number: // default, don't write it
+            //raw.write(" t=\"n\"");
+            break;
 
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
+        case cell::type::shared_string:
+            // streamed strings are written inline, so the shared string table never has to be kept
+            if (streaming_)
+            {
+                raw.write(" t=\"inlineStr\"");
+            }
+            else
+            {
+                raw.write(" t=\"s\"");
+            }
+            break;
 
-                case cell::type::boolean:
-                    write_attribute("t", "b");
-                    break;
+        case cell::type::formula_string:
+            raw.write(" t=\"str\"");
+            break;
+        }
 
-                case cell::type::date:
-                    write_attribute("t", "d");
-                    break;
+        //raw.attribute("cm", "");
+        //raw.attribute("vm", "");
+        //raw.attribute("ph", "");
 
-                case cell::type::error:
-                    write_attribute("t", "e");
-                    break;
+        if (!cell.has_formula() && cell.data_type() == cell::type::empty)
+        {
+            raw.write("/>");
+            continue;
+        }
 
-                case cell::type::inline_string:
-                    write_attribute("t", "inlineStr");
-                    break;
+        raw.write(">");
 
-                case cell::type::number: // default, don't write it
-                    //write_attribute("t", "n");
-                    break;
+        // begin child elements
 
-                case cell::type::shared_string:
-                    write_attribute("t", "s");
-                    break;
+        if (cell.has_formula())
+        {
+            raw.element("f", cell.formula());
+        }
 
-                case cell::type::formula_string:
-                    write_attribute("t", "str");
-                    break;
-                }
+        switch (cell.data_type())
+        {
+        case cell::type::empty:
+            break;
 
-                //write_attribute("cm", "");
-                //write_attribute("vm", "");
-                //write_attribute("ph", "");
+        case cell::type::boolean:
+            raw.element("v", write_bool(cell.value<bool>()));
+            break;
 
-                // begin child elements
+        case cell::type::date:
+            raw.element("v", cell.value<std::string>());
+            break;
 
-                if (cell.has_formula())
-                {
-                    write_element(xmlns, "f", cell.formula());
-                }
+        case cell::type::error:
+            raw.element("v", cell.value<std::string>());
+            break;
 
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
-
-                case cell::type::boolean:
-                    write_element(xmlns, "v", write_bool(cell.value<bool>()));
-                    break;
-
-                case cell::type::date:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::error:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::inline_string:
-                    write_start_element(xmlns, "is");
-                    write_rich_text(xmlns, cell.value<xlnt::rich_text>());
-                    write_end_element(xmlns, "is");
-                    break;
-
-                case cell::type::number:
-                    write_start_element(xmlns, "v");
-                    write_characters(xlnt::detail::serialise(cell.value<double>()));
-                    write_end_element(xmlns, "v");
-                    break;
-
-                case cell::type::shared_string:
-                    write_element(xmlns, "v", static_cast<std::size_t>(cell.d_->value_numeric_));
-                    break;
-
-                case cell::type::formula_string:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-                }
+        case cell::type::inline_string:
+            // rich text is rare enough to be written by the serializer
+            raw.write("<is>");
+            write_rich_text(xmlns, cell.value<xlnt::rich_text>());
+            begin_raw_markup().write("</is>");
+            break;
 
-                write_end_element(xmlns, "c");
+        case cell::type::number:
+            raw.write("<v>");
+            raw.write(format_number(cell.value<double>()));
+            raw.write("</v>");
+            break;
+
+        case cell::type::shared_string:
+            if (streaming_)
+            {
+                raw.write("<is>");
+                write_rich_text(xmlns, cell.value<xlnt::rich_text>());
+                begin_raw_markup().write("</is>");
+            }
+            else
+            {
+                raw.write("<v>");
+                raw.write(format_number(static_cast<std::size_t>(cell.d_->value_numeric_)));
+                raw.write("</v>");
             }
+            break;
+
+        case cell::type::formula_string:
+            raw.element("v", cell.value<std::string>());
+            break;
         }
 
-        write_end_element(xmlns, "row");
+        raw.write("</c>");
     }
 
+    raw.write("</row>");
+}
+
+void xlsx_producer::write_worksheet_finish(const worksheet &ws, const relationship &rel)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+
+    auto worksheet_part = rel.source().path().parent().append(rel.target().path());
+    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
+    const auto &hyperlinks = worksheet_state_.hyperlinks;
+    const auto &cells_with_comments = worksheet_state_.cells_with_comments;
+
     write_end_element(xmlns, "sheetData");
 
     if (ws.has_auto_filter())
@@ -3241,7 +3495,6 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         }
     }
 }
-
 // Sheet Relationship Target Parts
 
 void xlsx_producer::write_comments(const relationship & /*rel*/, worksheet ws, const std::vector<cell_reference> &cells)
@@ -3602,5 +3855,14 @@ void xlsx_producer::write_namespace(const std::string &ns, const std::string &pr
     current_part_serializer_->namespace_decl(ns, prefix);
 }
 
+raw_xml_writer &xlsx_producer::begin_raw_markup()
+{
+    // characters, even none, make the serializer write the '>' of a pending start tag
+    current_part_serializer_->characters(std::string());
+    raw_writer_.reset(current_part_streambuf_.get());
+
+    return raw_writer_;
+}
+
 } // namespace detail
 } // namespace xlnt
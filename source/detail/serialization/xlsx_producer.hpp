@@ -27,10 +27,18 @@
 #include <iostream>
 #include <memory>
 #include <type_traits>
+#include <unordered_set>
 #include <vector>
 
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/cell/hyperlink.hpp>
+#include <xlnt/packaging/relationship.hpp>
+#include <xlnt/utils/optional.hpp>
+#include <xlnt/styles/format.hpp>
 #include <detail/constants.hpp>
+#include <detail/implementations/cell_store.hpp>
 #include <detail/external/include_libstudxml.hpp>
+#include <detail/serialization/raw_xml_writer.hpp>
 #include <detail/serialization/serialisation_helpers.hpp>
 #include <xlnt/internal/features.hpp>
 #include <xlnt/utils/value_with_default.h>
@@ -50,12 +58,10 @@ namespace xlnt {
 
 class border;
 class cell;
-class cell_reference;
 class color;
 class fill;
 class font;
 class path;
-class relationship;
 class rich_text;
 class streaming_workbook_writer;
 class variant;
@@ -96,9 +102,37 @@ private:
     template <typename T>
     void write_internal(std::ostream &destination, const T &password);
 
+    /// <summary>
+    /// Finishes the worksheet which is currently streamed, if any, and opens the part of ws
+    /// in the archive. Its rows are written as add_cell moves on to the following rows.
+    /// </summary>
+    void begin_worksheet(const worksheet &ws);
+
+    /// <summary>
+    /// Returns the cell at ref of the streamed worksheet. The row which was buffered before
+    /// is written and its cells are released if ref is in a later row.
+    /// </summary>
     cell add_cell(const cell_reference &ref);
 
-    worksheet add_worksheet(const std::string &title);
+    /// <summary>
+    /// Returns the number of worksheets which were streamed so far, including the current one.
+    /// </summary>
+    std::size_t streamed_worksheet_count() const;
+
+    /// <summary>
+    /// Finishes the streamed worksheet and writes all remaining parts of the workbook.
+    /// </summary>
+    void close();
+
+    /// <summary>
+    /// Writes the buffered row and the rows with properties up to and including last_row.
+    /// </summary>
+    void write_streamed_rows(row_t last_row);
+
+    /// <summary>
+    /// Writes the remaining rows and the end of the streamed worksheet.
+    /// </summary>
+    void end_worksheet();
 
 	/// <summary>
 	/// Write all files needed to create a valid XLSX file which represents all
@@ -140,6 +174,9 @@ private:
 	void write_chartsheet(const relationship &rel);
 	void write_dialogsheet(const relationship &rel);
 	void write_worksheet(const relationship &rel);
+    void write_worksheet_start(const worksheet &ws);
+    void write_worksheet_row(const worksheet &ws, row_t row, const cell_store::row_entries *entries);
+    void write_worksheet_finish(const worksheet &ws, const relationship &rel);
 
 	// Sheet Relationship Target Parts
 
@@ -171,14 +208,22 @@ private:
     void write_colors(const std::vector<xlnt::color> &colors);
     void write_rich_text(const std::string &ns, const xlnt::rich_text &text);
 
-    template<typename T>
-    void write_element(const std::string &ns, const std::string &name, T value, bool preserve_whitespace = false)
+    template <typename T, typename = typename std::enable_if<!std::is_arithmetic<T>::value>::type>
+    void write_element(const std::string &ns, const std::string &name, const T &value, bool preserve_whitespace = false)
     {
         write_start_element(ns, name);
         write_characters(value, preserve_whitespace);
         write_end_element(ns, name);
     }
 
+    template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, T>::type* = nullptr>
+    void write_element(const std::string &ns, const std::string &name, T value)
+    {
+        write_start_element(ns, name);
+        write_characters(value);
+        write_end_element(ns, name);
+    }
+
     void write_start_element(const std::string &name);
 
     void write_start_element(const std::string &ns, const std::string &name);
@@ -189,6 +234,13 @@ private:
 
     void write_namespace(const std::string &ns, const std::string &prefix);
 
+    /// <summary>
+    /// Completes the start tag the serializer may have left open and returns raw_writer_,
+    /// which then writes to the part directly. The serializer can be used again once the
+    /// raw markup is complete, for example to write an element nested in it.
+    /// </summary>
+    raw_xml_writer &begin_raw_markup();
+
     // std::string attribute name
     // not integer or float type
     template <typename T, typename = typename std::enable_if<!std::is_convertible<T, double>::value>::type>
@@ -200,13 +252,13 @@ private:
     template <typename T, typename std::enable_if<std::is_floating_point<T>::value, T>::type* = nullptr>
     void write_attribute(const std::string &name, T value)
     {
-        current_part_serializer_->attribute(name, xlnt::detail::serialise(value));
+        current_part_serializer_->attribute(name, format_number(value));
     }
 
     template <typename T, typename std::enable_if<std::is_integral<T>::value, T>::type* = nullptr>
     void write_attribute(const std::string &name, T value)
     {
-        current_part_serializer_->attribute(name, std::to_string(value));
+        current_part_serializer_->attribute(name, format_number(value));
     }
 
     // qname attribute name
@@ -220,13 +272,13 @@ private:
     template <typename T, typename std::enable_if<std::is_floating_point<T>::value, T>::type* = nullptr>
     void write_attribute(const xml::qname &name, T value)
     {
-        current_part_serializer_->attribute(name, xlnt::detail::serialise(value));
+        current_part_serializer_->attribute(name, format_number(value));
     }
 
     template <typename T, typename std::enable_if<std::is_integral<T>::value, T>::type* = nullptr>
     void write_attribute(const xml::qname &name, T value)
     {
-        current_part_serializer_->attribute(name, std::to_string(value));
+        current_part_serializer_->attribute(name, format_number(value));
     }
 
     template <typename T, typename DEFAULT_VALUE>
@@ -236,7 +288,8 @@ private:
             write_attribute(name, value.get());
     }
 
-    template <typename T>
+    // not integer or float type
+    template <typename T, typename = typename std::enable_if<!std::is_arithmetic<T>::value>::type>
     void write_characters(T characters, bool preserve_whitespace = false)
     {
         if (preserve_whitespace)
@@ -247,6 +300,45 @@ private:
         current_part_serializer_->characters(characters);
     }
 
+    void write_characters(const std::string &characters, bool preserve_whitespace = false)
+    {
+        if (preserve_whitespace)
+        {
+            write_attribute(xml::qname(constants::ns("xml"), "space"), "preserve");
+        }
+
+        current_part_serializer_->characters(characters);
+    }
+
+    template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, T>::type* = nullptr>
+    void write_characters(T value)
+    {
+        current_part_serializer_->characters(format_number(value));
+    }
+
+    /// <summary>
+    /// Formats value into number_buffer_ and returns it. The buffer is overwritten by the next call.
+    /// </summary>
+    const std::string &format_number(double value)
+    {
+        xlnt::detail::serialise(value, number_buffer_);
+        return number_buffer_;
+    }
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, T>::type* = nullptr>
+    const std::string &format_number(T value)
+    {
+        xlnt::detail::serialise_integer(static_cast<long long>(value), number_buffer_);
+        return number_buffer_;
+    }
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, T>::type* = nullptr>
+    const std::string &format_number(T value)
+    {
+        xlnt::detail::serialise_integer(static_cast<unsigned long long>(value), number_buffer_);
+        return number_buffer_;
+    }
+
 	/// <summary>
 	/// A reference to the workbook which is the object of read/write operations.
 	/// </summary>
@@ -257,13 +349,68 @@ private:
     std::unique_ptr<std::streambuf> current_part_streambuf_;
     std::ostream current_part_stream_;
 
-    bool streaming_ = false;
+    /// <summary>
+    /// Numbers and cell references are formatted into this buffer before they are written,
+    /// so that writing a cell doesn't allocate a string for each of them.
+    /// </summary>
+    std::string number_buffer_;
 
-    std::unique_ptr<detail::cell_impl> streaming_cell_;
+    /// <summary>
+    /// Writes the rows and cells of sheetData, see begin_raw_markup().
+    /// </summary>
+    raw_xml_writer raw_writer_;
 
-    detail::cell_impl *current_cell_ = nullptr;
+    bool streaming_ = false;
 
-    detail::worksheet_impl *current_worksheet_ = nullptr;
+    /// <summary>
+    /// The state of the worksheet which is currently written, which is needed
+    /// from one row to the next and for the parts following the rows.
+    /// </summary>
+    struct worksheet_state
+    {
+        row_t first_row = constants::max_row();
+        row_t current_block_start = 0;
+        column_t first_block_column = constants::max_column();
+        column_t last_block_column = constants::min_column();
+        std::vector<std::pair<std::string, hyperlink>> hyperlinks;
+        std::vector<cell_reference> cells_with_comments;
+        bool x14ac_declared = false;
+    };
+
+    worksheet_state worksheet_state_;
+
+    /// <summary>
+    /// The worksheet whose part is open while streaming or nullptr.
+    /// </summary>
+    detail::worksheet_impl *streaming_worksheet_ = nullptr;
+
+    relationship streaming_worksheet_rel_;
+
+    /// <summary>
+    /// True once the elements preceding the rows of the streamed worksheet are written.
+    /// </summary>
+    bool streaming_worksheet_started_ = false;
+
+    /// <summary>
+    /// The row whose cells are currently buffered, or 0 if there is none.
+    /// </summary>
+    row_t streaming_row_ = 0;
+
+    /// <summary>
+    /// The last row written to the streamed worksheet, or 0 if there is none.
+    /// </summary>
+    row_t last_streamed_row_ = 0;
+
+    /// <summary>
+    /// The parts of the worksheets which were streamed and mustn't be written again.
+    /// </summary>
+    std::unordered_set<std::string> streamed_worksheets_;
+
+    /// <summary>
+    /// The formats up to the highest id written to a streamed row, which are referenced
+    /// here so that their ids stay the same after the cells using them are released.
+    /// </summary>
+    std::vector<format> streamed_formats_;
 };
 
 } // namespace detail
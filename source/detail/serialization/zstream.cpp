@@ -34,12 +34,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 */
 
 #include <algorithm>
-#include <array>
 #include <cassert>
+#include <climits>
 #include <cstring>
 #include <iostream>
 #include <iterator> // for std::back_inserter
 #include <string>
+#include <utility>
+#include <vector>
 #include <miniz.h>
 
 #include <xlnt/utils/exceptions.hpp>
@@ -60,6 +62,15 @@ T read_int(std::istream &stream)
     return value;
 }
 
+template <class T>
+T read_int(const std::uint8_t *data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+
+    return value;
+}
+
 template <class T>
 void write_int(std::ostream &stream, T value)
 {
@@ -164,62 +175,88 @@ void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, co
     }
 }
 
+const std::uint16_t deflated = 8;
+const std::uint16_t stored = 0;
+
+/// <summary>
+/// Returns true if the entry described by header is deflated and false if it is stored.
+/// Throws unsupported for any other compression method.
+/// </summary>
+bool is_deflated(const xlnt::detail::zheader &header)
+{
+    if (header.compression_type == deflated)
+    {
+        return true;
+    }
+
+    if (header.compression_type == stored)
+    {
+        return false;
+    }
+
+    throw xlnt::unsupported("unsupported compression type " + std::to_string(header.compression_type) + ", should be DEFLATE or uncompressed");
+}
+
+// DEFLATE can't expand data by more than this factor
+const std::size_t max_deflate_ratio = 1032;
+
+// The largest buffer allocated for an entry before any of its data arrived
+const std::size_t max_initial_entry_size = 64 * 1024 * 1024;
+
+/// <summary>
+/// Returns the size of the buffer to start inflating the entry described by header into.
+/// The sizes in the header aren't trusted yet, so this is limited to what the compressed
+/// data can expand to and to max_initial_entry_size. The buffer grows if the entry is larger.
+/// </summary>
+std::size_t initial_entry_size(const xlnt::detail::zheader &header, std::size_t buffer_size)
+{
+    const auto expanded = std::max(std::uint64_t(header.compressed_size) * max_deflate_ratio, std::uint64_t(buffer_size));
+
+    return static_cast<std::size_t>(std::min({std::uint64_t(header.uncompressed_size), expanded, std::uint64_t(max_initial_entry_size)}));
+}
+
 } // namespace
 
 namespace xlnt {
 namespace detail {
 
-static const std::size_t buffer_size = 512;
-
 class zip_streambuf_decompress : public std::streambuf
 {
     std::istream &istream;
+    const std::uint8_t *source; // the entry's data if the archive is in memory, otherwise read from istream
 
     z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::size_t buffer_size;
+    std::vector<char> in;
+    std::vector<char> out;
     zheader header;
     std::size_t total_read;
     std::size_t total_uncompressed;
     bool valid;
     bool compressed_data;
 
-    static const unsigned short DEFLATE = 8;
-    static const unsigned short UNCOMPRESSED = 0;
-
 public:
-    zip_streambuf_decompress(std::istream &stream, zheader central_header)
-        : istream(stream), header(central_header), total_read(0), total_uncompressed(0), valid(true)
+    zip_streambuf_decompress(std::istream &stream, const std::uint8_t *entry_data, zheader central_header, std::size_t buffer_size_)
+        : istream(stream), source(entry_data), buffer_size(buffer_size_), in(source ? 0 : buffer_size_, 0), out(buffer_size_, 0),
+          header(central_header), total_read(0), total_uncompressed(0), valid(true), compressed_data(false)
     {
-        in.fill(0);
-        out.fill(0);
-
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
         strm.opaque = nullptr;
         strm.avail_in = 0;
         strm.next_in = nullptr;
 
-        setg(in.data(), in.data(), in.data());
+        setg(out.data(), out.data(), out.data());
         setp(nullptr, nullptr);
 
-        // skip the header
-        read_header(istream, false);
-
-        if (header.compression_type == DEFLATE)
-        {
-            compressed_data = true;
-        }
-        else if (header.compression_type == UNCOMPRESSED)
-        {
-            compressed_data = false;
-        }
-        else
+        if (source == nullptr)
         {
-            compressed_data = false;
-            throw xlnt::unsupported("unsupported compression type " + std::to_string(header.compression_type) + ", should be DEFLATE or uncompressed");
+            // skip the header
+            read_header(istream, false);
         }
 
+        compressed_data = is_deflated(header);
+
         // initialize the inflate
         if (compressed_data && valid)
         {
@@ -251,12 +288,20 @@ public:
 
         if (compressed_data)
         {
-            strm.avail_out = buffer_size - 4;
+            strm.avail_out = static_cast<unsigned int>(buffer_size - 4);
             strm.next_out = reinterpret_cast<Bytef *>(out.data() + 4);
 
             while (strm.avail_out != 0)
             {
-                if (strm.avail_in == 0)
+                if (strm.avail_in == 0 && source != nullptr)
+                {
+                    // hand all of the remaining compressed data to inflate at once
+                    const auto available = std::min(std::size_t(header.compressed_size) - total_read, std::size_t(UINT_MAX));
+                    strm.avail_in = static_cast<unsigned int>(available);
+                    strm.next_in = const_cast<Bytef *>(source + total_read);
+                    total_read += available;
+                }
+                else if (strm.avail_in == 0)
                 {
                     // buffer empty, read some more from file
                     istream.read(in.data(),
@@ -264,11 +309,18 @@ public:
                     strm.avail_in = static_cast<unsigned int>(istream.gcount());
                     total_read += strm.avail_in;
                     strm.next_in = reinterpret_cast<Bytef *>(in.data());
+
+                    if (strm.avail_in == 0 && total_read < header.compressed_size)
+                    {
+                        throw xlnt::invalid_file("truncated data for " + header.filename);
+                    }
                 }
 
                 const auto ret = inflate(&strm, Z_NO_FLUSH); // decompress
 
-                if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR)
+                // with output space left, a buffer error means inflate needs input which the entry doesn't have
+                if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR
+                    || ret == Z_BUF_ERROR)
                 {
                     throw xlnt::invalid_file("couldn't inflate ZIP, possibly corrupted (error code " + std::to_string(ret) + ")");
                 }
@@ -282,9 +334,19 @@ public:
         }
 
         // uncompressed, so just read
-        istream.read(out.data() + 4,
-            static_cast<std::streamsize>(std::min(buffer_size - 4, header.uncompressed_size - total_read)));
-        auto count = istream.gcount();
+        const auto wanted = std::min(buffer_size - 4, header.uncompressed_size - total_read);
+        auto count = static_cast<std::streamsize>(wanted);
+
+        if (source != nullptr)
+        {
+            std::memcpy(out.data() + 4, source + total_read, wanted);
+        }
+        else
+        {
+            istream.read(out.data() + 4, static_cast<std::streamsize>(wanted));
+            count = istream.gcount();
+        }
+
         total_read += static_cast<std::size_t>(count);
         return static_cast<int>(count);
     }
@@ -311,13 +373,37 @@ int zip_streambuf_decompress::overflow(int)
     throw xlnt::exception("writing to read-only buffer");
 }
 
+/// <summary>
+/// Serves an entry which was decompressed as a whole.
+/// </summary>
+class zip_streambuf_entry : public std::streambuf
+{
+    std::vector<std::uint8_t> data;
+
+public:
+    explicit zip_streambuf_entry(std::vector<std::uint8_t> &&entry_data)
+        : data(std::move(entry_data))
+    {
+        auto begin = reinterpret_cast<char *>(data.data());
+        setg(begin, begin, begin + data.size());
+    }
+
+    virtual int overflow(int c = EOF) override;
+};
+
+int zip_streambuf_entry::overflow(int)
+{
+    throw xlnt::exception("writing to read-only buffer");
+}
+
 class zip_streambuf_compress : public std::streambuf
 {
     std::ostream &ostream; // owned when header==0 (when not part of zip file)
 
     z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::size_t buffer_size;
+    std::vector<char> in;
+    std::vector<char> out;
 
     zheader *header;
     std::uint32_t uncompressed_size;
@@ -326,8 +412,9 @@ class zip_streambuf_compress : public std::streambuf
     bool valid;
 
 public:
-    zip_streambuf_compress(zheader *central_header, std::ostream &stream)
-        : ostream(stream), header(central_header), valid(true)
+    zip_streambuf_compress(zheader *central_header, std::ostream &stream, std::size_t buffer_size_)
+        : ostream(stream), buffer_size(buffer_size_), in(buffer_size_), out(buffer_size_),
+          header(central_header), valid(true)
     {
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
@@ -392,7 +479,7 @@ protected:
 
         while (strm.avail_in != 0 || flush)
         {
-            strm.avail_out = buffer_size;
+            strm.avail_out = static_cast<unsigned int>(buffer_size);
             strm.next_out = reinterpret_cast<Bytef *>(out.data());
 
             int ret = deflate(&strm, flush ? Z_FINISH : Z_NO_FLUSH);
@@ -444,8 +531,9 @@ int zip_streambuf_compress::overflow(int c)
     return c;
 }
 
-ozstream::ozstream(std::ostream &stream)
-    : destination_stream_(stream)
+ozstream::ozstream(std::ostream &stream, std::size_t buffer_size)
+    : destination_stream_(stream),
+      buffer_size_(std::max(buffer_size, std::size_t(512)))
 {
     if (!destination_stream_)
     {
@@ -481,19 +569,30 @@ std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
     zheader header;
     header.filename = filename.string();
     file_headers_.push_back(header);
-    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_);
+    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_, buffer_size_);
 
     return std::unique_ptr<zip_streambuf_compress>(buffer);
 }
 
-izstream::izstream(std::istream &stream)
-    : source_stream_(stream)
+izstream::izstream(std::istream &stream, std::size_t buffer_size)
+    : source_stream_(stream),
+      buffer_size_(std::max(buffer_size, std::size_t(512)))
 {
     if (!stream)
     {
         throw xlnt::invalid_file("Invalid file handle");
     }
 
+    // If the whole archive is in memory, e.g. because the file was mapped,
+    // the central directory and the entries are read from there directly.
+    auto memory = dynamic_cast<memory_istreambuf *>(stream.rdbuf());
+
+    if (memory != nullptr)
+    {
+        memory_ = memory->data();
+        memory_size_ = memory->size();
+    }
+
     read_central_header();
 }
 
@@ -518,15 +617,25 @@ bool izstream::read_central_header()
         read_start = end_position;
     }
 
-    source_stream_.seekg(end_position - read_start);
-    std::vector<std::uint8_t> buf(static_cast<std::size_t>(read_start), '\0');
-
     if (read_start <= 0)
     {
         throw xlnt::invalid_file("file is empty (read_start = " + std::to_string(read_start) + ")");
     }
 
-    source_stream_.read(reinterpret_cast<char *>(buf.data()), read_start);
+    std::vector<std::uint8_t> tail;
+    const std::uint8_t *buf = nullptr;
+
+    if (memory_ != nullptr)
+    {
+        buf = memory_ + (end_position - read_start);
+    }
+    else
+    {
+        source_stream_.seekg(end_position - read_start);
+        tail.resize(static_cast<std::size_t>(read_start), '\0');
+        source_stream_.read(reinterpret_cast<char *>(tail.data()), read_start);
+        buf = tail.data();
+    }
 
     if (buf[0] == 0xd0 && buf[1] == 0xcf && buf[2] == 0x11 && buf[3] == 0xe0
         && buf[4] == 0xa1 && buf[5] == 0xb1 && buf[6] == 0x1a && buf[7] == 0xe1)
@@ -584,6 +693,13 @@ bool izstream::read_central_header()
     for (std::uint16_t i = 0; i < num_files; ++i)
     {
         auto header = read_header(source_stream_, true);
+
+        // stored entries are copied by their uncompressed size, which must not reach past their data
+        if (header.compression_type == stored && header.uncompressed_size != header.compressed_size)
+        {
+            throw xlnt::invalid_file("size mismatch for stored entry " + header.filename);
+        }
+
         file_headers_[header.filename] = header;
     }
 
@@ -598,21 +714,208 @@ std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
     }
 
     auto header = file_headers_.at(filename.string());
-    source_stream_.seekg(header.header_offset);
-    auto buffer = new zip_streambuf_decompress(source_stream_, header);
+    auto data = entry_data(header);
+
+    if (data != nullptr && !is_deflated(header))
+    {
+        // stored entries are served straight from memory
+        return std::unique_ptr<memory_istreambuf>(new memory_istreambuf(data, header.uncompressed_size));
+    }
+
+    if (header.uncompressed_size <= buffer_size_)
+    {
+        std::vector<std::uint8_t> data;
+        read(filename, data);
+
+        return std::unique_ptr<zip_streambuf_entry>(new zip_streambuf_entry(std::move(data)));
+    }
+
+    if (data == nullptr)
+    {
+        source_stream_.seekg(header.header_offset);
+    }
+
+    auto buffer = new zip_streambuf_decompress(source_stream_, data, header, buffer_size_);
 
     return std::unique_ptr<zip_streambuf_decompress>(buffer);
 }
 
+void izstream::read(const path &filename, std::vector<std::uint8_t> &destination) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::invalid_file("file not found at path: " + filename.string());
+    }
+
+    const auto &header = file_headers_.at(filename.string());
+    const auto data = entry_data(header);
+
+    if (data == nullptr)
+    {
+        source_stream_.seekg(header.header_offset);
+        read_header(source_stream_, false);
+    }
+
+    if (!is_deflated(header) && data != nullptr)
+    {
+        destination.assign(data, data + header.uncompressed_size);
+
+        return;
+    }
+
+    if (!is_deflated(header))
+    {
+        // read in pieces which double in size, so that a size the data doesn't back isn't allocated
+        destination.clear();
+
+        while (destination.size() < header.uncompressed_size)
+        {
+            const auto offset = destination.size();
+            const auto piece = std::min(std::size_t(header.uncompressed_size) - offset, std::max(offset, buffer_size_));
+
+            destination.resize(offset + piece);
+            source_stream_.read(reinterpret_cast<char *>(destination.data() + offset), static_cast<std::streamsize>(piece));
+
+            if (static_cast<std::size_t>(source_stream_.gcount()) < piece)
+            {
+                throw xlnt::invalid_file("truncated data for " + header.filename);
+            }
+        }
+
+        return;
+    }
+
+    destination.resize(initial_entry_size(header, buffer_size_));
+
+    z_stream strm;
+    strm.zalloc = nullptr;
+    strm.zfree = nullptr;
+    strm.opaque = nullptr;
+    strm.avail_in = 0;
+    strm.next_in = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    auto result = inflateInit2(&strm, -MAX_WBITS);
+#pragma clang diagnostic pop
+
+    if (result != Z_OK)
+    {
+        throw xlnt::invalid_file("couldn't inflate ZIP, possibly corrupted (error code " + std::to_string(result) + ")");
+    }
+
+    // Only the compressed input goes through a buffer, the output is written to destination directly.
+    // If the archive is in memory, not even the input is copied.
+    std::vector<char> in(data != nullptr ? 0 : std::min(buffer_size_, std::size_t(header.compressed_size) + 1));
+    std::size_t total_read = 0;
+
+    if (data != nullptr)
+    {
+        strm.avail_in = static_cast<unsigned int>(std::min(std::size_t(header.compressed_size), std::size_t(UINT_MAX)));
+        strm.next_in = const_cast<Bytef *>(data);
+        total_read = strm.avail_in;
+    }
+    std::size_t total_out = 0;
+
+    while (result != Z_STREAM_END)
+    {
+        if (strm.avail_in == 0 && data != nullptr && total_read < header.compressed_size)
+        {
+            const auto available = std::min(std::size_t(header.compressed_size) - total_read, std::size_t(UINT_MAX));
+            strm.avail_in = static_cast<unsigned int>(available);
+            strm.next_in = const_cast<Bytef *>(data + total_read);
+            total_read += available;
+        }
+        else if (strm.avail_in == 0 && data == nullptr)
+        {
+            source_stream_.read(in.data(),
+                static_cast<std::streamsize>(std::min(in.size(), header.compressed_size - total_read)));
+            strm.avail_in = static_cast<unsigned int>(source_stream_.gcount());
+            strm.next_in = reinterpret_cast<Bytef *>(in.data());
+            total_read += strm.avail_in;
+
+            if (strm.avail_in == 0 && total_read < header.compressed_size)
+            {
+                inflateEnd(&strm);
+                throw xlnt::invalid_file("truncated data for " + header.filename);
+            }
+        }
+
+        if (total_out == destination.size())
+        {
+            // one byte more than the header states is enough to tell that the entry is larger
+            const auto limit = std::size_t(header.uncompressed_size) + 1;
+
+            if (destination.size() == limit)
+            {
+                inflateEnd(&strm);
+                throw xlnt::invalid_file("size mismatch for " + header.filename);
+            }
+
+            destination.resize(std::min(destination.size() * 2 + buffer_size_, limit));
+        }
+
+        strm.next_out = destination.data() + total_out;
+        strm.avail_out = static_cast<unsigned int>(destination.size() - total_out);
+
+        result = inflate(&strm, Z_NO_FLUSH);
+        total_out = static_cast<std::size_t>(strm.next_out - destination.data());
+
+        if (result == Z_STREAM_ERROR || result == Z_NEED_DICT || result == Z_DATA_ERROR || result == Z_MEM_ERROR
+            || (result == Z_BUF_ERROR && strm.avail_in == 0 && total_read == header.compressed_size))
+        {
+            inflateEnd(&strm);
+            throw xlnt::invalid_file("couldn't inflate ZIP, possibly corrupted (error code " + std::to_string(result) + ")");
+        }
+    }
+
+    inflateEnd(&strm);
+
+    if (total_out != header.uncompressed_size)
+    {
+        throw xlnt::invalid_file("size mismatch for " + header.filename);
+    }
+
+    destination.resize(total_out);
+}
+
 std::string izstream::read(const path &filename) const
 {
-    auto buffer = open(filename);
-    std::istream stream(buffer.get());
-    auto bytes = to_vector(stream);
+    std::vector<std::uint8_t> bytes;
+    read(filename, bytes);
 
     return std::string(bytes.begin(), bytes.end());
 }
 
+const std::uint8_t *izstream::entry_data(const zheader &header) const
+{
+    if (memory_ == nullptr)
+    {
+        return nullptr;
+    }
+
+    // local header: 30 bytes, then the file name and the extra field, whose lengths are at offsets 26 and 28
+    const auto local_header_size = std::size_t(30);
+    const auto offset = std::size_t(header.header_offset);
+
+    if (offset + local_header_size > memory_size_
+        || read_int<std::uint32_t>(memory_ + offset) != 0x04034b50)
+    {
+        throw xlnt::invalid_file("missing local header for " + header.filename);
+    }
+
+    const auto start = offset + local_header_size
+        + read_int<std::uint16_t>(memory_ + offset + 26)
+        + read_int<std::uint16_t>(memory_ + offset + 28);
+
+    if (start + header.compressed_size > memory_size_)
+    {
+        throw xlnt::invalid_file("truncated data for " + header.filename);
+    }
+
+    return memory_ + start;
+}
+
 std::vector<path> izstream::files() const
 {
     std::vector<path> filenames;
@@ -51,6 +51,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 namespace xlnt {
 namespace detail {
 
+/// <summary>
+/// The default size in bytes of the buffers used to inflate and deflate archive entries.
+/// </summary>
+const std::size_t default_zip_buffer_size = 64 * 1024;
+
 /// <summary>
 /// A structure representing the header that occurs before each compressed file in a ZIP
 /// archive and again at the end of the file with more information.
@@ -80,8 +85,9 @@ class XLNT_API_INTERNAL ozstream
 public:
     /// <summary>
     /// Construct a new zip_file_writer which writes a ZIP archive to the given stream.
+    /// Each opened file is compressed through buffers of buffer_size bytes.
     /// </summary>
-    ozstream(std::ostream &stream);
+    ozstream(std::ostream &stream, std::size_t buffer_size = default_zip_buffer_size);
 
     /// <summary>
     /// Destructor.
@@ -96,6 +102,7 @@ public:
 private:
     std::vector<zheader> file_headers_;
     std::ostream &destination_stream_;
+    std::size_t buffer_size_;
 };
 
 /// <summary>
@@ -107,8 +114,10 @@ class XLNT_API_INTERNAL izstream
 public:
     /// <summary>
     /// Construct a new zip_file_reader which reads a ZIP archive from the given stream.
+    /// Opened files are decompressed through buffers of buffer_size bytes.
+    /// If stream reads from a memory_istreambuf, entries are read from its memory without copying.
     /// </summary>
-    izstream(std::istream &stream);
+    izstream(std::istream &stream, std::size_t buffer_size = default_zip_buffer_size);
 
     /// <summary>
     /// Destructor.
@@ -116,7 +125,8 @@ public:
     virtual ~izstream();
 
     /// <summary>
-    ///
+    /// Returns a streambuf which decompresses the given file while it is read.
+    /// Files which fit into the buffer are decompressed in one go instead.
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file) const;
 
@@ -125,6 +135,12 @@ public:
     /// </summary>
     std::string read(const path &file) const;
 
+    /// <summary>
+    /// Decompresses the whole file directly into destination, replacing its contents.
+    /// If the archive is in memory, this may be called from several threads at once.
+    /// </summary>
+    void read(const path &file, std::vector<std::uint8_t> &destination) const;
+
     /// <summary>
     ///
     /// </summary>
@@ -141,6 +157,12 @@ private:
     /// </summary>
     bool read_central_header();
 
+    /// <summary>
+    /// Returns the first byte of the data of the given entry if the archive is in memory,
+    /// otherwise nullptr.
+    /// </summary>
+    const std::uint8_t *entry_data(const zheader &header) const;
+
     /// <summary>
     ///
     /// </summary>
@@ -150,6 +172,21 @@ private:
     ///
     /// </summary>
     std::istream &source_stream_;
+
+    /// <summary>
+    /// The size of the buffers used to decompress opened files.
+    /// </summary>
+    std::size_t buffer_size_;
+
+    /// <summary>
+    /// The whole archive if source_stream_ reads from a memory_istreambuf, otherwise nullptr.
+    /// </summary>
+    const std::uint8_t *memory_ = nullptr;
+
+    /// <summary>
+    /// The size of memory_ in bytes.
+    /// </summary>
+    std::size_t memory_size_ = 0;
 };
 
 } // namespace detail
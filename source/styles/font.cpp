@@ -282,6 +282,7 @@ bool font::operator==(const font &other) const
     if (superscript() != other.superscript()) return false;
     if (subscript() != other.subscript()) return false;
     if (underline() != other.underline()) return false;
+    if (outline() != other.outline()) return false;
     if (shadow() != other.shadow()) return false;
 
     return true;
@@ -40,6 +40,7 @@ format::format(detail::format_impl_ptr d)
 void format::clear_style()
 {
     d_->style.clear();
+    d_->parent->format_index.update(d_.get());
 }
 
 format& format::style(const xlnt::style &new_style)
@@ -51,6 +52,7 @@ format& format::style(const xlnt::style &new_style)
 format& format::style(const std::string &new_style)
 {
     d_->style = new_style;
+    d_->parent->format_index.update(d_.get());
     return *this;
 }
 
@@ -266,6 +268,7 @@ bool format::pivot_button() const
 void format::pivot_button(bool show)
 {
     d_->pivot_button_ = show;
+    d_->parent->format_index.update(d_.get());
 }
 
 bool format::quote_prefix() const
@@ -276,6 +279,7 @@ bool format::quote_prefix() const
 void format::quote_prefix(bool quote)
 {
     d_->quote_prefix_ = quote;
+    d_->parent->format_index.update(d_.get());
 }
 
 void detail::format_impl_ptr::increment()
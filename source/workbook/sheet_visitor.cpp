@@ -0,0 +1,64 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <xlnt/workbook/sheet_visitor.hpp>
+
+namespace xlnt {
+
+sheet_visitor::~sheet_visitor()
+{
+}
+
+void sheet_visitor::on_row_begin(row_t /*row*/)
+{
+}
+
+void sheet_visitor::on_number(row_t /*row*/, column_t::index_t /*column*/, double /*value*/)
+{
+}
+
+void sheet_visitor::on_shared_string(row_t /*row*/, column_t::index_t /*column*/, std::size_t /*index*/)
+{
+}
+
+void sheet_visitor::on_inline_string(row_t /*row*/, column_t::index_t /*column*/, const std::string & /*value*/)
+{
+}
+
+void sheet_visitor::on_boolean(row_t /*row*/, column_t::index_t /*column*/, bool /*value*/)
+{
+}
+
+void sheet_visitor::on_error(row_t /*row*/, column_t::index_t /*column*/, const std::string & /*value*/)
+{
+}
+
+void sheet_visitor::on_formula(row_t /*row*/, column_t::index_t /*column*/, const std::string & /*formula*/)
+{
+}
+
+void sheet_visitor::on_row_end(row_t /*row*/)
+{
+}
+
+} // namespace xlnt
@@ -31,6 +31,8 @@
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/implementations/workbook_impl.hpp>
+#include <detail/serialization/delimited_text_writer.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
@@ -65,6 +67,22 @@ cell streaming_workbook_reader::read_cell()
     return consumer_->read_cell();
 }
 
+const std::string &streaming_workbook_reader::read_cell_raw_value() const
+{
+    return consumer_->streaming_cell_data_.value;
+}
+
+void streaming_workbook_reader::read_cells(sheet_visitor &visitor)
+{
+    consumer_->read_cells(visitor);
+}
+
+void streaming_workbook_reader::write_delimited(std::ostream &stream, const delimited_text_options &options)
+{
+    detail::delimited_text_writer writer(stream, options, *workbook_);
+    consumer_->write_delimited(writer);
+}
+
 bool streaming_workbook_reader::has_worksheet(const std::string &name)
 {
     auto titles = sheet_titles();
@@ -109,6 +127,8 @@ void streaming_workbook_reader::begin_worksheet(const std::string &title)
         throw xlnt::key_not_found(title);
     }
 
+    workbook_->load_columns(load_columns_);
+    workbook_->load_rows(load_first_row_, load_last_row_);
     consumer_->read_worksheet_begin(worksheet_rel_id_);
 }
 
@@ -117,15 +137,72 @@ worksheet streaming_workbook_reader::end_worksheet()
     return consumer_->read_worksheet_end(worksheet_rel_id_);
 }
 
+void streaming_workbook_reader::memory_mapped_loading(bool enabled)
+{
+    memory_mapped_loading_ = enabled;
+}
+
+bool streaming_workbook_reader::memory_mapped_loading() const
+{
+    return memory_mapped_loading_;
+}
+
+void streaming_workbook_reader::lazy_shared_strings(bool enabled)
+{
+    lazy_shared_strings_ = enabled;
+}
+
+bool streaming_workbook_reader::lazy_shared_strings() const
+{
+    return lazy_shared_strings_;
+}
+
+void streaming_workbook_reader::load_columns(const std::vector<column_t> &columns)
+{
+    load_columns_ = columns;
+}
+
+const std::vector<column_t> &streaming_workbook_reader::load_columns() const
+{
+    return load_columns_;
+}
+
+void streaming_workbook_reader::load_rows(row_t first, row_t last)
+{
+    if (first == 0 || first > last)
+    {
+        throw invalid_parameter("invalid rows to load: " + std::to_string(first) + " to " + std::to_string(last));
+    }
+
+    load_first_row_ = first;
+    load_last_row_ = last;
+}
+
+row_t streaming_workbook_reader::load_first_row() const
+{
+    return load_first_row_;
+}
+
+row_t streaming_workbook_reader::load_last_row() const
+{
+    return load_last_row_;
+}
+
 void streaming_workbook_reader::open(const std::vector<std::uint8_t> &data)
 {
-    stream_buffer_.reset(new detail::vector_istreambuf(data));
+    stream_buffer_.reset(new detail::memory_istreambuf(data));
     stream_.reset(new std::istream(stream_buffer_.get()));
     open(*stream_);
 }
 
 void streaming_workbook_reader::open(const std::string &filename)
 {
+    if (memory_mapped_loading_)
+    {
+        open(detail::open_mapped_file(filename));
+        return;
+    }
+
     stream_.reset(new std::ifstream());
     xlnt::detail::open_stream(static_cast<std::ifstream &>(*stream_), filename);
     open(*stream_);
@@ -142,6 +219,12 @@ void streaming_workbook_reader::open(const std::wstring &filename)
 
 void streaming_workbook_reader::open(const xlnt::path &filename)
 {
+    if (memory_mapped_loading_)
+    {
+        open(detail::open_mapped_file(filename.string()));
+        return;
+    }
+
     stream_.reset(new std::ifstream());
     xlnt::detail::open_stream(static_cast<std::ifstream &>(*stream_), filename.string());
     open(*stream_);
@@ -150,6 +233,7 @@ void streaming_workbook_reader::open(const xlnt::path &filename)
 void streaming_workbook_reader::open(std::istream &stream)
 {
     workbook_.reset(new workbook());
+    workbook_->lazy_shared_strings(lazy_shared_strings_);
     consumer_.reset(new detail::xlsx_consumer(*workbook_));
     consumer_->open(stream);
 
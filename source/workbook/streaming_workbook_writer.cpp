@@ -30,8 +30,6 @@
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
-#include <detail/implementations/cell_impl.hpp>
-#include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
@@ -44,14 +42,25 @@ streaming_workbook_writer::streaming_workbook_writer()
 
 streaming_workbook_writer::~streaming_workbook_writer()
 {
-    close();
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        // errors while finishing the file can only be handled by calling close() explicitly
+    }
 }
 
 void streaming_workbook_writer::close()
 {
     if (producer_)
     {
-        producer_.reset(nullptr);
+        // the writer is closed even if writing the remaining parts fails
+        std::unique_ptr<detail::xlsx_producer> producer(std::move(producer_));
+        producer->close();
+        producer.reset(nullptr);
+        stream_.reset(nullptr);
         stream_buffer_.reset(nullptr);
     }
 }
@@ -63,7 +72,14 @@ cell streaming_workbook_writer::add_cell(const cell_reference &ref)
 
 worksheet streaming_workbook_writer::add_worksheet(const std::string &title)
 {
-    return producer_->add_worksheet(title);
+    // the first worksheet reuses the one every new workbook starts with
+    auto ws = producer_->streamed_worksheet_count() == 0
+        ? workbook_->sheet_by_index(0)
+        : workbook_->create_sheet();
+    ws.title(title);
+    producer_->begin_worksheet(ws);
+
+    return ws;
 }
 
 void streaming_workbook_writer::open(std::vector<std::uint8_t> &data)
@@ -101,9 +117,6 @@ void streaming_workbook_writer::open(std::ostream &stream)
     workbook_.reset(new workbook());
     producer_.reset(new detail::xlsx_producer(*workbook_));
     producer_->open(stream);
-    producer_->current_worksheet_ = new detail::worksheet_impl(workbook_.get(), 1, "Sheet1");
-    producer_->current_cell_ = new detail::cell_impl();
-    producer_->current_cell_->parent_ = producer_->current_worksheet_;
 }
 
 } // namespace xlnt
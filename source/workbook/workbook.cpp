@@ -56,6 +56,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/parsers.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
@@ -686,6 +687,7 @@ const worksheet workbook::sheet_by_title(const std::string &title) const
     {
         if (impl.title_ == title)
         {
+            load_pending_worksheets(&impl);
             return worksheet(&impl);
         }
     }
@@ -699,6 +701,7 @@ worksheet workbook::sheet_by_title(const std::string &title)
     {
         if (impl.title_ == title)
         {
+            load_pending_worksheets(&impl);
             return worksheet(&impl);
         }
     }
@@ -720,6 +723,7 @@ worksheet workbook::sheet_by_index(std::size_t index)
         ++iter;
     }
 
+    load_pending_worksheets(&*iter);
     return worksheet(&*iter);
 }
 
@@ -736,6 +740,7 @@ const worksheet workbook::sheet_by_index(std::size_t index) const
     {
     }
 
+    load_pending_worksheets(&*iter);
     return worksheet(&*iter);
 }
 
@@ -758,6 +763,7 @@ worksheet workbook::sheet_by_id(std::size_t id)
     {
         if (impl.id_ == id)
         {
+            load_pending_worksheets(&impl);
             return worksheet(&impl);
         }
     }
@@ -771,6 +777,7 @@ const worksheet workbook::sheet_by_id(std::size_t id) const
     {
         if (impl.id_ == id)
         {
+            load_pending_worksheets(&impl);
             return worksheet(&impl);
         }
     }
@@ -812,6 +819,9 @@ bool workbook::has_named_range(const std::string &name) const
 
 worksheet workbook::create_sheet()
 {
+    // the relationships of the worksheets are reordered below
+    load_pending_worksheets();
+
     std::string title = "Sheet1";
     int index = 1;
 
@@ -822,9 +832,9 @@ worksheet workbook::create_sheet()
     }
     // unique sheet id
     size_t sheet_id = 1;
-    for (const auto ws : *this)
+    for (const auto &impl : d_->worksheets_)
     {
-        sheet_id = std::max(sheet_id, ws.id() + 1);
+        sheet_id = std::max(sheet_id, impl.id_ + 1);
     }
     d_->worksheets_.push_back(detail::worksheet_impl(this, sheet_id, title));
     // unique sheet file name
@@ -891,14 +901,15 @@ worksheet workbook::copy_sheet(worksheet to_copy, std::size_t index)
 
 std::size_t workbook::index(worksheet ws) const
 {
-    auto match = std::find(begin(), end(), ws);
+    auto match = std::find_if(d_->worksheets_.begin(), d_->worksheets_.end(),
+        [&ws](const detail::worksheet_impl &impl) { return &impl == ws.d_; });
 
-    if (match == end())
+    if (match == d_->worksheets_.end())
     {
         throw invalid_parameter("worksheet not found in workbook");
     }
 
-    return static_cast<std::size_t>(std::distance(begin(), match));
+    return static_cast<std::size_t>(std::distance(d_->worksheets_.begin(), match));
 }
 
 void workbook::move_sheet(worksheet worksheet, std::size_t newIndex)
@@ -994,7 +1005,7 @@ void workbook::load(const std::vector<std::uint8_t> &data)
         throw xlnt::invalid_file("file is empty or malformed (data size " + std::to_string(data.size()) + " bytes)");
     }
 
-    xlnt::detail::vector_istreambuf data_buffer(data);
+    xlnt::detail::memory_istreambuf data_buffer(data);
     std::istream data_stream(&data_buffer);
     load(data_stream);
 }
@@ -1018,6 +1029,27 @@ void workbook::load(const std::string &filename)
 
 void workbook::load(const path &filename)
 {
+    if (d_->memory_mapped_loading_)
+    {
+        // the consumer keeps the mapping while the worksheets of a lazy load haven't been read
+        auto file_buffer = detail::open_mapped_file(filename.string());
+        clear();
+        detail::xlsx_consumer consumer(*this);
+
+        try
+        {
+            consumer.read(std::move(file_buffer));
+        }
+        catch (const xlnt::invalid_password &)
+        {
+            file_buffer = detail::open_mapped_file(filename.string());
+            std::istream file_stream(file_buffer.get());
+            consumer.read(file_stream, "VelvetSweatshop");
+        }
+
+        return;
+    }
+
     std::ifstream file_stream;
 
     try
@@ -1044,6 +1076,15 @@ void workbook::load(const std::string &filename, const std::string &password)
 template <typename T>
 void workbook::load_internal(const xlnt::path &filename, const T &password)
 {
+    if (d_->memory_mapped_loading_)
+    {
+        auto file_buffer = detail::open_mapped_file(filename.string());
+        std::istream file_stream(file_buffer.get());
+        load(file_stream, password);
+
+        return;
+    }
+
     std::ifstream file_stream;
 
     try
@@ -1082,7 +1123,7 @@ void workbook::load_internal(const std::vector<std::uint8_t> &data, const T &pas
         throw xlnt::invalid_file("file is empty or malformed (data size " + std::to_string(data.size()) + " bytes)");
     }
 
-    xlnt::detail::vector_istreambuf data_buffer(data);
+    xlnt::detail::memory_istreambuf data_buffer(data);
     std::istream data_stream(&data_buffer);
     load(data_stream, password);
 }
@@ -1119,6 +1160,100 @@ void workbook::load(std::istream &stream, std::u8string_view password)
 }
 #endif
 
+void workbook::zip_buffer_size(std::size_t size)
+{
+    d_->zip_buffer_size_ = size;
+}
+
+std::size_t workbook::zip_buffer_size() const
+{
+    return d_->zip_buffer_size_;
+}
+
+void workbook::memory_mapped_loading(bool enabled)
+{
+    d_->memory_mapped_loading_ = enabled;
+}
+
+bool workbook::memory_mapped_loading() const
+{
+    return d_->memory_mapped_loading_;
+}
+
+void workbook::load_thread_count(std::size_t count)
+{
+    d_->load_thread_count_ = count;
+}
+
+std::size_t workbook::load_thread_count() const
+{
+    return d_->load_thread_count_;
+}
+
+void workbook::lazy_loading(bool enabled)
+{
+    d_->lazy_loading_ = enabled;
+}
+
+bool workbook::lazy_loading() const
+{
+    return d_->lazy_loading_;
+}
+
+void workbook::lazy_shared_strings(bool enabled)
+{
+    d_->lazy_shared_strings_ = enabled;
+}
+
+bool workbook::lazy_shared_strings() const
+{
+    return d_->lazy_shared_strings_;
+}
+
+void workbook::load_pending_worksheets(detail::worksheet_impl *worksheet) const
+{
+    if (d_->pending_worksheets_ == nullptr)
+    {
+        return;
+    }
+
+    // the worksheets belong to the same workbook_impl, so a handle to it can be changed here
+    workbook target(d_);
+    detail::xlsx_consumer consumer(target);
+    consumer.read_pending_worksheets(worksheet);
+}
+
+void workbook::load_columns(const std::vector<column_t> &columns)
+{
+    d_->load_columns_ = columns;
+}
+
+const std::vector<column_t> &workbook::load_columns() const
+{
+    return d_->load_columns_;
+}
+
+void workbook::load_rows(row_t first, row_t last)
+{
+    if (first == 0 || first > last)
+    {
+        throw invalid_parameter("invalid rows to load: " + std::to_string(first) + " to " + std::to_string(last));
+    }
+
+    d_->load_first_row_ = first;
+    d_->load_last_row_ = last;
+}
+
+row_t workbook::load_first_row() const
+{
+    return d_->load_first_row_;
+}
+
+row_t workbook::load_last_row() const
+{
+    return d_->load_last_row_;
+}
+
 void workbook::save(std::vector<std::uint8_t> &data) const
 {
     xlnt::detail::vector_ostreambuf data_buffer(data);
@@ -1197,6 +1332,14 @@ void workbook::save(const xlnt::path &filename, std::u8string_view password) con
 
 void workbook::save(std::ostream &stream) const
 {
+    load_pending_worksheets();
+    load_pending_shared_strings(0, d_->shared_strings_.size());
+
+    if (d_->calculation_engine_ != nullptr)
+    {
+        d_->calculation_engine_->calculate(*this);
+    }
+
     detail::xlsx_producer producer(*this);
     producer.write(stream);
 }
@@ -1204,6 +1347,14 @@ void workbook::save(std::ostream &stream) const
 template <typename T>
 void workbook::save_internal(std::ostream &stream, const T &password) const
 {
+    load_pending_worksheets();
+    load_pending_shared_strings(0, d_->shared_strings_.size());
+
+    if (d_->calculation_engine_ != nullptr)
+    {
+        d_->calculation_engine_->calculate(*this);
+    }
+
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
@@ -1274,6 +1425,9 @@ void workbook::load(std::u8string_view filename, std::u8string_view password)
 
 void workbook::remove_sheet(worksheet ws)
 {
+    // the relationships of the remaining worksheets are renumbered below
+    load_pending_worksheets();
+
     auto match_iter = std::find_if(d_->worksheets_.begin(), d_->worksheets_.end(),
         [=](detail::worksheet_impl &comp) { return &comp == ws.d_; });
 
@@ -1326,6 +1480,8 @@ worksheet workbook::create_sheet(std::size_t index)
 
 worksheet workbook::create_sheet_with_rel(const std::string &title, const relationship &rel)
 {
+    load_pending_worksheets();
+
     auto sheet_id = d_->worksheets_.size() + 1;
     d_->worksheets_.push_back(detail::worksheet_impl(this, sheet_id, title));
 
@@ -1376,9 +1532,9 @@ std::vector<std::string> workbook::sheet_titles() const
 {
     std::vector<std::string> names;
 
-    for (auto ws : *this)
+    for (const auto &impl : d_->worksheets_)
     {
-        names.push_back(ws.title());
+        names.push_back(impl.title_);
     }
 
     return names;
@@ -1403,6 +1559,7 @@ void workbook::clear()
 {
     *d_ = detail::workbook_impl();
     d_->stylesheet_.clear();
+    d_->pending_worksheets_.reset();
 }
 
 bool workbook::compare(const workbook &other, bool compare_by_reference) const
@@ -1413,6 +1570,11 @@ bool workbook::compare(const workbook &other, bool compare_by_reference) const
     }
     else
     {
+        load_pending_worksheets();
+        other.load_pending_worksheets();
+        load_pending_shared_strings(0, d_->shared_strings_.size());
+        other.load_pending_shared_strings(0, other.d_->shared_strings_.size());
+
         return *d_ == *other.d_;
     }
 }
@@ -1438,6 +1600,8 @@ workbook workbook::clone(clone_method method) const
     {
     case clone_method::deep_copy:
     {
+        load_pending_worksheets();
+
         workbook wb;
         *wb.d_ = *d_;
 
@@ -1616,14 +1780,15 @@ void workbook::apply_to_cells(std::function<void(cell)> f)
 {
     for (auto ws : *this)
     {
-        for (auto row = ws.lowest_row(); row <= ws.highest_row(); ++row)
+        // f may create or clear cells, so collect the references before calling it
+        std::vector<cell_reference> references;
+        ws.for_each_cell(major_order::row, [&references](const cell &c) { references.push_back(c.reference()); });
+
+        for (const auto &reference : references)
         {
-            for (auto column = ws.lowest_column(); column <= ws.highest_column(); ++column)
+            if (ws.has_cell(reference))
             {
-                if (ws.has_cell(cell_reference(column, row)))
-                {
-                    f.operator()(ws.cell(cell_reference(column, row)));
-                }
+                f(ws.cell(reference));
             }
         }
     }
@@ -1651,9 +1816,10 @@ const manifest &workbook::manifest() const
 
 const rich_text &workbook::shared_strings(std::size_t index) const
 {
-    if (index < d_->shared_strings_values_.size())
+    if (index < d_->shared_strings_.size())
     {
-        return d_->shared_strings_values_.at(index);
+        load_pending_shared_strings(index, index + 1);
+        return d_->shared_strings_.at(index);
     }
 
     static rich_text empty;
@@ -1662,12 +1828,14 @@ const rich_text &workbook::shared_strings(std::size_t index) const
 
 std::vector<rich_text> &workbook::shared_strings()
 {
-    return d_->shared_strings_values_;
+    load_pending_shared_strings(0, d_->shared_strings_.size());
+    return d_->shared_strings_.values();
 }
 
 const std::vector<rich_text> &workbook::shared_strings() const
 {
-    return d_->shared_strings_values_;
+    load_pending_shared_strings(0, d_->shared_strings_.size());
+    return d_->shared_strings_.values();
 }
 
 std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_duplicates)
@@ -1676,26 +1844,60 @@ std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_dupl
 
     if (!allow_duplicates)
     {
-        auto it = d_->shared_strings_ids_.find(shared);
+        // the strings are only hashed when they're looked up, so that loading a table doesn't hash every entry
+        load_pending_shared_strings(0, d_->shared_strings_.size());
+        const auto index = d_->shared_strings_.find(shared);
 
-        if (it != d_->shared_strings_ids_.end())
+        if (index != d_->shared_strings_.size())
         {
-            return it->second;
+            return index;
         }
     }
 
-    auto sz = d_->shared_strings_ids_.size();
-    d_->shared_strings_ids_[shared] = sz;
-    d_->shared_strings_values_.push_back(shared);
+    return d_->shared_strings_.push_back(shared);
+}
 
-    return sz;
+rich_text workbook::shared_string_value(std::size_t index) const
+{
+    if (index < d_->shared_strings_.size())
+    {
+        load_pending_shared_strings(index, index + 1);
+        return d_->shared_strings_.get(index);
+    }
+
+    return rich_text();
+}
+
+std::string workbook::shared_string_text(std::size_t index) const
+{
+    if (index < d_->shared_strings_.size())
+    {
+        load_pending_shared_strings(index, index + 1);
+        return d_->shared_strings_.plain_text(index);
+    }
+
+    return std::string();
+}
+
+void workbook::load_pending_shared_strings(std::size_t first, std::size_t last) const
+{
+    // plain text is decoded straight from the part, only rich text needs a consumer with an XML parser
+    if (d_->pending_shared_strings_ == nullptr
+        || detail::xlsx_consumer::read_pending_plain_shared_strings(*d_, first, last))
+    {
+        return;
+    }
+
+    workbook target(d_);
+    detail::xlsx_consumer consumer(target);
+    consumer.read_pending_shared_strings(first, last);
 }
 
 bool workbook::contains(const std::string &sheet_title) const
 {
-    for (auto ws : *this)
+    for (const auto &impl : d_->worksheets_)
     {
-        if (ws.title() == sheet_title) return true;
+        if (impl.title_ == sheet_title) return true;
     }
 
     return false;
@@ -2049,6 +2251,28 @@ void workbook::calculation_properties(const class calculation_properties &props)
     d_->calculation_properties_ = props;
 }
 
+void workbook::calculate()
+{
+    load_pending_worksheets();
+
+    if (d_->calculation_engine_ == nullptr)
+    {
+        d_->calculation_engine_.reset(new detail::calculation_engine());
+    }
+
+    d_->calculation_engine_->calculate(*this);
+}
+
+void workbook::calculation_thread_count(std::size_t count)
+{
+    d_->calculation_thread_count_ = count;
+}
+
+std::size_t workbook::calculation_thread_count() const
+{
+    return d_->calculation_thread_count_;
+}
+
 void workbook::garbage_collect_formulae()
 {
     auto any_with_formula = false;
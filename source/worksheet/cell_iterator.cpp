@@ -26,6 +26,61 @@
 #include <xlnt/cell/cell_reference.hpp>
 #include <xlnt/worksheet/cell_iterator.hpp>
 #include <xlnt/worksheet/major_order.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+
+namespace {
+
+// Moves cursor to the first existing cell at or after it in the given order, or one past
+// the end of bounds if there is none, without probing the empty positions in between.
+void skip_to_existing_cell(const xlnt::detail::cell_store &cells, xlnt::cell_reference &cursor,
+    const xlnt::range_reference &bounds, xlnt::major_order order)
+{
+    if (order == xlnt::major_order::row)
+    {
+        auto last_column = bounds.bottom_right().column_index();
+
+        if (cursor.column_index() > last_column)
+        {
+            return;
+        }
+
+        auto next = cells.first_in_row(cursor.row(), cursor.column_index(), last_column);
+        cursor.column_index(next == nullptr ? last_column + 1 : next->column_.index);
+    }
+    else
+    {
+        auto last_row = bounds.bottom_right().row();
+
+        if (cursor.row() > last_row)
+        {
+            return;
+        }
+
+        auto next = cells.first_in_column(cursor.column_index(), cursor.row(), last_row);
+        cursor.row(next == nullptr ? last_row + 1 : next->row_);
+    }
+}
+
+// Moves cursor to the last existing cell at or before it in the given order, or to the start
+// of bounds if there is none, without probing the empty positions in between.
+void skip_back_to_existing_cell(const xlnt::detail::cell_store &cells, xlnt::cell_reference &cursor,
+    const xlnt::range_reference &bounds, xlnt::major_order order)
+{
+    if (order == xlnt::major_order::row)
+    {
+        auto first_column = bounds.top_left().column_index();
+        auto previous = cells.last_in_row(cursor.row(), first_column, cursor.column_index());
+        cursor.column_index(previous == nullptr ? first_column : previous->column_.index);
+    }
+    else
+    {
+        auto first_row = bounds.top_left().row();
+        auto previous = cells.last_in_column(cursor.column_index(), first_row, cursor.row());
+        cursor.row(previous == nullptr ? first_row : previous->row_);
+    }
+}
+
+} // namespace
 
 namespace xlnt {
 
@@ -97,14 +152,6 @@ cell_iterator &cell_iterator::operator--()
         {
             cursor_.column_index(cursor_.column_index() - 1);
         }
-
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.column() > bounds_.top_left().column())
-            {
-                cursor_.column_index(cursor_.column_index() - 1);
-            }
-        }
     }
     else
     {
@@ -112,14 +159,11 @@ cell_iterator &cell_iterator::operator--()
         {
             cursor_.row(cursor_.row() - 1);
         }
+    }
 
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.row() > bounds_.top_left().row())
-            {
-                cursor_.row(cursor_.row() - 1);
-            }
-        }
+    if (skip_null_)
+    {
+        skip_back_to_existing_cell(ws_.d_->cell_map_, cursor_, bounds_, order_);
     }
 
     return *this;
@@ -133,14 +177,6 @@ const_cell_iterator &const_cell_iterator::operator--()
         {
             cursor_.column_index(cursor_.column_index() - 1);
         }
-
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.column() > bounds_.top_left().column())
-            {
-                cursor_.column_index(cursor_.column_index() - 1);
-            }
-        }
     }
     else
     {
@@ -148,14 +184,11 @@ const_cell_iterator &const_cell_iterator::operator--()
         {
             cursor_.row(cursor_.row() - 1);
         }
+    }
 
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.row() > bounds_.top_left().row())
-            {
-                cursor_.row(cursor_.row() - 1);
-            }
-        }
+    if (skip_null_)
+    {
+        skip_back_to_existing_cell(ws_.d_->cell_map_, cursor_, bounds_, order_);
     }
 
     return *this;
@@ -185,14 +218,6 @@ cell_iterator &cell_iterator::operator++()
         {
             cursor_.column_index(cursor_.column_index() + 1);
         }
-
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.column() <= bounds_.bottom_right().column())
-            {
-                cursor_.column_index(cursor_.column_index() + 1);
-            }
-        }
     }
     else
     {
@@ -200,14 +225,11 @@ cell_iterator &cell_iterator::operator++()
         {
             cursor_.row(cursor_.row() + 1);
         }
+    }
 
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.row() <= bounds_.bottom_right().row())
-            {
-                cursor_.row(cursor_.row() + 1);
-            }
-        }
+    if (skip_null_)
+    {
+        skip_to_existing_cell(ws_.d_->cell_map_, cursor_, bounds_, order_);
     }
 
     return *this;
@@ -221,14 +243,6 @@ const_cell_iterator &const_cell_iterator::operator++()
         {
             cursor_.column_index(cursor_.column_index() + 1);
         }
-
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.column() <= bounds_.bottom_right().column())
-            {
-                cursor_.column_index(cursor_.column_index() + 1);
-            }
-        }
     }
     else
     {
@@ -236,14 +250,11 @@ const_cell_iterator &const_cell_iterator::operator++()
         {
             cursor_.row(cursor_.row() + 1);
         }
+    }
 
-        if (skip_null_)
-        {
-            while (!ws_.has_cell(cursor_) && cursor_.row() <= bounds_.bottom_right().row())
-            {
-                cursor_.row(cursor_.row() + 1);
-            }
-        }
+    if (skip_null_)
+    {
+        skip_to_existing_cell(ws_.d_->cell_map_, cursor_, bounds_, order_);
     }
 
     return *this;
@@ -50,6 +50,7 @@
 #include <detail/implementations/cell_impl.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
+#include <detail/serialization/delimited_text_writer.hpp>
 #include <detail/unicode.hpp>
 
 namespace {
@@ -59,6 +60,40 @@ int points_to_pixels(double points, double dpi)
     return static_cast<int>(std::ceil(points * dpi / 72));
 }
 
+template <typename Visitor>
+void visit_cells(const xlnt::detail::cell_store &cells, xlnt::major_order order, Visitor visit,
+    const std::function<void(std::uint32_t)> &line_start, const std::function<void(std::uint32_t)> &line_end)
+{
+    if (order == xlnt::major_order::row)
+    {
+        cells.for_each_row([&](xlnt::row_t row, const xlnt::detail::cell_store::row_entries &entries) {
+            if (line_start) line_start(row);
+
+            for (const auto &entry : entries)
+            {
+                visit(entry.second);
+            }
+
+            if (line_end) line_end(row);
+        });
+
+        return;
+    }
+
+    const auto &sorted = cells.column_order();
+
+    for (auto current = sorted.begin(); current != sorted.end(); ++current)
+    {
+        auto column = (*current)->column_.index;
+        auto is_first = current == sorted.begin() || (*(current - 1))->column_.index != column;
+        auto is_last = current + 1 == sorted.end() || (*(current + 1))->column_.index != column;
+
+        if (is_first && line_start) line_start(column);
+        visit(*current);
+        if (is_last && line_end) line_end(column);
+    }
+}
+
 } // namespace
 
 namespace xlnt {
@@ -218,19 +253,10 @@ const workbook worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
-    auto cell_iter = d_->cell_map_.begin();
-
-    while (cell_iter != d_->cell_map_.end())
-    {
-        if (xlnt::cell(&cell_iter->second).garbage_collectible())
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else
-        {
-            ++cell_iter;
-        }
-    }
+    const auto &cells = d_->cell_map_;
+    d_->cell_map_.erase_if([&cells](const detail::cell_impl &impl) {
+        return cells.is_garbage_collectible(impl);
+    });
 }
 
 void worksheet::id(std::size_t id)
@@ -408,27 +434,22 @@ cell_reference worksheet::active_cell() const
 
 cell worksheet::cell(const cell_reference &reference)
 {
-    auto match = d_->cell_map_.find(reference);
-    if (match == d_->cell_map_.end())
+    auto match = d_->cell_map_.emplace(reference);
+    if (match.second)
     {
-        auto impl = detail::cell_impl();
-        impl.parent_ = d_;
-        impl.column_ = reference.column_index();
-        impl.row_ = reference.row();
-
-        match = d_->cell_map_.emplace(reference, impl).first;
+        match.first->parent_ = d_;
     }
-    return xlnt::cell(&match->second);
+    return xlnt::cell(match.first);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
     const auto match = d_->cell_map_.find(reference);
-    if (match == d_->cell_map_.end())
+    if (match == nullptr)
     {
         throw xlnt::invalid_parameter("Requested cell " + reference.to_string() + " doesn't exist.");
     }
-    return xlnt::cell(&match->second);
+    return xlnt::cell(const_cast<detail::cell_impl *>(match));
 }
 
 cell worksheet::cell(xlnt::column_t column, row_t row)
@@ -443,8 +464,7 @@ const cell worksheet::cell(xlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto cell = d_->cell_map_.find(reference);
-    return cell != d_->cell_map_.cend();
+    return d_->cell_map_.contains(reference);
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -483,14 +503,7 @@ column_t worksheet::lowest_column() const
         return constants::min_column();
     }
 
-    auto lowest = constants::max_column();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.column());
-    }
-
-    return lowest;
+    return d_->cell_map_.bounds().first_column;
 }
 
 column_t worksheet::lowest_column_or_props() const
@@ -517,14 +530,7 @@ row_t worksheet::lowest_row() const
         return constants::min_row();
     }
 
-    auto lowest = constants::max_row();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.row());
-    }
-
-    return lowest;
+    return d_->cell_map_.bounds().first_row;
 }
 
 row_t worksheet::lowest_row_or_props() const
@@ -546,14 +552,12 @@ row_t worksheet::lowest_row_or_props() const
 
 row_t worksheet::highest_row() const
 {
-    auto highest = constants::min_row();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, cell.first.row());
+        return constants::min_row();
     }
 
-    return highest;
+    return d_->cell_map_.bounds().last_row;
 }
 
 row_t worksheet::highest_row_or_props() const
@@ -575,14 +579,12 @@ row_t worksheet::highest_row_or_props() const
 
 column_t worksheet::highest_column() const
 {
-    auto highest = constants::min_column();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, cell.first.column());
+        return constants::min_column();
     }
 
-    return highest;
+    return d_->cell_map_.bounds().last_column;
 }
 
 column_t worksheet::highest_column_or_props() const
@@ -633,20 +635,12 @@ range_reference worksheet::calculate_dimension(bool skip_null, bool skip_row_pro
         return range_reference(constants::min_column(), min_row_prop,
             constants::min_column(), max_row_prop);
     }
-    // find min and max row/column in cell map
-    column_t min_col = skip_null? constants::max_column() : constants::min_column();
-    column_t max_col = constants::min_column();
-    row_t min_row = min_row_prop;
-    row_t max_row = max_row_prop;
-    for (auto &c : d_->cell_map_)
-    {
-        if(skip_null){
-            min_col = std::min(min_col, c.second.column_);
-            min_row = std::min(min_row, c.second.row_);
-        }
-        max_col = std::max(max_col, c.second.column_);
-        max_row = std::max(max_row, c.second.row_);
-    }
+    // the cell store keeps track of the bounds of its cells
+    const auto &bounds = d_->cell_map_.bounds();
+    column_t min_col = skip_null ? column_t(bounds.first_column) : constants::min_column();
+    column_t max_col = bounds.last_column;
+    row_t min_row = skip_null ? std::min(min_row_prop, bounds.first_row) : min_row_prop;
+    row_t max_row = std::max(max_row_prop, bounds.last_row);
     return range_reference(min_col, min_row, max_col, max_row);
 }
 
@@ -770,6 +764,63 @@ const xlnt::range worksheet::columns(bool skip_null) const
     return xlnt::range(*this, calculate_dimension(skip_null, skip_null), major_order::column, skip_null);
 }
 
+void worksheet::for_each_cell(major_order order, std::function<void(class cell)> f,
+    std::function<void(std::uint32_t)> line_start, std::function<void(std::uint32_t)> line_end)
+{
+    visit_cells(d_->cell_map_, order, [&f](detail::cell_impl *impl) { f(xlnt::cell(impl)); },
+        line_start, line_end);
+}
+
+void worksheet::for_each_cell(major_order order, std::function<void(const class cell &)> f,
+    std::function<void(std::uint32_t)> line_start, std::function<void(std::uint32_t)> line_end) const
+{
+    visit_cells(d_->cell_map_, order, [&f](detail::cell_impl *impl) { f(xlnt::cell(impl)); },
+        line_start, line_end);
+}
+
+void worksheet::write_delimited(std::ostream &stream, const delimited_text_options &options) const
+{
+    const auto &cells = d_->cell_map_;
+    detail::delimited_text_writer writer(stream, options, workbook());
+
+    cells.for_each_row([&](row_t row, const detail::cell_store::row_entries &entries) {
+        writer.on_row_begin(row);
+
+        for (const auto &entry : entries)
+        {
+            const auto &cell = *entry.second;
+            const auto column = cell.column_.index;
+
+            writer.next_format(cell.format_.is_set(), cell.format_.is_set() ? cell.format_.get()->id : 0);
+
+            switch (cell.type_)
+            {
+            case cell::type::empty:
+                break;
+            case cell::type::boolean:
+                writer.on_boolean(row, column, cell.value_numeric_ != 0.0);
+                break;
+            case cell::type::date:
+            case cell::type::number:
+                writer.on_number(row, column, cell.value_numeric_);
+                break;
+            case cell::type::shared_string:
+                writer.on_shared_string(row, column, static_cast<std::size_t>(cell.value_numeric_));
+                break;
+            case cell::type::inline_string:
+            case cell::type::formula_string:
+                writer.on_inline_string(row, column, xlnt::cell(entry.second).value<std::string>());
+                break;
+            case cell::type::error:
+                writer.on_error(row, column, xlnt::cell(entry.second).value<std::string>());
+                break;
+            }
+        }
+
+        writer.on_row_end(row);
+    });
+}
+
 /*
 //TODO: finish implementing cell_iterator wrapping before uncommenting
 
@@ -788,23 +839,32 @@ const cell_vector worksheet::cells(bool skip_null) const
 
 void worksheet::clear_cell(const cell_reference &ref)
 {
-    d_->cell_map_.erase(ref);
-    // TODO: garbage collect newly unreferenced resources such as styles?
-}
+    auto cleared = d_->cell_map_.find(ref);
 
-void worksheet::clear_row(row_t row)
-{
-    for (auto it = d_->cell_map_.begin(); it != d_->cell_map_.end();)
+    if (cleared != nullptr && d_->calculation_engine_ != nullptr)
     {
-        if (it->first.row() == row)
+        if (d_->cell_map_.find_formula(*cleared) != nullptr)
         {
-            it = d_->cell_map_.erase(it);
+            d_->calculation_engine_->formula_changed(*d_, ref.column_index(), ref.row());
         }
         else
         {
-            ++it;
+            d_->calculation_engine_->value_changed(*d_, ref.column_index(), ref.row());
         }
     }
+
+    d_->cell_map_.erase(ref);
+    // TODO: garbage collect newly unreferenced resources such as styles?
+}
+
+void worksheet::clear_row(row_t row)
+{
+    if (d_->calculation_engine_ != nullptr)
+    {
+        d_->calculation_engine_->invalidate();
+    }
+
+    d_->cell_map_.erase_row(row);
     d_->row_properties_.erase(row);
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
@@ -841,19 +901,22 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
         throw xlnt::invalid_parameter("Cannot move cells as they would be outside the maximum bounds of the spreadsheet");
     }
 
+    if (d_->calculation_engine_ != nullptr)
+    {
+        d_->calculation_engine_->invalidate();
+    }
+
     std::vector<detail::cell_impl> cells_to_move;
 
-    auto cell_iter = d_->cell_map_.cbegin();
-    while (cell_iter != d_->cell_map_.cend())
-    {
+    d_->cell_map_.erase_if([&](detail::cell_impl &cell) {
         std::uint32_t current_index;
         switch (row_or_col)
         {
         case row_or_col_t::row:
-            current_index = cell_iter->first.row();
+            current_index = cell.row_;
             break;
         case row_or_col_t::column:
-            current_index = cell_iter->first.column().index;
+            current_index = cell.column_.index;
             break;
         default:
             throw xlnt::unhandled_switch_case(static_cast<long long>(row_or_col));
@@ -861,7 +924,6 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
 
         if (current_index >= min_index) // extract cells to be moved
         {
-            auto cell = cell_iter->second;
             if (row_or_col == row_or_col_t::row)
             {
                 cell.row_ = reverse ? cell.row_ - amount : cell.row_ + amount;
@@ -871,22 +933,17 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
                 cell.column_ = reverse ? cell.column_.index - amount : cell.column_.index + amount;
             }
 
-            cells_to_move.push_back(cell);
-            cell_iter = d_->cell_map_.erase(cell_iter);
+            cells_to_move.push_back(std::move(cell));
+            return true;
         }
-        else if (reverse && current_index >= min_index - amount) // delete destination cells
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else // skip other cells
-        {
-            ++cell_iter;
-        }
-    }
+
+        // delete destination cells, skip other cells
+        return reverse && current_index >= min_index - amount;
+    });
 
     for (auto &cell : cells_to_move)
     {
-        d_->cell_map_[cell_reference(cell.column_, cell.row_)] = cell;
+        d_->cell_map_.insert_or_assign(std::move(cell));
     }
 
     if (row_or_col == row_or_col_t::row)
@@ -0,0 +1,459 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <thread>
+#include <vector>
+
+#include <helpers/test_suite.hpp>
+#include <xlnt/xlnt.hpp>
+
+#include <detail/implementations/cell_store.hpp>
+
+class cell_store_test_suite : public test_suite
+{
+public:
+    cell_store_test_suite()
+    {
+        register_test(test_emplace_find);
+        register_test(test_pointer_stability);
+        register_test(test_row_major_order);
+        register_test(test_erase);
+        register_test(test_erase_row);
+        register_test(test_erase_if);
+        register_test(test_insert_or_assign);
+        register_test(test_copy);
+        register_test(test_extensions);
+        register_test(test_extension_follows_moved_cell);
+        register_test(test_shared_string_references);
+        register_test(test_bounds);
+        register_test(test_column_order);
+    }
+
+    void test_emplace_find()
+    {
+        xlnt::detail::cell_store store;
+        xlnt_assert(store.empty());
+        xlnt_assert_equals(store.find("A1"), nullptr);
+
+        auto result = store.emplace("C7");
+        xlnt_assert(result.second);
+        xlnt_assert_equals(result.first->column_.index, 3);
+        xlnt_assert_equals(result.first->row_, 7);
+        xlnt_assert_equals(store.find("C7"), result.first);
+        xlnt_assert_equals(store.find(3, 7), result.first);
+        xlnt_assert(store.contains("C7"));
+        xlnt_assert(!store.contains("C8"));
+        xlnt_assert(!store.contains("B7"));
+
+        auto again = store.emplace("C7");
+        xlnt_assert(!again.second);
+        xlnt_assert_equals(again.first, result.first);
+        xlnt_assert_equals(store.size(), 1);
+    }
+
+    void test_pointer_stability()
+    {
+        xlnt::detail::cell_store store;
+        std::vector<xlnt::detail::cell_impl *> pointers;
+
+        // insert in an order which forces rows and blocks to be inserted in the middle
+        for (xlnt::row_t row = 500; row >= 1; --row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 20; column += 3)
+            {
+                pointers.push_back(store.emplace(xlnt::cell_reference(column, row)).first);
+                pointers.back()->value_numeric_ = row * 100.0 + column;
+            }
+        }
+
+        std::size_t i = 0;
+        for (xlnt::row_t row = 500; row >= 1; --row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 20; column += 3)
+            {
+                auto cell = store.find(xlnt::cell_reference(column, row));
+                xlnt_assert_equals(cell, pointers[i++]);
+                xlnt_assert_equals(cell->value_numeric_, row * 100.0 + column);
+            }
+        }
+    }
+
+    void test_row_major_order()
+    {
+        xlnt::detail::cell_store store;
+        store.emplace("B200");
+        store.emplace("A1");
+        store.emplace("ZZ3");
+        store.emplace("B3");
+        store.emplace("A200");
+        store.emplace("C70");
+
+        std::vector<std::string> references;
+        for (const auto &cell : store)
+        {
+            references.push_back(xlnt::cell_reference(cell.column_, cell.row_).to_string());
+        }
+
+        const std::vector<std::string> expected = {"A1", "B3", "ZZ3", "C70", "A200", "B200"};
+        xlnt_assert(references == expected);
+
+        std::vector<xlnt::row_t> rows;
+        store.for_each_row([&](xlnt::row_t row, const xlnt::detail::cell_store::row_entries &entries) {
+            rows.push_back(row);
+            xlnt_assert(!entries.empty());
+        });
+        xlnt_assert(rows == std::vector<xlnt::row_t>({1, 3, 70, 200}));
+        xlnt_assert_equals(store.row(3)->size(), 2);
+        xlnt_assert_equals(store.row(4), nullptr);
+    }
+
+    void test_erase()
+    {
+        xlnt::detail::cell_store store;
+        store.emplace("A1");
+        auto kept = store.emplace("B1").first;
+        store.emplace("A100");
+
+        xlnt_assert(store.erase("A1"));
+        xlnt_assert(!store.erase("A1"));
+        xlnt_assert(store.erase("A100"));
+        xlnt_assert_equals(store.size(), 1);
+        xlnt_assert_equals(store.find("B1"), kept);
+        xlnt_assert_equals(store.row(100), nullptr);
+
+        // freed storage is reused
+        store.emplace("D4");
+        xlnt_assert_equals(store.size(), 2);
+        xlnt_assert_equals(store.find("B1"), kept);
+    }
+
+    void test_erase_row()
+    {
+        xlnt::detail::cell_store store;
+        store.emplace("A1");
+        store.emplace("A2");
+        store.emplace("B2");
+        store.emplace("C2");
+
+        xlnt_assert_equals(store.erase_row(2), 3);
+        xlnt_assert_equals(store.erase_row(2), 0);
+        xlnt_assert_equals(store.size(), 1);
+        xlnt_assert(store.contains("A1"));
+    }
+
+    void test_erase_if()
+    {
+        xlnt::detail::cell_store store;
+        for (xlnt::row_t row = 1; row <= 200; ++row)
+        {
+            store.emplace(xlnt::cell_reference(1, row)).first->value_numeric_ = row;
+        }
+
+        auto removed = store.erase_if([](const xlnt::detail::cell_impl &cell) {
+            return cell.row_ % 2 == 0;
+        });
+
+        xlnt_assert_equals(removed, 100);
+        xlnt_assert_equals(store.size(), 100);
+        for (const auto &cell : store)
+        {
+            xlnt_assert_equals(cell.row_ % 2, 1);
+            xlnt_assert_equals(cell.value_numeric_, cell.row_);
+        }
+    }
+
+    void test_insert_or_assign()
+    {
+        xlnt::detail::cell_store store;
+        auto original = store.emplace("B2").first;
+
+        xlnt::detail::cell_impl replacement;
+        replacement.column_ = 2;
+        replacement.row_ = 2;
+        replacement.value_numeric_ = 42;
+        xlnt_assert_equals(store.insert_or_assign(std::move(replacement)), original);
+        xlnt_assert_equals(original->value_numeric_, 42);
+
+        xlnt::detail::cell_impl ignored;
+        ignored.column_ = 2;
+        ignored.row_ = 2;
+        xlnt_assert(!store.emplace(std::move(ignored)).second);
+        xlnt_assert_equals(original->value_numeric_, 42);
+        xlnt_assert_equals(store.size(), 1);
+    }
+
+    void test_copy()
+    {
+        xlnt::detail::cell_store store;
+        store.emplace("A1").first->value_numeric_ = 1;
+        store.emplace("B300").first->value_numeric_ = 2;
+
+        xlnt::detail::cell_store copy(store);
+        xlnt_assert(copy == store);
+        xlnt_assert_differs(copy.find("A1"), store.find("A1"));
+
+        copy.find("B300")->value_numeric_ = 3;
+        xlnt_assert(copy != store);
+
+        xlnt::detail::cell_store moved(std::move(copy));
+        xlnt_assert(copy.empty());
+        xlnt_assert_equals(moved.size(), 2);
+        xlnt_assert_equals(moved.find("B300")->value_numeric_, 3);
+    }
+
+    void test_extensions()
+    {
+        xlnt::detail::cell_store store;
+        auto plain = store.emplace("A1").first;
+        auto formula = store.emplace("B1").first;
+
+        xlnt_assert_equals(store.find_extension(*plain), nullptr);
+        xlnt_assert_equals(store.find_formula(*plain), nullptr);
+        xlnt_assert(store.is_garbage_collectible(*plain));
+
+        store.formula(*formula) = "SUM(A1:A2)";
+        xlnt_assert_equals(store.extension_count(), 1);
+        xlnt_assert_equals(store.formula_count(), 1);
+        xlnt_assert(!store.is_garbage_collectible(*formula));
+        xlnt_assert_equals(*store.find_formula(*formula), "SUM(A1:A2)");
+
+        // the other attributes of the cell stay unset
+        xlnt_assert_equals(store.find_text(*formula), nullptr);
+        xlnt_assert_equals(store.find_hyperlink(*formula), nullptr);
+
+        xlnt::detail::cell_store copy(store);
+        xlnt_assert(copy == store);
+        xlnt_assert_equals(*copy.find_formula(*copy.find("B1")), "SUM(A1:A2)");
+        copy.formula(*copy.find("B1")) = "A1";
+        xlnt_assert(copy != store);
+
+        // an empty text is equal to none
+        copy = store;
+        copy.text(*copy.find("B1"));
+        xlnt_assert(copy == store);
+
+        // an emptied extension is released
+        store.clear_formula(*formula);
+        xlnt_assert_equals(store.find_extension(*formula), nullptr);
+        xlnt_assert_equals(store.extension_count(), 0);
+        xlnt_assert_equals(store.formula_count(), 0);
+
+        store.extension(*formula).is_merged_ = true;
+        store.text(*formula).plain_text("text", false);
+        xlnt_assert_equals(store.extension_count(), 1);
+        store.erase("B1");
+        xlnt_assert_equals(store.extension_count(), 0);
+
+        // released slots are reused
+        auto linked = store.emplace("C1").first;
+        store.hyperlink(*linked).tooltip = std::string("tip");
+        store.clear_hyperlink(*linked);
+        xlnt_assert_equals(store.find_extension(*linked), nullptr);
+        store.hyperlink(*linked).tooltip = std::string("other");
+        xlnt_assert_equals(store.find_hyperlink(*linked)->tooltip.get(), "other");
+    }
+
+    void test_extension_follows_moved_cell()
+    {
+        xlnt::detail::cell_store store;
+        auto cell = store.emplace("A1").first;
+        store.formula(*cell) = "1+1";
+
+        std::vector<xlnt::detail::cell_impl> moved;
+        store.erase_if([&moved](xlnt::detail::cell_impl &c) {
+            c.row_ = 5;
+            moved.push_back(std::move(c));
+            return true;
+        });
+
+        xlnt_assert(store.empty());
+        xlnt_assert_equals(store.extension_count(), 1);
+
+        auto reinserted = store.insert_or_assign(std::move(moved.front()));
+        xlnt_assert_equals(store.find("A5"), reinserted);
+        xlnt_assert_equals(*store.find_formula(*reinserted), "1+1");
+        xlnt_assert_equals(moved.front().extension_, 0);
+    }
+
+    void test_shared_string_references()
+    {
+        xlnt::detail::cell_impl text;
+        text.type_ = xlnt::cell_type::shared_string;
+        text.value_numeric_ = 2;
+
+        xlnt::detail::cell_store store;
+        text.row_ = 1;
+        store.emplace(xlnt::detail::cell_impl(text));
+        text.row_ = 2;
+        store.emplace(xlnt::detail::cell_impl(text));
+        store.emplace("A3");
+
+        xlnt_assert_equals(store.shared_string_count(), 2);
+        xlnt_assert_equals(store.shared_string_references(2), 2);
+        xlnt_assert_equals(store.shared_string_references(0), 0);
+        xlnt_assert_equals(store.shared_string_references(10), 0);
+
+        // changing the value of a stored cell
+        auto cell = store.find("A2");
+        store.release_shared_string(*cell);
+        cell->value_numeric_ = 0;
+        store.reference_shared_string(*cell);
+        xlnt_assert_equals(store.shared_string_references(2), 1);
+        xlnt_assert_equals(store.shared_string_references(0), 1);
+
+        xlnt::detail::cell_store copy(store);
+        xlnt_assert_equals(copy.shared_string_count(), 2);
+
+        store.erase("A1");
+        xlnt_assert_equals(store.shared_string_count(), 1);
+        xlnt_assert_equals(store.shared_string_references(2), 0);
+
+        xlnt::detail::cell_impl number;
+        number.row_ = 2;
+        number.type_ = xlnt::cell_type::number;
+        store.insert_or_assign(std::move(number));
+        xlnt_assert_equals(store.shared_string_count(), 0);
+        xlnt_assert_equals(copy.shared_string_count(), 2);
+
+        copy.clear();
+        xlnt_assert_equals(copy.shared_string_count(), 0);
+    }
+
+    void test_bounds()
+    {
+        xlnt::detail::cell_store store;
+        store.emplace("C5");
+        store.emplace("B7");
+        store.emplace("E200");
+        store.emplace("D6");
+
+        auto bounds = store.bounds();
+        xlnt_assert_equals(bounds.first_column, 2);
+        xlnt_assert_equals(bounds.last_column, 5);
+        xlnt_assert_equals(bounds.first_row, 5);
+        xlnt_assert_equals(bounds.last_row, 200);
+
+        // an inner cell doesn't change the bounds
+        store.erase("D6");
+        xlnt_assert_equals(store.bounds().last_row, 200);
+
+        store.erase("E200");
+        xlnt_assert_equals(store.bounds().last_column, 3);
+        xlnt_assert_equals(store.bounds().last_row, 7);
+
+        store.erase_row(5);
+        xlnt_assert_equals(store.bounds().first_column, 2);
+        xlnt_assert_equals(store.bounds().first_row, 7);
+
+        store.erase_if([](const xlnt::detail::cell_impl &) { return true; });
+        store.emplace("Z1000");
+        xlnt_assert_equals(store.bounds().first_column, 26);
+        xlnt_assert_equals(store.bounds().first_row, 1000);
+
+        xlnt::detail::cell_store copy(store);
+        copy.emplace("A1");
+        xlnt_assert_equals(copy.bounds().first_row, 1);
+        xlnt_assert_equals(store.bounds().first_row, 1000);
+
+        // several threads may ask for the bounds while they have to be recomputed
+        for (xlnt::row_t row = 1; row < 1000; ++row)
+        {
+            store.emplace(xlnt::cell_reference(row % 20 + 1, row));
+        }
+
+        store.erase("Z1000");
+        std::vector<xlnt::column_t::index_t> last_columns(4);
+        std::vector<std::thread> readers;
+
+        for (std::size_t i = 0; i < last_columns.size(); ++i)
+        {
+            readers.emplace_back([&store, &last_columns, i]() { last_columns[i] = store.bounds().last_column; });
+        }
+
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+
+        for (auto last_column : last_columns)
+        {
+            xlnt_assert_equals(last_column, 20);
+        }
+    }
+
+    void test_column_order()
+    {
+        xlnt::detail::cell_store store;
+        store.emplace("B9");
+        store.emplace("C2");
+        store.emplace("B3");
+        store.emplace("A500");
+
+        std::vector<std::string> order;
+        for (auto cell : store.column_order())
+        {
+            order.push_back(xlnt::cell_reference(cell->column_, cell->row_).to_string());
+        }
+        xlnt_assert_equals(order, std::vector<std::string>({"A500", "B3", "B9", "C2"}));
+
+        xlnt_assert_equals(store.first_in_column(2, 1, 1000), store.find("B3"));
+        xlnt_assert_equals(store.first_in_column(2, 4, 1000), store.find("B9"));
+        xlnt_assert_equals(store.first_in_column(2, 4, 8), nullptr);
+        xlnt_assert_equals(store.first_in_column(4, 1, 1000), nullptr);
+
+        xlnt_assert_equals(store.last_in_column(2, 1, 1000), store.find("B9"));
+        xlnt_assert_equals(store.last_in_column(2, 1, 8), store.find("B3"));
+        xlnt_assert_equals(store.last_in_column(2, 4, 8), nullptr);
+        xlnt_assert_equals(store.last_in_column(1, 1, 499), nullptr);
+
+        xlnt_assert_equals(store.last_in_row(9, 1, 10), store.find("B9"));
+        xlnt_assert_equals(store.last_in_row(9, 3, 10), nullptr);
+        xlnt_assert_equals(store.last_in_row(4, 1, 10), nullptr);
+
+        // cells added or removed one by one are inserted into the sorted order or removed from it
+        const auto &sorted = store.column_order();
+        store.emplace("B5");
+        store.emplace("D1");
+        xlnt_assert_equals(store.first_in_column(2, 4, 8), store.find("B5"));
+        xlnt_assert_equals(sorted.size(), 6);
+        xlnt_assert_equals(sorted.back(), store.find("D1"));
+
+        store.erase("B3");
+        xlnt_assert_equals(store.first_in_column(2, 1, 1000), store.find("B5"));
+        xlnt_assert_equals(sorted.size(), 5);
+        store.erase("D1");
+
+        store.erase_row(5);
+        store.erase_if([](const xlnt::detail::cell_impl &cell) { return cell.row_ == 9; });
+        xlnt_assert_equals(store.first_in_column(2, 1, 1000), nullptr);
+        xlnt_assert_equals(store.column_order().size(), 2);
+
+        xlnt::detail::cell_store moved(std::move(store));
+        xlnt_assert_equals(moved.first_in_column(1, 1, 1000), moved.find("A500"));
+        xlnt_assert(store.column_order().empty());
+
+        moved.clear();
+        xlnt_assert(moved.column_order().empty());
+    }
+};
+static cell_store_test_suite x;
@@ -23,6 +23,7 @@
 
 #include <detail/implementations/format_impl.hpp>
 #include <detail/implementations/stylesheet.hpp>
+#include <detail/number_format/number_formatter.hpp>
 #include <helpers/test_suite.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/internal/format_impl_ptr.hpp>
@@ -31,6 +32,9 @@
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 
+#include <iterator>
+#include <vector>
+
 
 class format_impl_test_suite : public test_suite
 {
@@ -40,6 +44,10 @@ class format_impl_test_suite : public test_suite
         register_test(test_format_impl_ptr);
         register_test(test_inplace_editing_non_shared_format);
         register_test(test_reference);
+        register_test(test_format_index);
+        register_test(test_format_by_index);
+        register_test(test_compiled_number_formats);
+        register_test(test_format_number_into_buffer);
     }
 
     void test_format_impl_ptr()
@@ -118,5 +126,130 @@ class format_impl_test_suite : public test_suite
         ref5 = std::move(ref4);
         xlnt_assert_equals(ref5, 0); // idem for move operator
     }
+
+    void test_format_index()
+    {
+        xlnt::detail::stylesheet s;
+        std::vector<xlnt::format> formats;
+
+        for (int size = 1; size <= 200; ++size)
+        {
+            formats.push_back(s.create_format(false).font(xlnt::font().size(size)));
+        }
+        xlnt_assert_equals(s.format_impls.size(), 200);
+        xlnt_assert_equals(s.fonts.size(), 200);
+
+        // equal formats are reused, the edited copies are garbage collected
+        std::vector<xlnt::format> duplicates;
+        for (int size = 1; size <= 200; ++size)
+        {
+            duplicates.push_back(s.create_format(false).font(xlnt::font().size(size)));
+        }
+        xlnt_assert_equals(s.format_impls.size(), 200);
+        xlnt_assert_equals(s.fonts.size(), 200);
+
+        std::size_t position = 0;
+        for (auto &item : s.format_impls)
+        {
+            xlnt_assert_equals((*item).id, position++);
+        }
+
+        // formats changed in place are found by their new properties
+        duplicates.clear();
+        formats[10].quote_prefix(true);
+        {
+            auto quoted = s.create_format(false);
+            quoted.quote_prefix(true);
+            quoted.font(xlnt::font().size(11));
+            xlnt_assert_equals(s.format_impls.size(), 200);
+        }
+
+        // a copy finds its own formats
+        xlnt::detail::stylesheet copy = s;
+        copy.garbage_collection_enabled = false;
+        auto &pattern = **std::next(s.format_impls.begin(), 20);
+        auto found = copy.find_or_create(pattern);
+        xlnt_assert(found.get() == &**std::next(copy.format_impls.begin(), 20));
+        xlnt_assert_equals(copy.format_impls.size(), 200);
+    }
+
+    void test_format_by_index()
+    {
+        xlnt::detail::stylesheet s;
+        std::vector<xlnt::format> formats;
+
+        for (int size = 1; size <= 100; ++size)
+        {
+            formats.push_back(s.create_format(false).font(xlnt::font().size(size)));
+        }
+
+        for (std::size_t i = 0; i < formats.size(); ++i)
+        {
+            xlnt_assert_equals(s.format(i).font().size(), static_cast<double>(i + 1));
+        }
+
+        // garbage collection shifts the following formats down
+        formats.erase(formats.begin() + 10);
+        xlnt_assert_equals(s.format_impls.size(), 99);
+        xlnt_assert_equals(s.format(10).font().size(), 12.);
+        xlnt_assert_equals(s.format(98).font().size(), 100.);
+        xlnt_assert_throws(s.format(99), xlnt::invalid_parameter);
+
+        // formats appended directly, like the reader does, are found as well
+        s.format_impls.emplace_back();
+        (*s.format_impls.back()).parent = &s;
+        (*s.format_impls.back()).id = 99;
+        xlnt_assert(!s.format(99).has_font());
+    }
+
+    void test_compiled_number_formats()
+    {
+        xlnt::detail::stylesheet stylesheet;
+        auto &formats = stylesheet.compiled_number_formats;
+
+        auto windows = formats.formatter("yyyy-mm-dd", xlnt::calendar::windows_1900);
+        xlnt_assert_equals(formats.formatter("yyyy-mm-dd", xlnt::calendar::windows_1900), windows);
+        xlnt_assert_equals(windows->format_number(42537), "2016-06-16");
+
+        auto mac = formats.formatter("yyyy-mm-dd", xlnt::calendar::mac_1904);
+        xlnt_assert_differs(mac, windows);
+        xlnt_assert_equals(mac->format_number(41075), "2016-06-16");
+
+        // copies compile their formats again, comparison ignores them
+        auto copy = stylesheet;
+        xlnt_assert(copy == stylesheet);
+        xlnt_assert_differs(copy.compiled_number_formats.formatter("yyyy-mm-dd", xlnt::calendar::windows_1900), windows);
+
+        xlnt::workbook wb;
+        auto cell = wb.active_sheet().cell("A1");
+        cell.value(1.5);
+        xlnt_assert_equals(cell.to_string(), "1.5");
+        cell.value("text");
+        xlnt_assert_equals(cell.to_string(), "text");
+    }
+
+    void test_format_number_into_buffer()
+    {
+        std::string buffer("previous contents");
+
+        xlnt::detail::number_formatter("0.00", xlnt::calendar::windows_1900).format_number(1234.5678, buffer);
+        xlnt_assert_equals(buffer, "1234.57");
+        const auto capacity = buffer.capacity();
+
+        xlnt::detail::number_formatter("#,##0;(#,##0)", xlnt::calendar::windows_1900).format_number(-1234567, buffer);
+        xlnt_assert_equals(buffer, "(1,234,567)");
+
+        xlnt::detail::number_formatter("0%", xlnt::calendar::windows_1900).format_number(0.25, buffer);
+        xlnt_assert_equals(buffer, "25%");
+
+        const xlnt::detail::number_formatter date("yyyy-mm-dd", xlnt::calendar::windows_1900);
+        date.format_number(42537, buffer);
+        xlnt_assert_equals(buffer, "2016-06-16");
+        xlnt_assert_equals(date.format_number(42537), buffer);
+        date.format_number(-1, buffer);
+        xlnt_assert_equals(buffer, "###########");
+
+        xlnt_assert_equals(buffer.capacity(), capacity);
+    }
 };
 static format_impl_test_suite x;
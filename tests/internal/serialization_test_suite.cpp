@@ -28,6 +28,8 @@
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
 #include <helpers/internal/xml_helper.hpp>
+#include <detail/serialization/mapped_file.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
 #include <xlnt/internal/features.hpp>
@@ -77,7 +79,11 @@ public:
         register_test(test_round_trip_rw_encrypted_standard);
         register_test(test_round_trip_rw_encrypted_numbers);
         register_test(test_streaming_read);
+        register_test(test_streaming_read_reuses_cell);
+        register_test(test_streaming_read_visitor);
+        register_test(test_write_delimited);
         register_test(test_streaming_write);
+        register_test(test_streaming_write_rows);
         register_test(test_load_save_german_locale);
         register_test(test_Issue445_inline_str_load);
         register_test(test_Issue445_inline_str_streaming_read);
@@ -94,6 +100,19 @@ public:
         register_test(test_Issue41_empty_fill);
         register_test(test_value_with_default);
         register_test(test_coalesce_column_properties);
+        register_test(test_zip_buffer_size);
+        register_test(test_memory_mapped_loading);
+        register_test(test_stored_entry_size_mismatch);
+        register_test(test_truncated_deflated_entry);
+        register_test(test_entry_size_from_header);
+        register_test(test_load_thread_count);
+        register_test(test_load_sheet_data_in_batches);
+        register_test(test_load_selected_rows_and_columns);
+        register_test(test_load_selected_cell_attributes);
+        register_test(test_streaming_read_selected_rows_and_columns);
+        register_test(test_lazy_loading);
+        register_test(test_lazy_shared_strings);
+        register_test(test_write_sheet_data);
     }
 
     bool workbook_matches_file(xlnt::workbook &wb, const xlnt::path &file)
@@ -772,6 +791,166 @@ public:
         }
     }
 
+    void test_streaming_read_reuses_cell()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1.5);
+        ws.cell("B1").value("shared");
+        ws.cell("B1").number_format(xlnt::number_format::percentage());
+        ws.cell("A2").formula("A1*2");
+        ws.cell("C3").value(true);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet(ws.title());
+
+        xlnt_assert(reader.has_cell());
+        auto cell = reader.read_cell();
+        xlnt_assert_equals(cell.reference(), "A1");
+        xlnt_assert_equals(cell.value<double>(), 1.5);
+        xlnt_assert_equals(reader.read_cell_raw_value(), "1.5");
+
+        xlnt_assert(reader.has_cell());
+        xlnt_assert_equals(reader.read_cell().reference(), "B1");
+        xlnt_assert_equals(cell.value<std::string>(), "shared");
+        xlnt_assert(cell.has_format());
+
+        // The same cell is reused, so nothing of the previous cell is left
+        xlnt_assert(reader.has_cell());
+        xlnt_assert_equals(reader.read_cell().reference(), "A2");
+        xlnt_assert_equals(cell.formula(), "A1*2");
+        xlnt_assert(!cell.has_format());
+
+        xlnt_assert(reader.has_cell());
+        xlnt_assert_equals(reader.read_cell().reference(), "C3");
+        xlnt_assert_equals(cell.data_type(), xlnt::cell::type::boolean);
+        xlnt_assert(!cell.has_formula());
+        xlnt_assert_equals(reader.read_cell_raw_value(), "1");
+
+        xlnt_assert(!reader.has_cell());
+        reader.end_worksheet();
+    }
+
+    void test_streaming_read_visitor()
+    {
+        struct recorder : xlnt::sheet_visitor
+        {
+            void on_row_begin(xlnt::row_t row) override
+            {
+                events.push_back("row " + std::to_string(row));
+            }
+
+            void on_number(xlnt::row_t row, xlnt::column_t::index_t column, double value) override
+            {
+                events.push_back(xlnt::cell_reference(column, row).to_string() + " number " + std::to_string(value));
+            }
+
+            void on_shared_string(xlnt::row_t row, xlnt::column_t::index_t column, std::size_t index) override
+            {
+                events.push_back(xlnt::cell_reference(column, row).to_string() + " shared " + std::to_string(index));
+            }
+
+            void on_inline_string(xlnt::row_t row, xlnt::column_t::index_t column, const std::string &value) override
+            {
+                events.push_back(xlnt::cell_reference(column, row).to_string() + " inline " + value);
+            }
+
+            void on_boolean(xlnt::row_t row, xlnt::column_t::index_t column, bool value) override
+            {
+                events.push_back(xlnt::cell_reference(column, row).to_string() + " boolean " + (value ? "1" : "0"));
+            }
+
+            void on_formula(xlnt::row_t row, xlnt::column_t::index_t column, const std::string &formula) override
+            {
+                events.push_back(xlnt::cell_reference(column, row).to_string() + " formula " + formula);
+            }
+
+            void on_row_end(xlnt::row_t row) override
+            {
+                events.push_back("end " + std::to_string(row));
+            }
+
+            std::vector<std::string> events;
+        };
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(2);
+        ws.cell("B1").value("shared");
+        ws.cell("A2").formula("A1*2");
+        ws.cell("A2").value(4);
+        ws.cell("C2").value(true);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet(ws.title());
+
+        recorder visitor;
+        reader.read_cells(visitor);
+        auto streamed = reader.end_worksheet();
+
+        // nothing is kept per row
+        xlnt_assert(!streamed.has_row_properties(1));
+        xlnt_assert(!streamed.has_row_properties(2));
+
+        const auto expected = std::vector<std::string>{
+            "row 1",
+            "A1 number " + std::to_string(2.),
+            "B1 shared 0",
+            "end 1",
+            "row 2",
+            "A2 formula A1*2",
+            "A2 number " + std::to_string(4.),
+            "C2 boolean 1",
+            "end 2"};
+        xlnt_assert(visitor.events == expected);
+    }
+
+    void test_write_delimited()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1.5);
+        ws.cell("B1").value("a,b");
+        ws.cell("D1").value(true);
+        ws.cell("A3").value("say \"hi\"");
+        ws.cell("B3").value(0.25);
+        ws.cell("B3").number_format(xlnt::number_format::percentage());
+
+        std::ostringstream csv;
+        ws.write_delimited(csv);
+        xlnt_assert_equals(csv.str(), "1.5,\"a,b\",,TRUE\r\n\r\n\"say \"\"hi\"\"\",25%\r\n");
+
+        xlnt::delimited_text_options options;
+        options.delimiter = '\t';
+        options.line_ending = "\n";
+        options.apply_number_formats = false;
+
+        std::ostringstream tsv;
+        ws.write_delimited(tsv, options);
+        xlnt_assert_equals(tsv.str(), "1.5\ta,b\t\tTRUE\n\n\"say \"\"hi\"\"\"\t0.25\n");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet(ws.title());
+
+        std::ostringstream streamed;
+        reader.write_delimited(streamed);
+        reader.end_worksheet();
+
+        xlnt_assert_equals(streamed.str(), csv.str());
+    }
+
     void test_streaming_write()
     {
         const auto path = std::string("stream-out.xlsx");
@@ -789,6 +968,54 @@ public:
         c3.value("C3!");
     }
 
+    void test_streaming_write_rows()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(data);
+
+            auto first = writer.add_worksheet("first");
+            first.column_properties("B").width = 20.;
+
+            for (xlnt::row_t row = 1; row <= 100; ++row)
+            {
+                writer.add_cell(xlnt::cell_reference(2, row)).value("row " + std::to_string(row));
+                writer.add_cell(xlnt::cell_reference(1, row)).value(static_cast<int>(row));
+            }
+
+            auto styled = writer.add_cell("C102");
+            styled.font(xlnt::font().bold(true));
+            styled.value(1.5);
+
+            writer.add_worksheet("second");
+            writer.add_cell("C3").value(true);
+            writer.add_cell("A5").value("last");
+            xlnt_assert_throws(writer.add_cell("A4"), xlnt::invalid_parameter);
+
+            writer.close();
+        }
+
+        xlnt::workbook wb;
+        wb.load(data);
+
+        xlnt_assert_equals(wb.sheet_titles(), std::vector<std::string>({"first", "second"}));
+
+        auto first = wb.sheet_by_title("first");
+        xlnt_assert_equals(first.highest_row(), 102);
+        xlnt_assert_equals(first.cell("A57").value<int>(), 57);
+        xlnt_assert_equals(first.cell("B100").value<std::string>(), "row 100");
+        xlnt_assert(first.cell("C102").font().bold());
+        xlnt_assert_delta(first.cell("C102").value<double>(), 1.5, 1E-9);
+        xlnt_assert(first.has_column_properties("B"));
+
+        auto second = wb.sheet_by_title("second");
+        xlnt_assert(second.cell("C3").value<bool>());
+        xlnt_assert_equals(second.cell("A5").value<std::string>(), "last");
+        xlnt_assert(!second.has_cell("A4"));
+    }
+
     void test_load_save_german_locale()
     {
         /* std::locale current(std::locale::global(std::locale("de-DE")));
@@ -1016,6 +1243,608 @@ R"TEST(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>
         xlnt_assert_equals (parser.attribute<xlnt::column_t::index_t>("min"), 3);
         xlnt_assert_equals (parser.attribute<xlnt::column_t::index_t>("max"), 3);
     }
+
+    void test_zip_buffer_size()
+    {
+        xlnt::workbook wb;
+        xlnt_assert_equals (wb.zip_buffer_size(), xlnt::detail::default_zip_buffer_size);
+        wb.zip_buffer_size(1000);
+        xlnt_assert_equals (wb.zip_buffer_size(), 1000);
+
+        const auto entry_path = xlnt::path("xl/worksheets/sheet1.xml");
+        std::string expected;
+
+        for (int row = 1; row <= 2000; ++row)
+        {
+            expected.append("<row r=\"" + std::to_string(row) + "\"><c><v>" + std::to_string(row * 7) + "</v></c></row>");
+        }
+
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf buffer(data);
+            std::ostream stream(&buffer);
+            xlnt::detail::ozstream archive(stream, 1000);
+            auto entry_buffer = archive.open(entry_path);
+            std::ostream entry_stream(entry_buffer.get());
+            entry_stream << expected;
+        }
+
+        // the streaming path, the whole-entry path and read() all return the same bytes
+        for (auto buffer_size : {std::size_t(1), std::size_t(4096), 16 * expected.size()})
+        {
+            xlnt::detail::vector_istreambuf buffer(data);
+            std::istream stream(&buffer);
+            xlnt::detail::izstream archive(stream, buffer_size);
+
+            std::vector<std::uint8_t> entry;
+            archive.read(entry_path, entry);
+            xlnt_assert_equals (std::string(entry.begin(), entry.end()), expected);
+
+            auto entry_buffer = archive.open(entry_path);
+            std::istream entry_stream(entry_buffer.get());
+            std::string streamed((std::istreambuf_iterator<char>(entry_stream)), std::istreambuf_iterator<char>());
+            xlnt_assert_equals (streamed, expected);
+        }
+    }
+
+    void test_memory_mapped_loading()
+    {
+        temporary_file archive_file;
+        const auto entry_path = xlnt::path("xl/sharedStrings.xml");
+        const std::string expected(100000, 'x');
+
+        {
+            std::ofstream file_stream(archive_file.get_path().string(), std::ios::binary);
+            xlnt::detail::ozstream archive(file_stream);
+            auto entry_buffer = archive.open(entry_path);
+            std::ostream entry_stream(entry_buffer.get());
+            entry_stream << expected;
+        }
+
+        // the entry is inflated straight from the mapping, both as a whole and while streaming
+        for (auto buffer_size : {std::size_t(512), 2 * expected.size()})
+        {
+            auto file_buffer = xlnt::detail::open_mapped_file(archive_file.get_path().string());
+            std::istream file_stream(file_buffer.get());
+            xlnt::detail::izstream archive(file_stream, buffer_size);
+
+            xlnt_assert (archive.has_file(entry_path));
+            xlnt_assert_equals (archive.read(entry_path), expected);
+
+            auto entry_buffer = archive.open(entry_path);
+            std::istream entry_stream(entry_buffer.get());
+            std::string streamed((std::istreambuf_iterator<char>(entry_stream)), std::istreambuf_iterator<char>());
+            xlnt_assert_equals (streamed, expected);
+        }
+
+        xlnt::workbook wb;
+        xlnt_assert (!wb.memory_mapped_loading());
+        wb.memory_mapped_loading(true);
+        xlnt_assert_throws (wb.load(xlnt::path("DOES NOT EXIST.xlsx")), xlnt::invalid_file);
+
+        const auto path = path_helper::test_file("10_comments_hyperlinks_formulae.xlsx");
+        wb.load(path);
+        xlnt_assert (wb.memory_mapped_loading());
+
+        xlnt::workbook wb_streamed;
+        wb_streamed.load(path);
+        xlnt_assert (wb.compare(wb_streamed, false));
+    }
+
+    /// <summary>
+    /// Builds a zip archive with a single entry whose headers claim the given sizes, regardless of data.
+    /// If data_last is true, the entry is placed after the central directory, at the end of the archive.
+    /// </summary>
+    static std::vector<std::uint8_t> single_entry_archive(const std::string &name, std::uint16_t compression,
+        const std::string &data, std::uint32_t compressed_size, std::uint32_t uncompressed_size, bool data_last)
+    {
+        std::vector<std::uint8_t> archive;
+
+        auto write_int = [&archive](std::uint32_t value, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                archive.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+            }
+        };
+        auto write_sizes_and_name = [&]() {
+            write_int(0, 2); // flags
+            write_int(compression, 2);
+            write_int(0, 4); // time and date
+            write_int(0, 4); // crc
+            write_int(compressed_size, 4);
+            write_int(uncompressed_size, 4);
+            write_int(static_cast<std::uint32_t>(name.size()), 2);
+            write_int(0, 2); // extra field
+        };
+
+        const auto central_size = 46 + name.size();
+        const auto local_size = 30 + name.size() + data.size();
+        const auto local_offset = data_last ? central_size + 22 : 0;
+
+        auto write_local = [&]() {
+            write_int(0x04034b50, 4);
+            write_int(20, 2);
+            write_sizes_and_name();
+            archive.insert(archive.end(), name.begin(), name.end());
+            archive.insert(archive.end(), data.begin(), data.end());
+        };
+
+        if (!data_last)
+        {
+            write_local();
+        }
+
+        const auto central_offset = archive.size();
+        write_int(0x02014b50, 4);
+        write_int(20, 2);
+        write_int(20, 2);
+        write_sizes_and_name();
+        write_int(0, 2); // comment
+        write_int(0, 2); // disk
+        write_int(0, 2); // internal attributes
+        write_int(0, 4); // external attributes
+        write_int(static_cast<std::uint32_t>(local_offset), 4);
+        archive.insert(archive.end(), name.begin(), name.end());
+
+        write_int(0x06054b50, 4);
+        write_int(0, 4); // disks
+        write_int(1, 2);
+        write_int(1, 2);
+        write_int(static_cast<std::uint32_t>(central_size), 4);
+        write_int(static_cast<std::uint32_t>(central_offset), 4);
+        write_int(0, 2); // comment
+
+        if (data_last)
+        {
+            write_local();
+        }
+
+        xlnt_assert_equals (archive.size(), central_size + 22 + local_size);
+
+        return archive;
+    }
+
+    void test_stored_entry_size_mismatch()
+    {
+        // a stored entry with four bytes of data whose headers claim it is 1 MiB when uncompressed
+        const auto archive = single_entry_archive("[Content_Types].xml", 0, "<?xm", 4, 1 << 20, false);
+
+        xlnt::detail::memory_istreambuf memory_buffer(archive);
+        std::istream memory_stream(&memory_buffer);
+        xlnt_assert_throws (xlnt::detail::izstream(memory_stream, 512), xlnt::invalid_file);
+
+        xlnt::detail::vector_istreambuf vector_buffer(archive);
+        std::istream vector_stream(&vector_buffer);
+        xlnt_assert_throws (xlnt::detail::izstream(vector_stream, 512), xlnt::invalid_file);
+
+        xlnt::workbook wb;
+        xlnt_assert_throws (wb.load(archive), xlnt::invalid_file);
+    }
+
+    void test_truncated_deflated_entry()
+    {
+        // a deflate block which isn't the last one, so inflate always asks for more input
+        const std::string data("\x00\x04\x00\xfb\xff" "abcd", 9);
+        const auto path = xlnt::path("xl/sharedStrings.xml");
+
+        for (auto compressed_size : {std::uint32_t(9), std::uint32_t(100000)})
+        {
+            const auto archive = single_entry_archive(path.string(), 8, data, compressed_size, 100000, true);
+
+            for (auto in_memory : {false, true})
+            {
+                xlnt::detail::vector_istreambuf vector_buffer(archive);
+                xlnt::detail::memory_istreambuf memory_buffer(archive);
+                std::istream archive_stream(in_memory ? static_cast<std::streambuf *>(&memory_buffer) : &vector_buffer);
+                xlnt::detail::izstream archive_reader(archive_stream, 512);
+
+                xlnt_assert_throws (archive_reader.read(path), xlnt::invalid_file);
+                xlnt_assert_throws (std::string(std::istreambuf_iterator<char>(archive_reader.open(path).get()), std::istreambuf_iterator<char>()),
+                    xlnt::invalid_file);
+            }
+        }
+    }
+
+    void test_entry_size_from_header()
+    {
+        // a final stored deflate block, so the entry inflates to "abcd"
+        const std::string data("\x01\x04\x00\xfb\xff" "abcd", 9);
+        const auto path = xlnt::path("xl/sharedStrings.xml");
+
+        // a nine byte entry claiming 4 GiB mustn't make the reader allocate them
+        for (auto uncompressed_size : {std::uint32_t(4), std::uint32_t(2), std::uint32_t(0xffffffff)})
+        {
+            const auto archive = single_entry_archive(path.string(), 8, data, 9, uncompressed_size, true);
+
+            for (auto in_memory : {false, true})
+            {
+                xlnt::detail::vector_istreambuf vector_buffer(archive);
+                xlnt::detail::memory_istreambuf memory_buffer(archive);
+                std::istream archive_stream(in_memory ? static_cast<std::streambuf *>(&memory_buffer) : &vector_buffer);
+                xlnt::detail::izstream archive_reader(archive_stream, 512);
+
+                if (uncompressed_size == 4)
+                {
+                    xlnt_assert_equals (archive_reader.read(path), "abcd");
+                }
+                else
+                {
+                    xlnt_assert_throws (archive_reader.read(path), xlnt::invalid_file);
+                }
+            }
+        }
+
+        // a stored entry whose data ends before the size both headers agree on
+        const auto archive = single_entry_archive(path.string(), 0, "abcd", 1 << 30, 1 << 30, true);
+        xlnt::detail::vector_istreambuf vector_buffer(archive);
+        std::istream archive_stream(&vector_buffer);
+        xlnt::detail::izstream archive_reader(archive_stream, 512);
+        xlnt_assert_throws (archive_reader.read(path), xlnt::invalid_file);
+    }
+
+    void test_load_thread_count()
+    {
+        xlnt::workbook wb;
+        xlnt_assert_equals (wb.load_thread_count(), 1);
+
+        for (auto file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx", "13_custom_heights_widths.xlsx"})
+        {
+            const auto path = path_helper::test_file(file);
+
+            xlnt::workbook wb_serial;
+            wb_serial.load(path);
+
+            for (auto thread_count : {std::size_t(0), std::size_t(2), std::size_t(8)})
+            {
+                xlnt::workbook wb_parallel;
+                wb_parallel.load_thread_count(thread_count);
+                wb_parallel.load(path);
+
+                xlnt_assert_equals (wb_parallel.load_thread_count(), thread_count);
+                xlnt_assert (wb_parallel.compare(wb_serial, false));
+                xlnt_assert_equals (wb_parallel.active_sheet().title(), wb_serial.active_sheet().title());
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> grid_workbook_data()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 20; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 10; ++column)
+            {
+                ws.cell(column, row).value(static_cast<int>(row * 100 + column));
+            }
+        }
+
+        ws.merge_cells("A19:B20");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        return data;
+    }
+
+    void test_load_selected_rows_and_columns()
+    {
+        xlnt::workbook wb;
+        xlnt_assert(wb.load_columns().empty());
+        xlnt_assert_equals(wb.load_first_row(), 1);
+        xlnt_assert_throws(wb.load_rows(0, 10), xlnt::invalid_parameter);
+        xlnt_assert_throws(wb.load_rows(5, 4), xlnt::invalid_parameter);
+
+        wb.load_columns({"B", "E"});
+        wb.load_rows(3, 6);
+        wb.load(grid_workbook_data());
+
+        auto ws = wb.active_sheet();
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("B3:E6"));
+        xlnt_assert_equals(ws.cell("B3").value<int>(), 302);
+        xlnt_assert_equals(ws.cell("E6").value<int>(), 605);
+        xlnt_assert(!ws.has_cell("C4"));
+        xlnt_assert(!ws.has_cell("B7"));
+        // the worksheet wasn't read beyond row 6
+        xlnt_assert(ws.merged_ranges().empty());
+
+        wb.load_columns({});
+        wb.load_rows(1, xlnt::constants::max_row());
+        wb.load(grid_workbook_data());
+        xlnt_assert_equals(wb.active_sheet().calculate_dimension(), xlnt::range_reference("A1:J20"));
+        xlnt_assert_equals(wb.active_sheet().merged_ranges().size(), 1);
+    }
+
+    void test_load_selected_cell_attributes()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 8; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 6; ++column)
+            {
+                ws.cell(column, row).value(static_cast<int>(row * 100 + column));
+            }
+        }
+
+        ws.cell("A1").comment("outside", "author");
+        ws.cell("C4").comment("outside", "author");
+        ws.cell("B3").comment("inside", "author");
+        ws.cell("A2").hyperlink("https://example.com/outside");
+        ws.cell("E5").hyperlink("https://example.com/inside");
+
+        std::vector<std::uint8_t> saved;
+        wb.save(saved);
+
+        // the producer doesn't write array formulae, so one is added to B3 by hand
+        std::vector<std::uint8_t> data;
+        {
+            xlnt::detail::vector_istreambuf in_buffer(saved);
+            std::istream in_stream(&in_buffer);
+            xlnt::detail::izstream in_archive(in_stream);
+
+            xlnt::detail::vector_ostreambuf out_buffer(data);
+            std::ostream out_stream(&out_buffer);
+            xlnt::detail::ozstream out_archive(out_stream);
+
+            for (const auto &part : in_archive.files())
+            {
+                auto content = in_archive.read(part);
+
+                if (part == xlnt::path("xl/worksheets/sheet1.xml"))
+                {
+                    const auto cell_start = content.find('>', content.find("r=\"B3\"")) + 1;
+                    content.insert(cell_start, "<f t=\"array\" ref=\"B3:F7\">1+1</f>");
+                }
+
+                auto part_buffer = out_archive.open(part);
+                std::ostream part_stream(part_buffer.get());
+                part_stream << content;
+            }
+        }
+
+        xlnt::workbook wb_selected;
+        wb_selected.load_columns({"B", "E"});
+        wb_selected.load_rows(3, 6);
+        wb_selected.load(data);
+
+        // comments, hyperlinks and array formulae don't create cells outside of the window
+        auto ws_selected = wb_selected.active_sheet();
+        xlnt_assert_equals(ws_selected.calculate_dimension(), xlnt::range_reference("B3:E6"));
+        xlnt_assert(!ws_selected.has_cell("A1"));
+        xlnt_assert(!ws_selected.has_cell("A2"));
+        xlnt_assert(!ws_selected.has_cell("C4"));
+        xlnt_assert(!ws_selected.has_cell("F3"));
+        xlnt_assert(!ws_selected.has_cell("B7"));
+
+        xlnt_assert_equals(ws_selected.cell("B3").comment().plain_text(), "inside");
+        xlnt_assert_equals(ws_selected.cell("E5").hyperlink().url(), "https://example.com/inside");
+        xlnt_assert_equals(ws_selected.cell("B3").formula(), "1+1");
+        xlnt_assert_equals(ws_selected.cell("E6").formula(), "1+1");
+    }
+
+    void test_streaming_read_selected_rows_and_columns()
+    {
+        const auto data = grid_workbook_data();
+        xlnt::streaming_workbook_reader reader;
+        reader.load_columns({"C"});
+        reader.load_rows(18, 30);
+        reader.open(data);
+        reader.begin_worksheet("Sheet1");
+
+        for (auto row : {18, 19, 20})
+        {
+            xlnt_assert(reader.has_cell());
+            auto cell = reader.read_cell();
+            xlnt_assert_equals(cell.reference(), xlnt::cell_reference("C", static_cast<xlnt::row_t>(row)));
+            xlnt_assert_equals(cell.value<int>(), row * 100 + 3);
+        }
+
+        xlnt_assert(!reader.has_cell());
+        reader.end_worksheet();
+    }
+
+    void test_lazy_loading()
+    {
+        xlnt::workbook wb;
+        xlnt_assert (!wb.lazy_loading());
+
+        wb.active_sheet().title("First");
+        wb.active_sheet().cell("A1").value("first");
+        wb.create_sheet().title("Second");
+        wb.sheet_by_title("Second").cell("B2").value(2);
+        wb.create_sheet().title("Third");
+        wb.sheet_by_title("Third").cell("C3").value(3.5);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook wb_lazy;
+        wb_lazy.lazy_loading(true);
+        wb_lazy.load(data);
+
+        xlnt_assert (wb_lazy.lazy_loading());
+        xlnt_assert_equals (wb_lazy.sheet_count(), 3);
+        xlnt_assert_equals (wb_lazy.sheet_titles(), std::vector<std::string>({"First", "Second", "Third"}));
+        xlnt_assert (wb_lazy.contains("Third"));
+
+        // only the worksheet which is accessed is read
+        xlnt_assert_equals (wb_lazy.sheet_by_title("Second").cell("B2").value<int>(), 2);
+        xlnt_assert_equals (wb_lazy.sheet_by_index(2).cell("C3").value<double>(), 3.5);
+
+        // reading the last pending worksheet releases the package afterwards
+        xlnt_assert_equals (wb_lazy.sheet_by_index(0).cell("A1").value<std::string>(), "first");
+        xlnt_assert (wb_lazy.compare(wb, false));
+
+        xlnt::workbook wb_all;
+        wb_all.lazy_loading(true);
+        wb_all.load(data);
+        xlnt_assert (wb_all.compare(wb, false));
+        xlnt_assert_equals (wb_all.sheet_by_title("Third").cell("C3").value<double>(), 3.5);
+
+        for (auto file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx", "19_defined_names.xlsx"})
+        {
+            const auto path = path_helper::test_file(file);
+
+            xlnt::workbook wb_eager;
+            wb_eager.load(path);
+
+            xlnt::workbook wb_file;
+            wb_file.lazy_loading(true);
+            wb_file.load(path);
+            wb_file.active_sheet();
+
+            xlnt_assert (workbook_matches_file(wb_file, path));
+            xlnt_assert (wb_file.compare(wb_eager, false));
+
+            // the worksheets are read from the mapping, which is kept after load() returned
+            xlnt::workbook wb_mapped;
+            wb_mapped.lazy_loading(true);
+            wb_mapped.memory_mapped_loading(true);
+            wb_mapped.load(path);
+            xlnt_assert (wb_mapped.compare(wb_eager, false));
+
+            xlnt::workbook wb_threads;
+            wb_threads.lazy_loading(true);
+            wb_threads.load_thread_count(2);
+            std::ifstream file_stream(path.string(), std::ios::binary);
+            wb_threads.load(file_stream);
+            file_stream.close();
+            xlnt_assert (wb_threads.compare(wb_eager, false));
+        }
+    }
+
+    void test_lazy_shared_strings()
+    {
+        xlnt::workbook wb;
+        xlnt_assert (!wb.lazy_shared_strings());
+
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("plain");
+        ws.cell("A2").value(" spaces & <markup> ");
+        ws.cell("A3").value("line\r\nbreak");
+        xlnt::rich_text rich;
+        rich.add_run(xlnt::rich_text_run{"bold", xlnt::font().bold(true)});
+        rich.add_run(xlnt::rich_text_run{" text", xlnt::optional<xlnt::font>()});
+        ws.cell("A4").value(rich);
+        ws.cell("A5").value("plain");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook wb_eager;
+        wb_eager.load(data);
+
+        xlnt::workbook wb_lazy;
+        wb_lazy.lazy_shared_strings(true);
+        wb_lazy.load(data);
+
+        xlnt_assert (wb_lazy.lazy_shared_strings());
+
+        // entries are decoded one by one as cells refer to them
+        auto ws_lazy = wb_lazy.active_sheet();
+        for (auto row = 1; row <= 5; ++row)
+        {
+            const auto reference = xlnt::cell_reference("A", static_cast<xlnt::row_t>(row));
+            xlnt_assert_equals (ws_lazy.cell(reference).value<xlnt::rich_text>(),
+                wb_eager.active_sheet().cell(reference).value<xlnt::rich_text>());
+        }
+
+        xlnt_assert (wb_lazy.compare(wb_eager, false));
+        xlnt_assert_equals (wb_lazy.add_shared_string(xlnt::rich_text("plain")), 0);
+
+        for (auto file : {"10_comments_hyperlinks_formulae.xlsx", "15_phonetics.xlsx", "18_formulae.xlsx"})
+        {
+            const auto path = path_helper::test_file(file);
+
+            xlnt::workbook wb_file;
+            wb_file.lazy_shared_strings(true);
+            wb_file.load(path);
+
+            xlnt_assert (workbook_matches_file(wb_file, path));
+        }
+
+        xlnt::streaming_workbook_reader reader;
+        reader.lazy_shared_strings(true);
+        reader.open(data);
+        reader.begin_worksheet("Sheet1");
+        xlnt_assert (reader.has_cell());
+        xlnt_assert_equals (reader.read_cell().value<std::string>(), "plain");
+    }
+
+    void test_load_sheet_data_in_batches()
+    {
+        // Enough rows for the sheet data to be parsed and inserted in several batches
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 5000; ++row)
+        {
+            ws.cell(1, row).value(static_cast<int>(row));
+            ws.cell(2, row).value("text " + std::to_string(row % 100));
+            ws.cell(3, row).formula("A" + std::to_string(row) + "*2");
+
+            if (row % 7 == 0)
+            {
+                ws.row_properties(row).height = 20;
+                ws.cell(1, row).number_format(xlnt::number_format::percentage());
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        for (auto thread_count : {std::size_t(1), std::size_t(2)})
+        {
+            xlnt::workbook loaded;
+            loaded.load_thread_count(thread_count);
+            loaded.load(data);
+
+            xlnt_assert (loaded.compare(wb, false));
+            xlnt_assert_equals (loaded.active_sheet().cell(3, 4900).formula(), "A4900*2");
+            xlnt_assert_equals (loaded.active_sheet().row_properties(4900).height.get(), 20);
+        }
+    }
+
+    void test_write_sheet_data()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(0.1);
+        ws.cell("B1").value("<a & \"b\">\ttab");
+        ws.cell("C1").formula("IF(A1<1,\"<&>\",\"\")");
+        ws.cell("D1").font(xlnt::font().bold(true));
+        ws.cell("AA1048576").value(true);
+
+        xlnt::rich_text text;
+        text.add_run(xlnt::rich_text_run{"bold", xlnt::font().bold(true), false});
+        text.add_run(xlnt::rich_text_run{" plain ", {}, true});
+        ws.cell("A2").value(text);
+
+        ws.row_properties(3).height = 20.5;
+        ws.row_properties(3).dy_descent = 0.25;
+        ws.row_properties(3).outline_level = 2;
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+        auto loaded_ws = loaded.active_sheet();
+
+        xlnt_assert_equals(loaded_ws.cell("A1").value<double>(), 0.1);
+        xlnt_assert_equals(loaded_ws.cell("B1").value<std::string>(), "<a & \"b\">\ttab");
+        xlnt_assert_equals(loaded_ws.cell("C1").formula(), "IF(A1<1,\"<&>\",\"\")");
+        xlnt_assert(loaded_ws.cell("D1").font().bold());
+        xlnt_assert(loaded_ws.cell("AA1048576").value<bool>());
+        xlnt_assert_equals(loaded_ws.cell("A2").value<xlnt::rich_text>(), text);
+        xlnt_assert_equals(loaded_ws.row_properties(3).height.get(), 20.5);
+        xlnt_assert_equals(loaded_ws.row_properties(3).dy_descent.get(), 0.25);
+        xlnt_assert_equals(loaded_ws.row_properties(3).outline_level.get(), 2);
+    }
 };
 
 static serialization_test_suite x;
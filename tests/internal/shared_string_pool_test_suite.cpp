@@ -0,0 +1,114 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <string>
+
+#include <helpers/test_suite.hpp>
+#include <xlnt/xlnt.hpp>
+
+#include <detail/implementations/shared_string_pool.hpp>
+
+class shared_string_pool_test_suite : public test_suite
+{
+public:
+    shared_string_pool_test_suite()
+    {
+        register_test(test_set_replaces_strings);
+        register_test(test_at_keeps_references);
+        register_test(test_copy);
+    }
+
+    void test_set_replaces_strings()
+    {
+        xlnt::detail::shared_string_pool pool;
+        pool.resize(3);
+        pool.set(0, "first", false);
+        pool.set(1, "second", true);
+
+        const auto formatted = xlnt::rich_text("formatted", xlnt::font().bold(true));
+        pool.set(2, formatted);
+
+        // shorter text takes the place of the text it replaces
+        pool.set(1, "2nd", false);
+        xlnt_assert_equals(pool.plain_text(0), "first");
+        xlnt_assert_equals(pool.plain_text(1), "2nd");
+        xlnt_assert(!pool.preserve_space(1));
+
+        // replacing the strings over and over compacts the text they leave behind
+        for (int i = 0; i < 1000; ++i)
+        {
+            pool.set(1, std::string(static_cast<std::size_t>(i % 50), 'x') + std::to_string(i), true);
+            pool.set(2, i % 2 == 0 ? xlnt::rich_text("plain " + std::to_string(i)) : formatted);
+        }
+
+        xlnt_assert_equals(pool.size(), 3);
+        xlnt_assert_equals(pool.plain_text(0), "first");
+        xlnt_assert_equals(pool.plain_text(1), std::string(49, 'x') + "999");
+        xlnt_assert(pool.preserve_space(1));
+        xlnt_assert(!pool.is_plain(2));
+        xlnt_assert_equals(pool.get(2), formatted);
+
+        pool.set(2, xlnt::rich_text("last"));
+        xlnt_assert(pool.is_plain(2));
+        xlnt_assert_equals(pool.get(2), xlnt::rich_text("last"));
+        xlnt_assert_equals(pool.find(xlnt::rich_text("last")), 2);
+        xlnt_assert_equals(pool.find(formatted), 3);
+    }
+
+    void test_at_keeps_references()
+    {
+        xlnt::detail::shared_string_pool pool;
+        pool.push_back(xlnt::rich_text("a"));
+        const auto &a = pool.at(0);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.push_back(xlnt::rich_text(std::to_string(i)));
+            pool.at(pool.size() - 1);
+        }
+
+        xlnt_assert_equals(&pool.at(0), &a);
+        xlnt_assert_equals(a, xlnt::rich_text("a"));
+
+        pool.set(0, "b", false);
+        xlnt_assert_equals(pool.at(0), xlnt::rich_text("b"));
+    }
+
+    void test_copy()
+    {
+        xlnt::detail::shared_string_pool pool;
+        pool.push_back(xlnt::rich_text("a"));
+        pool.push_back(xlnt::rich_text("b"));
+        pool.at(0);
+
+        auto copy = pool;
+        xlnt_assert(copy == pool);
+        xlnt_assert_equals(copy.at(0), xlnt::rich_text("a"));
+        xlnt_assert(&copy.at(0) != &pool.at(0));
+
+        copy.set(1, "c", false);
+        xlnt_assert(copy != pool);
+        xlnt_assert_equals(pool.plain_text(1), "b");
+    }
+};
+static shared_string_pool_test_suite x;
@@ -23,7 +23,10 @@
 
 #include <helpers/test_suite.hpp>
 
+#include <xlnt/cell/cell.hpp>
 #include <xlnt/styles/font.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
 
 class font_test_suite : public test_suite
 {
@@ -34,6 +37,7 @@ public:
         register_test(test_family);
         register_test(test_charset);
         register_test(test_scheme);
+        register_test(test_outline);
     }
 
     void test_color()
@@ -84,5 +88,25 @@ public:
         xlnt_assert(font.has_scheme());
         xlnt_assert_equals(font.scheme(), "scheme");
     }
+
+    void test_outline()
+    {
+        xlnt::font font;
+        xlnt_assert(!font.outline());
+
+        auto outlined = font;
+        outlined.outline(true);
+
+        // the outline is part of the hash of a font, so it has to be compared as well
+        xlnt_assert(outlined.outline());
+        xlnt_assert(font != outlined);
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").font(font);
+        ws.cell("A2").font(outlined);
+        xlnt_assert(!ws.cell("A1").font().outline());
+        xlnt_assert(ws.cell("A2").font().outline());
+    }
 };
 static font_test_suite x;
@@ -50,6 +50,7 @@ public:
         register_test(test_style);
         register_test(test_issue93);
         register_test(test_format_garbage_collection);
+        register_test(test_format_reuse_after_garbage_collection);
     }
 
     void test_alignment()
@@ -233,5 +234,22 @@ public:
         }
         xlnt_assert_equals(wb.format_count(), 1);
     }
+
+    void test_format_reuse_after_garbage_collection()
+    {
+        xlnt::workbook wb;
+        xlnt::worksheet ws = wb.active_sheet();
+
+        ws.cell("A1").font(xlnt::font().bold(true));
+        ws.cell("A2").font(xlnt::font().italic(true));
+        xlnt_assert_equals(wb.format_count(), 3);
+
+        // the bold font is garbage collected, so the italic font and the format of A2 are renumbered
+        ws.cell("A1").clear_format();
+        xlnt_assert_equals(wb.format_count(), 2);
+
+        ws.cell("A3").font(xlnt::font().italic(true));
+        xlnt_assert_equals(wb.format_count(), 2); // same format as A2
+    }
 };
 static format_test_suite x;
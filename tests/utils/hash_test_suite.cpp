@@ -23,8 +23,13 @@
 
 #include <helpers/test_suite.hpp>
 
+#include <xlnt/styles/alignment.hpp>
+#include <xlnt/styles/border.hpp>
 #include <xlnt/styles/color.hpp>
+#include <xlnt/styles/fill.hpp>
 #include <xlnt/styles/font.hpp>
+#include <xlnt/styles/number_format.hpp>
+#include <xlnt/styles/protection.hpp>
 
 #include <unordered_set>
 #include <vector>
@@ -40,6 +45,7 @@ public:
         register_test(test_hash_consistency);
         register_test(test_font_special_attributes);
         register_test(test_color_special_attributes);
+        register_test(test_style_component_hashes);
     }
 
     void test_color_hash_functionality()
@@ -272,6 +278,47 @@ public:
 
         xlnt_assert_equals(hasher(color2), hasher(color3));
     }
+
+    void test_style_component_hashes()
+    {
+        // Equal components must hash equally, they are deduplicated through hash indexes
+        xlnt::alignment alignment1;
+        alignment1.horizontal(xlnt::horizontal_alignment::center).wrap(true);
+        xlnt::alignment alignment2;
+        alignment2.horizontal(xlnt::horizontal_alignment::center).wrap(true);
+        xlnt_assert(alignment1 == alignment2);
+        xlnt_assert_equals(std::hash<xlnt::alignment>()(alignment1), std::hash<xlnt::alignment>()(alignment2));
+        xlnt_assert(std::hash<xlnt::alignment>()(alignment1) != std::hash<xlnt::alignment>()(xlnt::alignment()));
+
+        xlnt::border border1;
+        border1.side(xlnt::border_side::top, xlnt::border::border_property().style(xlnt::border_style::thin));
+        xlnt::border border2;
+        border2.side(xlnt::border_side::top, xlnt::border::border_property().style(xlnt::border_style::thin));
+        xlnt_assert(border1 == border2);
+        xlnt_assert_equals(std::hash<xlnt::border>()(border1), std::hash<xlnt::border>()(border2));
+        xlnt_assert(std::hash<xlnt::border>()(border1) != std::hash<xlnt::border>()(xlnt::border()));
+
+        xlnt::fill fill1(xlnt::pattern_fill().type(xlnt::pattern_fill_type::solid).foreground(xlnt::color::red()));
+        xlnt::fill fill2(xlnt::pattern_fill().type(xlnt::pattern_fill_type::solid).foreground(xlnt::color::red()));
+        xlnt_assert(fill1 == fill2);
+        xlnt_assert_equals(std::hash<xlnt::fill>()(fill1), std::hash<xlnt::fill>()(fill2));
+        xlnt_assert(std::hash<xlnt::fill>()(fill1) != std::hash<xlnt::fill>()(xlnt::fill(xlnt::gradient_fill())));
+
+        xlnt::number_format format1("0.000");
+        xlnt::number_format format2("0.000");
+        xlnt_assert_equals(std::hash<xlnt::number_format>()(format1), std::hash<xlnt::number_format>()(format2));
+        xlnt_assert(std::hash<xlnt::number_format>()(format1) != std::hash<xlnt::number_format>()(xlnt::number_format::percentage()));
+
+        xlnt_assert_equals(std::hash<xlnt::protection>()(xlnt::protection::locked_and_hidden()),
+            std::hash<xlnt::protection>()(xlnt::protection::locked_and_hidden()));
+        xlnt_assert(std::hash<xlnt::protection>()(xlnt::protection::locked_and_hidden())
+            != std::hash<xlnt::protection>()(xlnt::protection::unlocked_and_visible()));
+
+        // outline is part of font equality as well as of its hash
+        xlnt::font outlined;
+        outlined.outline(true);
+        xlnt_assert(outlined != xlnt::font());
+    }
 };
 
 static hash_test_suite x;
@@ -0,0 +1,312 @@
+// Copyright (c) 2026 xlnt-community
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <vector>
+
+#include <helpers/test_suite.hpp>
+#include <xlnt/cell/cell.hpp>
+#include <xlnt/workbook/calculation_properties.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+
+class calculation_test_suite : public test_suite
+{
+public:
+    calculation_test_suite()
+    {
+        register_test(test_calculate_operators);
+        register_test(test_calculate_functions);
+        register_test(test_calculate_other_sheets);
+        register_test(test_calculate_errors);
+        register_test(test_recalculate_changed_cells);
+        register_test(test_recalculate_changed_formulas);
+        register_test(test_calculate_before_save);
+        register_test(test_calculate_concurrently);
+    }
+
+    void test_calculate_operators()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(2);
+        ws.cell("A2").value(3);
+        ws.cell("A3").value("x");
+        ws.cell("B1").formula("=A1+A2*4");
+        ws.cell("B2").formula("=(A1+A2)^2/5");
+        ws.cell("B3").formula("=-A1&A3&50%");
+        ws.cell("B4").formula("=A1<A2");
+        ws.cell("B5").formula("=\"a\"=\"A\"");
+        ws.cell("B6").formula("=C1+1");
+
+        wb.calculate();
+
+        xlnt_assert_equals(ws.cell("B1").data_type(), xlnt::cell::type::number);
+        xlnt_assert_equals(ws.cell("B1").value<double>(), 14.0);
+        xlnt_assert_equals(ws.cell("B2").value<double>(), 5.0);
+        xlnt_assert_equals(ws.cell("B3").data_type(), xlnt::cell::type::formula_string);
+        xlnt_assert_equals(ws.cell("B3").value<std::string>(), "-2x0.5");
+        xlnt_assert_equals(ws.cell("B4").data_type(), xlnt::cell::type::boolean);
+        xlnt_assert(ws.cell("B4").value<bool>());
+        xlnt_assert(ws.cell("B5").value<bool>());
+        xlnt_assert_equals(ws.cell("B6").value<double>(), 1.0);
+        xlnt_assert_equals(ws.cell("B1").formula(), "A1+A2*4");
+    }
+
+    void test_calculate_functions()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        const std::vector<std::string> names = {"apple", "banana", "cherry", "date"};
+
+        for (xlnt::row_t row = 1; row <= 4; ++row)
+        {
+            ws.cell(1, row).value(names[row - 1]);
+            ws.cell(2, row).value(static_cast<int>(row) * 10);
+        }
+
+        ws.cell("D1").formula("=SUM(B1:B4)");
+        ws.cell("D2").formula("=AVERAGE(B:B)");
+        ws.cell("D3").formula("=COUNTIF(B1:B4,\">15\")");
+        ws.cell("D4").formula("=SUMIF(A1:A4,\"b*\",B1:B4)");
+        ws.cell("D5").formula("=VLOOKUP(\"cherry\",A1:B4,2,FALSE)");
+        ws.cell("D6").formula("=INDEX(A1:A4,MATCH(40,B1:B4,0))");
+        ws.cell("D7").formula("=IF(MAX(B1:B4)>30,\"high\",\"low\")");
+        ws.cell("D8").formula("=ROUND(D2/3,2)");
+        ws.cell("D9").formula("=UPPER(LEFT(A2,3))&LEN(A3)");
+        ws.cell("D10").formula("=IFERROR(VLOOKUP(\"fig\",A1:B4,2,FALSE),-1)");
+        ws.cell("D11").formula("=AND(COUNT(B1:B4)=4,NOT(ISBLANK(A1)))");
+
+        wb.calculate();
+
+        xlnt_assert_equals(ws.cell("D1").value<double>(), 100.0);
+        xlnt_assert_equals(ws.cell("D2").value<double>(), 25.0);
+        xlnt_assert_equals(ws.cell("D3").value<double>(), 3.0);
+        xlnt_assert_equals(ws.cell("D4").value<double>(), 20.0);
+        xlnt_assert_equals(ws.cell("D5").value<double>(), 30.0);
+        xlnt_assert_equals(ws.cell("D6").value<std::string>(), "date");
+        xlnt_assert_equals(ws.cell("D7").value<std::string>(), "high");
+        xlnt_assert_equals(ws.cell("D8").value<double>(), 8.33);
+        xlnt_assert_equals(ws.cell("D9").value<std::string>(), "BAN6");
+        xlnt_assert_equals(ws.cell("D10").value<double>(), -1.0);
+        xlnt_assert(ws.cell("D11").value<bool>());
+    }
+
+    void test_calculate_other_sheets()
+    {
+        xlnt::workbook wb;
+        auto first = wb.active_sheet();
+        auto second = wb.create_sheet();
+        second.title("Other Sheet");
+        second.cell("A1").value(5);
+        second.cell("A2").formula("=Sheet1!A1*2");
+        first.cell("A1").formula("='Other Sheet'!A1+1");
+        first.cell("A2").formula("=SUM('other sheet'!A1:A2)");
+
+        wb.calculate();
+
+        xlnt_assert_equals(first.cell("A1").value<double>(), 6.0);
+        xlnt_assert_equals(second.cell("A2").value<double>(), 12.0);
+        xlnt_assert_equals(first.cell("A2").value<double>(), 17.0);
+    }
+
+    void test_calculate_errors()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("text");
+        ws.cell("B1").formula("=1/0");
+        ws.cell("B2").formula("=A1*2");
+        ws.cell("B3").formula("=B1+1");
+        ws.cell("B4").formula("=Missing!A1");
+        ws.cell("B5").formula("=B6+1");
+        ws.cell("B6").formula("=B5+1");
+        ws.cell("B7").formula("=UNSUPPORTED(1)");
+        ws.cell("B7").value(42);
+        ws.cell("B8").formula("=B5+10");
+        ws.cell("B9").formula("=B9*2+1");
+        ws.cell("B10").formula("=B8+B9+1");
+
+        wb.calculate();
+
+        xlnt_assert_equals(ws.cell("B1").error(), "#DIV/0!");
+        xlnt_assert_equals(ws.cell("B2").error(), "#VALUE!");
+        xlnt_assert_equals(ws.cell("B3").error(), "#DIV/0!");
+        xlnt_assert_equals(ws.cell("B4").error(), "#REF!");
+
+        // circular references evaluate to 0
+        xlnt_assert_equals(ws.cell("B5").value<double>(), 0.0);
+        xlnt_assert_equals(ws.cell("B6").value<double>(), 0.0);
+        xlnt_assert_equals(ws.cell("B9").value<double>(), 0.0);
+
+        // formulas reading them are evaluated with that value
+        xlnt_assert_equals(ws.cell("B8").value<double>(), 10.0);
+        xlnt_assert_equals(ws.cell("B10").value<double>(), 11.0);
+
+        // formulas which can't be evaluated keep their values
+        xlnt_assert_equals(ws.cell("B7").value<int>(), 42);
+    }
+
+    void test_recalculate_changed_cells()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1);
+        ws.cell("A2").value(2);
+        ws.cell("B1").formula("=A1*10");
+        ws.cell("B2").formula("=A2*10");
+        ws.cell("C1").formula("=SUM(B1:B2)");
+
+        wb.calculate();
+        xlnt_assert_equals(ws.cell("C1").value<double>(), 30.0);
+
+        // a formula which doesn't read a changed cell isn't evaluated again,
+        // which is made visible by overwriting its result
+        ws.cell("B2").value(0);
+        ws.cell("A1").value(5);
+        wb.calculate();
+
+        xlnt_assert_equals(ws.cell("B1").value<double>(), 50.0);
+        xlnt_assert_equals(ws.cell("B2").value<double>(), 0.0);
+        xlnt_assert_equals(ws.cell("C1").value<double>(), 50.0);
+
+        ws.cell("A2").value(3);
+        ws.clear_cell("A1");
+        wb.calculate();
+
+        xlnt_assert_equals(ws.cell("B1").value<double>(), 0.0);
+        xlnt_assert_equals(ws.cell("B2").value<double>(), 30.0);
+        xlnt_assert_equals(ws.cell("C1").value<double>(), 30.0);
+    }
+
+    void test_recalculate_changed_formulas()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(4);
+        ws.cell("B1").formula("=A1+1");
+        ws.cell("C1").formula("=B1*2");
+
+        wb.calculate();
+        xlnt_assert_equals(ws.cell("C1").value<double>(), 10.0);
+
+        ws.cell("B1").formula("=A1-1");
+        wb.calculate();
+        xlnt_assert_equals(ws.cell("B1").value<double>(), 3.0);
+        xlnt_assert_equals(ws.cell("C1").value<double>(), 6.0);
+
+        ws.cell("B1").clear_formula();
+        ws.cell("B1").value(7);
+        wb.calculate();
+        xlnt_assert_equals(ws.cell("C1").value<double>(), 14.0);
+
+        ws.cell("D1").formula("=C1&\"!\"");
+        wb.calculate();
+        xlnt_assert_equals(ws.cell("D1").value<std::string>(), "14!");
+    }
+
+    void test_calculate_before_save()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1);
+        ws.cell("B1").formula("=A1*3");
+        wb.calculate();
+
+        ws.cell("A1").value(2);
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+        xlnt_assert_equals(loaded.active_sheet().cell("B1").value<double>(), 6.0);
+        xlnt_assert_equals(loaded.active_sheet().cell("B1").formula(), "A1*3");
+    }
+
+    void test_calculate_concurrently()
+    {
+        // each column total reads enough cells for the totals to be calculated concurrently
+        const xlnt::column_t::index_t columns = 64;
+        const xlnt::row_t rows = 400;
+
+        auto build = [&](xlnt::workbook &wb) {
+            auto ws = wb.active_sheet();
+
+            for (xlnt::column_t::index_t column = 1; column <= columns; ++column)
+            {
+                for (xlnt::row_t row = 1; row <= rows; ++row)
+                {
+                    ws.cell(column, row).value(static_cast<double>(column * row % 97));
+                }
+
+                const auto letter = xlnt::column_t::column_string_from_index(column);
+                ws.cell(column, rows + 1).formula("=SUM(" + letter + "1:" + letter + std::to_string(rows) + ")");
+                ws.cell(column, rows + 2).formula("=" + letter + std::to_string(rows + 1) + "*2+MAX(" + letter + "1:" + letter + std::to_string(rows) + ")");
+            }
+
+            ws.cell(1, rows + 3).formula("=SUM(A" + std::to_string(rows + 2) + ":BL" + std::to_string(rows + 2) + ")");
+        };
+
+        xlnt::workbook serial;
+        build(serial);
+        serial.calculate();
+
+        xlnt::workbook concurrent;
+        concurrent.calculation_thread_count(4);
+        xlnt_assert_equals(concurrent.calculation_thread_count(), 4);
+        build(concurrent);
+        concurrent.calculate();
+
+        xlnt::workbook disabled;
+        disabled.calculation_thread_count(4);
+        xlnt::calculation_properties properties;
+        properties.concurrent_calc = false;
+        disabled.calculation_properties(properties);
+        build(disabled);
+        disabled.calculate();
+
+        auto expected = serial.active_sheet();
+        auto actual = concurrent.active_sheet();
+
+        for (xlnt::column_t::index_t column = 1; column <= columns; ++column)
+        {
+            for (xlnt::row_t row = rows + 1; row <= rows + 3; ++row)
+            {
+                xlnt_assert_equals(actual.cell(column, row).value<double>(), expected.cell(column, row).value<double>());
+                xlnt_assert_equals(disabled.active_sheet().cell(column, row).value<double>(), expected.cell(column, row).value<double>());
+            }
+        }
+
+        const auto total = expected.cell(1, rows + 3).value<double>();
+        actual.cell(2, 1).value(1000);
+        concurrent.calculate();
+        xlnt_assert_equals(actual.cell(1, rows + 3).value<double>(), total + 2 * (1000 - 2) + 1000 - 96);
+
+        actual.cell(3, 1).error("#N/A");
+        concurrent.calculate();
+        xlnt_assert_equals(actual.cell(3, rows + 1).error(), "#N/A");
+        xlnt_assert_equals(actual.cell(1, rows + 3).error(), "#N/A");
+    }
+};
+
+static calculation_test_suite x;
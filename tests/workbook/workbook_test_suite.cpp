@@ -88,6 +88,8 @@ public:
         register_test(test_comparison);
         register_test(test_theme);
         register_test(test_id_gen);
+        register_test(test_shared_strings);
+        register_test(test_shared_strings_formatted);
         register_test(test_load_file);
         register_test(test_load_file_encrypted);
         register_test(test_load_file_encrypted_invalid_password);
@@ -100,7 +102,8 @@ public:
         register_test(test_style);
         register_test(test_builtin_style);
         register_test(test_thumbnail);
-        register_test(test_sheet_moving)
+        register_test(test_sheet_moving);
+        register_test(test_apply_to_cells);
     }
 
     void test_active_sheet()
@@ -795,6 +798,46 @@ public:
         xlnt_assert_differs(wb[1].id(), wb[2].id());
     }
 
+    void test_shared_strings()
+    {
+        xlnt::workbook wb;
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a"), true), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a"), true), 1);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("b")), 2);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("b")), 2);
+        xlnt_assert_equals(wb.shared_strings().size(), 3);
+        xlnt_assert_equals(wb.shared_strings(1).plain_text(), "a");
+
+        auto wb_copy = wb.clone(xlnt::workbook::clone_method::deep_copy);
+        xlnt_assert(wb_copy.compare(wb, false));
+        xlnt_assert_equals(wb_copy.add_shared_string(xlnt::rich_text("b")), 2);
+        xlnt_assert_equals(wb_copy.add_shared_string(xlnt::rich_text("c")), 3);
+        xlnt_assert(!wb_copy.compare(wb, false));
+    }
+
+    void test_shared_strings_formatted()
+    {
+        xlnt::workbook wb;
+        xlnt::rich_text formatted;
+        formatted.add_run(xlnt::rich_text_run{"a", xlnt::font().bold(true), false});
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 0);
+        xlnt_assert_equals(wb.add_shared_string(formatted), 1);
+        xlnt_assert_equals(wb.add_shared_string(formatted), 1);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 0);
+        xlnt_assert_equals(wb.shared_strings(0), xlnt::rich_text("a"));
+        xlnt_assert_equals(wb.shared_strings(1), formatted);
+
+        auto cell = wb.active_sheet().cell("A1");
+        cell.value(formatted);
+        xlnt_assert_equals(cell.value<xlnt::rich_text>(), formatted);
+        xlnt_assert_equals(cell.value<std::string>(), "a");
+
+        xlnt_assert_equals(wb.shared_strings().size(), 2);
+        xlnt_assert_equals(wb.add_shared_string(formatted), 1);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("b")), 2);
+    }
+
     void test_load_file()
     {
         xlnt::path file = path_helper::test_file("2_minimal.xlsx");
@@ -1121,5 +1164,32 @@ public:
         auto exterbalSheet = externalWorkbook.sheet_by_index(0);
         xlnt_assert_throws(testWorkbook.move_sheet(exterbalSheet, newIndex), xlnt::invalid_parameter);
     }
+
+    void test_apply_to_cells()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1);
+        ws.cell("A2").value(2);
+        ws.cell("A3").value(3);
+
+        // the function may create and clear cells while the workbook is being visited
+        std::size_t visited = 0;
+        wb.apply_to_cells([&visited](xlnt::cell c) {
+            ++visited;
+            auto sheet = c.worksheet();
+            sheet.cell(c.column(), c.row() + 10).value(c.value<int>());
+            if (c.row() == 1)
+            {
+                sheet.clear_cell("A2");
+            }
+        });
+
+        xlnt_assert_equals(visited, 2);
+        xlnt_assert(!ws.has_cell("A2"));
+        xlnt_assert_equals(ws.cell("A11").value<int>(), 1);
+        xlnt_assert_equals(ws.cell("A13").value<int>(), 3);
+        xlnt_assert(!ws.has_cell("A12"));
+    }
 };
 static workbook_test_suite x;
@@ -98,6 +98,8 @@ public:
         register_test(test_get_point_pos);
         register_test(test_named_range_named_cell_reference);
         register_test(test_iteration_skip_empty);
+        register_test(test_iteration_sparse);
+        register_test(test_for_each_cell);
         register_test(test_dimensions);
         register_test(test_view_properties_serialization);
         register_test(test_clear_cell);
@@ -1302,6 +1304,91 @@ public:
         }
     }
 
+    void test_iteration_sparse()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("B2").value(1);
+        ws.cell("XFD2").value(2);
+        ws.cell("C1048576").value(3);
+
+        std::vector<std::string> visited;
+
+        for (auto row : ws.rows())
+        {
+            for (auto cell : row)
+            {
+                visited.push_back(cell.reference().to_string());
+            }
+        }
+
+        xlnt_assert_equals(visited.size(), 3);
+        xlnt_assert_equals(visited[0], "B2");
+        xlnt_assert_equals(visited[1], "XFD2");
+        xlnt_assert_equals(visited[2], "C1048576");
+
+        visited.clear();
+
+        for (auto column : ws.columns())
+        {
+            for (auto cell : column)
+            {
+                visited.push_back(cell.reference().to_string());
+            }
+        }
+
+        xlnt_assert_equals(visited.size(), 3);
+        xlnt_assert_equals(visited[0], "B2");
+        xlnt_assert_equals(visited[1], "C1048576");
+        xlnt_assert_equals(visited[2], "XFD2");
+
+        // iterating backwards skips the empty cells in the same way
+        visited.clear();
+        const auto first_row = ws.rows().front();
+        for (auto cell = first_row.rbegin(); cell != first_row.rend(); ++cell)
+        {
+            visited.push_back((*cell).reference().to_string());
+        }
+
+        const auto second_column = ws.columns()[1];
+        for (auto cell = second_column.rbegin(); cell != second_column.rend(); ++cell)
+        {
+            visited.push_back((*cell).reference().to_string());
+        }
+
+        xlnt_assert_equals(visited, std::vector<std::string>({"XFD2", "B2", "C1048576"}));
+
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("B2:XFD1048576"));
+    }
+
+    void test_for_each_cell()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("C1").value(1);
+        ws.cell("A1").value(2);
+        ws.cell("B7").value(3);
+        ws.cell("A300").value(4);
+
+        std::string trace;
+        auto on_cell = [&trace](xlnt::cell c) { trace += c.reference().to_string() + " "; };
+        auto on_start = [&trace](std::uint32_t line) { trace += "(" + std::to_string(line) + " "; };
+        auto on_end = [&trace](std::uint32_t line) { trace += std::to_string(line) + ") "; };
+
+        ws.for_each_cell(xlnt::major_order::row, on_cell, on_start, on_end);
+        xlnt_assert_equals(trace, "(1 A1 C1 1) (7 B7 7) (300 A300 300) ");
+
+        trace.clear();
+        const auto ws_const = ws;
+        ws_const.for_each_cell(xlnt::major_order::column,
+            [&trace](const xlnt::cell &c) { trace += c.reference().to_string() + " "; }, on_start, on_end);
+        xlnt_assert_equals(trace, "(1 A1 A300 1) (2 B7 2) (3 C1 3) ");
+
+        trace.clear();
+        ws.for_each_cell(xlnt::major_order::row, on_cell);
+        xlnt_assert_equals(trace, "A1 C1 B7 A300 ");
+    }
+
     void test_dimensions()
     {
         xlnt::workbook workbook;